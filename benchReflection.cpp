@@ -0,0 +1,405 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+// SPPReflectionBench : micro benchmarks of the reflection paths against the same work in plain C++.
+// Usage: SPPReflectionBench [output.json]  (defaults to SPPReflectionBench.json)
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <unordered_map>
+
+#include "SPPReflection.h"
+
+using namespace SPP;
+
+LogEntry LOG_BENCH("BENCH");
+
+enum class EBenchState
+{
+    Idle,
+    Running,
+    Jumping,
+    Falling
+};
+
+struct BenchFlat
+{
+    float X = 1.0f;
+    float Y = 2.0f;
+    float Z = 3.0f;
+    int32_t ID = 4;
+};
+
+struct BenchNested
+{
+    BenchFlat A;
+    BenchFlat B;
+    int32_t Count = 0;
+    std::vector< int32_t > Values;
+};
+
+struct BenchAccess
+{
+private:
+    float data[2] = { 1.0f, 2.0f };
+
+public:
+    float* XGet()
+    {
+        return &data[0];
+    }
+};
+
+struct BenchActor
+{
+    float Health = 100.0f;
+
+    BenchActor() {}
+    BenchActor(float InHealth) : Health(InHealth) {}
+
+    float Damage(float InAmount, int32_t InTimes)
+    {
+        Health -= InAmount * (float)InTimes;
+        return Health;
+    }
+};
+
+SPP_AUTOREG_START
+
+    REFL_ENUM_START(EBenchState)
+        RC_ENUM_VALUE(EBenchState::Idle, "Idle")
+        RC_ENUM_VALUE(EBenchState::Running, "Running")
+        RC_ENUM_VALUE(EBenchState::Jumping, "Jumping")
+        RC_ENUM_VALUE(EBenchState::Falling, "Falling")
+    REFL_ENUM_END
+
+    REFL_CLASS_START(BenchFlat)
+        RC_ADD_PROP(X)
+        RC_ADD_PROP(Y)
+        RC_ADD_PROP(Z)
+        RC_ADD_PROP(ID)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(BenchNested)
+        RC_ADD_PROP(A)
+        RC_ADD_PROP(B)
+        RC_ADD_PROP(Count)
+        RC_ADD_PROP(Values)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(BenchAccess)
+        RC_ADD_PROP_ACCESS("X", XGet)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(BenchActor)
+        RC_ADD_PROP(Health)
+        RC_ADD_METHOD(Damage)
+        RC_ADD_CONSTRUCTOR(float)
+        RC_ADD_CONSTRUCTOR()
+    REFL_CLASS_END
+
+SPP_AUTOREG_END
+
+////////////////////////////////////////////
+//
+// HARNESS
+//
+////////////////////////////////////////////
+
+// results go through here so the optimizer can't drop the work
+static volatile uint64_t GBenchSink = 0;
+
+template<typename T>
+inline void Consume(const T& InValue)
+{
+    if constexpr (std::is_pointer_v<T>)
+    {
+        GBenchSink = (uint64_t)(uintptr_t)InValue;
+    }
+    else
+    {
+        GBenchSink = (uint64_t)InValue;
+    }
+}
+
+struct BenchResult
+{
+    std::string Name;
+    size_t Iterations = 0;
+    double ReflectedNs = 0;
+    double BaselineNs = 0;
+};
+
+// best of a few runs, in ns per iteration
+static constexpr int32_t BenchRuns = 5;
+
+template<typename Func>
+double MeasureNs(size_t InIterations, Func&& InFunc)
+{
+    // warm up caches and any lazy statics
+    for (size_t Iter = 0; Iter < std::min< size_t >(InIterations, 1000); Iter++)
+    {
+        InFunc();
+    }
+
+    double bestNs = std::numeric_limits<double>::max();
+    for (int32_t Run = 0; Run < BenchRuns; Run++)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        for (size_t Iter = 0; Iter < InIterations; Iter++)
+        {
+            InFunc();
+        }
+        auto elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+        bestNs = std::min(bestNs, elapsedNs / (double)InIterations);
+    }
+    return bestNs;
+}
+
+template<typename ReflectedFunc, typename BaselineFunc>
+void RunBench(std::vector< BenchResult >& InOutResults, const char* InName, size_t InIterations, ReflectedFunc&& InReflected, BaselineFunc&& InBaseline)
+{
+    BenchResult newResult;
+    newResult.Name = InName;
+    newResult.Iterations = InIterations;
+    newResult.ReflectedNs = MeasureNs(InIterations, InReflected);
+    newResult.BaselineNs = MeasureNs(InIterations, InBaseline);
+
+    SPP_LOG(LOG_BENCH, LOG_INFO, "%-28s reflected %10.2f ns   baseline %10.2f ns   x%.2f",
+        InName, newResult.ReflectedNs, newResult.BaselineNs, newResult.ReflectedNs / std::max(newResult.BaselineNs, 0.001));
+
+    InOutResults.push_back(newResult);
+}
+
+static bool WriteJson(const std::string& InPath, const std::vector< BenchResult >& InResults)
+{
+    std::ofstream outFile(InPath);
+    if (!outFile)
+    {
+        return false;
+    }
+
+    outFile << "{\n";
+    outFile << "  \"suite\": \"SPPReflectionBench\",\n";
+#ifdef NDEBUG
+    outFile << "  \"build\": \"release\",\n";
+#else
+    outFile << "  \"build\": \"debug\",\n";
+#endif
+    outFile << "  \"runs\": " << BenchRuns << ",\n";
+    outFile << "  \"results\": [\n";
+    for (size_t Iter = 0; Iter < InResults.size(); Iter++)
+    {
+        const auto& curResult = InResults[Iter];
+        outFile << "    { \"name\": \"" << curResult.Name << "\""
+            << ", \"iterations\": " << curResult.Iterations
+            << ", \"reflected_ns\": " << curResult.ReflectedNs
+            << ", \"baseline_ns\": " << curResult.BaselineNs
+            << ", \"ratio\": " << curResult.ReflectedNs / std::max(curResult.BaselineNs, 0.001)
+            << " }" << (Iter + 1 < InResults.size() ? ",\n" : "\n");
+    }
+    outFile << "  ]\n";
+    outFile << "}\n";
+    return true;
+}
+
+////////////////////////////////////////////
+//
+// VISITORS
+//
+////////////////////////////////////////////
+
+struct BenchSumVisitor : public IVisitor
+{
+    double Sum = 0;
+    virtual void VisitValue(const ReflectedProperty&, float& InValue) override { Sum += InValue; }
+    virtual void VisitValue(const ReflectedProperty&, int32_t& InValue) override { Sum += InValue; }
+};
+
+struct BenchStaticSumVisitor
+{
+    double Sum = 0;
+    void VisitValue(const ReflectedProperty&, float& InValue) { Sum += InValue; }
+    void VisitValue(const ReflectedProperty&, int32_t& InValue) { Sum += InValue; }
+};
+
+inline double SumFlatByHand(const BenchFlat& InFlat)
+{
+    return (double)InFlat.X + InFlat.Y + InFlat.Z + InFlat.ID;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string outputPath = argc > 1 ? argv[1] : "SPPReflectionBench.json";
+    std::vector< BenchResult > results;
+
+    constexpr size_t CallIterations = 1000000;
+    constexpr size_t VisitIterations = 200000;
+    constexpr size_t ArrayIterations = 20000;
+
+    // TYPES
+    RunBench(results, "get_type", CallIterations,
+        []() { Consume(get_type<BenchFlat>().GetTypeData()); },
+        []() { Consume(&typeid(BenchFlat)); });
+
+    {
+        std::unordered_map< std::string, const void* > nameLookup;
+        GetTypeCollection().IterateTypes([&nameLookup](const type_data* InType)
+        {
+            nameLookup[std::string(InType->GetName().c_str())] = InType;
+        });
+        const std::string lookupName(get_type<BenchNested>()->GetName().c_str());
+
+        RunBench(results, "get_type_by_name", CallIterations / 10,
+            [&]() { Consume(get_type_by_name(lookupName.c_str()).GetTypeData()); },
+            [&]() { Consume(nameLookup.find(lookupName)->second); });
+    }
+
+    // PROPERTY ACCESS
+    {
+        BenchFlat flat;
+        auto idProp = get_type<BenchFlat>()->structureRef->FindProperty("ID");
+        RunBench(results, "property_offset_access", CallIterations,
+            [&]() { Consume(*(int32_t*)idProp->AccessValueAddress(&flat)); },
+            [&]() { Consume(flat.ID); });
+
+        BenchAccess access;
+        auto xProp = get_type<BenchAccess>()->structureRef->FindProperty("X");
+        RunBench(results, "property_accessor_access", CallIterations,
+            [&]() { Consume(*(float*)xProp->AccessValueAddress(&access)); },
+            [&]() { Consume(*access.XGet()); });
+    }
+
+    // VISIT
+    {
+        BenchFlat flat;
+        auto flatStruct = get_type<BenchFlat>()->structureRef.get();
+        RunBench(results, "visit_flat", VisitIterations,
+            [&]() { BenchSumVisitor sumVisitor; flatStruct->Visit(&flat, &sumVisitor); Consume(sumVisitor.Sum); },
+            [&]() { Consume(SumFlatByHand(flat)); });
+        RunBench(results, "visit_flat_static", VisitIterations,
+            [&]() { BenchStaticSumVisitor sumVisitor; flatStruct->Visit(&flat, sumVisitor); Consume(sumVisitor.Sum); },
+            [&]() { Consume(SumFlatByHand(flat)); });
+
+        BenchNested nested;
+        nested.Values.resize(16, 2);
+        auto nestedStruct = get_type<BenchNested>()->structureRef.get();
+        auto sumNestedByHand = [&]()
+        {
+            double handSum = SumFlatByHand(nested.A) + SumFlatByHand(nested.B) + nested.Count;
+            for (auto curValue : nested.Values)
+            {
+                handSum += curValue;
+            }
+            return handSum;
+        };
+        RunBench(results, "visit_nested", VisitIterations,
+            [&]() { BenchSumVisitor sumVisitor; nestedStruct->Visit(&nested, &sumVisitor); Consume(sumVisitor.Sum); },
+            [&]() { Consume(sumNestedByHand()); });
+        RunBench(results, "visit_nested_static", VisitIterations,
+            [&]() { BenchStaticSumVisitor sumVisitor; nestedStruct->Visit(&nested, sumVisitor); Consume(sumVisitor.Sum); },
+            [&]() { Consume(sumNestedByHand()); });
+    }
+
+    // ARRAYS
+    {
+        BenchNested nested;
+        nested.Values.resize(1024, 3);
+        auto valuesProp = get_type<BenchNested>()->structureRef->FindProperty("Values");
+        auto arrayManipulator = valuesProp->GetCPPType()->arrayManipulator.get();
+
+        RunBench(results, "dynamic_array_iterate_1024", ArrayIterations,
+            [&]()
+            {
+                auto arrayAddr = valuesProp->AccessValueAddress(&nested);
+                int64_t arraySum = 0;
+                const size_t totalSize = arrayManipulator->Size(arrayAddr);
+                for (size_t Iter = 0; Iter < totalSize; Iter++)
+                {
+                    arraySum += *(int32_t*)arrayManipulator->Element(arrayAddr, (int32_t)Iter);
+                }
+                Consume(arraySum);
+            },
+            [&]()
+            {
+                int64_t arraySum = 0;
+                for (auto curValue : nested.Values)
+                {
+                    arraySum += curValue;
+                }
+                Consume(arraySum);
+            });
+    }
+
+    // INVOKE
+    {
+        BenchActor actor;
+        auto actorStruct = get_type<BenchActor>()->structureRef.get();
+        const std::string methodName("Damage");
+        float damageAmount = 0.001f;
+        int32_t damageTimes = 2;
+
+        RunBench(results, "invoke", CallIterations / 10,
+            [&]() { Consume(actorStruct->Invoke<float>(&actor, methodName, damageAmount, damageTimes)); },
+            [&]() { Consume(actor.Damage(damageAmount, damageTimes)); });
+
+        float startHealth = 50.0f;
+        RunBench(results, "invoke_constructor", CallIterations / 10,
+            [&]()
+            {
+                auto newActor = actorStruct->Invoke_Constructor<BenchActor*>(startHealth);
+                Consume(newActor->Health);
+                delete newActor;
+            },
+            [&]()
+            {
+                auto newActor = new BenchActor(startHealth);
+                Consume(newActor->Health);
+                delete newActor;
+            });
+    }
+
+    // ENUMS
+    {
+        auto enumCollection = get_type<EBenchState>()->enumCollection.get();
+        int32_t lookupValue = (int32_t)EBenchState::Falling;
+
+        RunBench(results, "enum_value_to_name", CallIterations,
+            [&]()
+            {
+                for (const auto& curValue : enumCollection->EnumValues)
+                {
+                    if (std::get<1>(curValue) == lookupValue)
+                    {
+                        Consume(std::get<0>(curValue).size());
+                        break;
+                    }
+                }
+            },
+            [&]()
+            {
+                const char* enumName = "";
+                switch ((EBenchState)lookupValue)
+                {
+                case EBenchState::Idle: enumName = "Idle"; break;
+                case EBenchState::Running: enumName = "Running"; break;
+                case EBenchState::Jumping: enumName = "Jumping"; break;
+                case EBenchState::Falling: enumName = "Falling"; break;
+                }
+                Consume(enumName);
+            });
+    }
+
+    if (!WriteJson(outputPath, results))
+    {
+        SPP_LOG(LOG_BENCH, LOG_INFO, "failed to write %s", outputPath.c_str());
+        return 1;
+    }
+
+    SPP_LOG(LOG_BENCH, LOG_INFO, "wrote %zd results to %s", results.size(), outputPath.c_str());
+    return 0;
+}
@@ -45,7 +45,8 @@ namespace SPP_CAT(spp_auto_reg_namespace_, __LINE__)								\
 	ClassName& operator=(ClassName&&) = delete;	
 
 
-#define SE_CRASH_BREAK *reinterpret_cast<int32_t*>(3) = 0xDEAD;
+// the address goes through a volatile so the compiler can't prove the write is out of bounds and warn on it
+#define SE_CRASH_BREAK { int32_t* volatile crashAddr = reinterpret_cast<int32_t*>(3); *crashAddr = 0xDEAD; }
 #define SE_ASSERT(x) { if(!(x)) { SE_CRASH_BREAK; } } 
 #define SPP_LOG(cat,level,S, ...) printf(S, ##__VA_ARGS__); printf("\r\n")
 
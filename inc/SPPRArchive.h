@@ -0,0 +1,198 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include "SPPReflection.h"
+
+// float range written as a Bits wide integer in compact archives, RC_PROP_QUANTIZE(0, 100, 12)
+#define RC_PROP_QUANTIZE(InMin, InMax, InBits) \
+    .attribute( "QuantizeMin", (double)(InMin) ).attribute( "QuantizeMax", (double)(InMax) ).attribute( "QuantizeBits", (int64_t)(InBits) )
+
+namespace SPP
+{
+    enum class EArchiveEncoding : uint8_t
+    {
+        // values as they are in memory, arrays of trivially copyable elements in one copy
+        Plain,
+        // LEB128 varints, zigzag for signed integers, integer arrays delta coded, floats quantized where the
+        // property declares a range (RC_PROP_QUANTIZE)
+        Compact
+    };
+
+    inline uint64_t ZigZagEncode(int64_t InValue)
+    {
+        return ((uint64_t)InValue << 1) ^ (uint64_t)(InValue >> 63);
+    }
+
+    inline int64_t ZigZagDecode(uint64_t InValue)
+    {
+        return (int64_t)(InValue >> 1) ^ -(int64_t)(InValue & 1);
+    }
+
+    // Reflected objects to bytes. Properties are written in IterateProperties order with no names or tags, so
+    // the reader must have the same registration. Raw pointers aren't written, shared_ptr targets are written
+    // by value, map keys as MapManipulator::EncodeKey bytes (trivially copyable or string keys only).
+    class SPP_REFLECTION_API BinaryArchiveWriter
+    {
+    protected:
+        std::vector< uint8_t > _data;
+        EArchiveEncoding _encoding = EArchiveEncoding::Plain;
+
+    public:
+        BinaryArchiveWriter(EArchiveEncoding InEncoding = EArchiveEncoding::Plain) : _encoding(InEncoding) {}
+
+        void Write(const void* InData, size_t InSize)
+        {
+            _data.insert(_data.end(), (const uint8_t*)InData, (const uint8_t*)InData + InSize);
+        }
+
+        template<typename T>
+        void Write(const T& InValue)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            Write(&InValue, sizeof(T));
+        }
+
+        void WriteVarint(uint64_t InValue)
+        {
+            uint8_t encoded[10];
+            size_t encodedSize = 0;
+            while (InValue >= 0x80)
+            {
+                encoded[encodedSize++] = (uint8_t)(InValue | 0x80);
+                InValue >>= 7;
+            }
+            encoded[encodedSize++] = (uint8_t)InValue;
+            Write(encoded, encodedSize);
+        }
+
+        void WriteZigZag(int64_t InValue)
+        {
+            WriteVarint(ZigZagEncode(InValue));
+        }
+
+        // header (magic and encoding) then the object
+        void Save(const ReflectedStruct* InStruct, const void* InObject);
+
+        template<typename T>
+        void Save(const T& InObject)
+        {
+            Save(get_type<T>()->structureRef.get(), &InObject);
+        }
+
+        EArchiveEncoding GetEncoding() const { return _encoding; }
+        const std::vector< uint8_t >& GetData() const { return _data; }
+        void Reset() { _data.clear(); }
+    };
+
+    // the most a reader ever asks Fetch for
+    static constexpr size_t ArchiveFetchMax = 16;
+
+    // Reads what BinaryArchiveWriter wrote, the encoding comes from the header. Any short or malformed read
+    // fails the reader and everything after it. Reads work on the window [_cur, _end), a streaming reader
+    // refills it through Fetch when a read runs off the end.
+    class SPP_REFLECTION_API BinaryArchiveReader
+    {
+    protected:
+        const uint8_t* _cur = nullptr;
+        const uint8_t* _end = nullptr;
+        // most bytes that can still come after the window, counts in the archive are checked against it
+        uint64_t _pendingBytes = 0;
+        EArchiveEncoding _encoding = EArchiveEncoding::Plain;
+        bool _bFailed = false;
+
+        BinaryArchiveReader() {}
+
+        bool Fail()
+        {
+            _bFailed = true;
+            _cur = _end;
+            return false;
+        }
+
+        // make at least InWanted (up to ArchiveFetchMax) bytes available if the data has them, keeping the unread
+        // ones, true if anything was added
+        virtual bool Fetch(size_t) { return false; }
+
+        bool ReadSlow(void* OutData, size_t InSize);
+
+    public:
+        BinaryArchiveReader(const void* InData, size_t InSize) : _cur((const uint8_t*)InData), _end((const uint8_t*)InData + InSize) {}
+        BinaryArchiveReader(const std::vector< uint8_t >& InData) : BinaryArchiveReader(InData.data(), InData.size()) {}
+        virtual ~BinaryArchiveReader() {}
+
+        bool Read(void* OutData, size_t InSize)
+        {
+            if ((size_t)(_end - _cur) < InSize)
+            {
+                return ReadSlow(OutData, InSize);
+            }
+            std::memcpy(OutData, _cur, InSize);
+            _cur += InSize;
+            return true;
+        }
+
+        template<typename T>
+        bool Read(T& OutValue)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return Read(&OutValue, sizeof(T));
+        }
+
+        bool ReadVarint(uint64_t& OutValue)
+        {
+            if (_end - _cur < 10 && !_bFailed)
+            {
+                Fetch(10);
+            }
+
+            uint64_t oValue = 0;
+            for (uint32_t shift = 0; shift < 64 && _cur < _end; shift += 7)
+            {
+                const uint8_t curByte = *_cur++;
+                // the 10th byte only has bit 63 left to give
+                if (shift == 63 && curByte > 1)
+                {
+                    return Fail();
+                }
+                oValue |= (uint64_t)(curByte & 0x7F) << shift;
+                if (!(curByte & 0x80))
+                {
+                    OutValue = oValue;
+                    return true;
+                }
+            }
+            return Fail();
+        }
+
+        bool ReadZigZag(int64_t& OutValue)
+        {
+            uint64_t encoded = 0;
+            if (!ReadVarint(encoded))
+            {
+                return false;
+            }
+            OutValue = ZigZagDecode(encoded);
+            return true;
+        }
+
+        // InCount varints, runs of single byte values are taken 16 (SSE2) or 8 at a time
+        bool ReadVarints(uint64_t* OutValues, size_t InCount);
+
+        // header then the object
+        bool Load(const ReflectedStruct* InStruct, void* InObject);
+
+        template<typename T>
+        bool Load(T& InObject)
+        {
+            return Load(get_type<T>()->structureRef.get(), &InObject);
+        }
+
+        EArchiveEncoding GetEncoding() const { return _encoding; }
+        bool HasFailed() const { return _bFailed; }
+        // upper bound for a stream
+        uint64_t GetRemaining() const { return (uint64_t)(_end - _cur) + _pendingBytes; }
+    };
+}
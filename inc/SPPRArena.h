@@ -0,0 +1,103 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <string_view>
+#include <vector>
+
+// Reflection metadata (type_data, properties, methods, structs, manipulators) lives in one bump allocated 
+// arena for the life of the process. Objects built at registration sit back to back, so a struct's 
+// properties end up contiguous, and deletes are no-ops.
+#define SPP_METADATA_ALLOCATED                                                      \
+    public:                                                                         \
+    static void* operator new(std::size_t InSize)                                   \
+    {                                                                               \
+        return ::SPP::MetadataAllocate(InSize, __STDCPP_DEFAULT_NEW_ALIGNMENT__);   \
+    }                                                                               \
+    static void operator delete(void*) {}
+
+namespace SPP
+{
+    struct type_data;
+
+    SPP_REFLECTION_API void* MetadataAllocate(size_t InSize, size_t InAlignment);
+
+    // containers inside metadata (property lists, plans, attributes) keep their storage in the arena too,
+    // freeing is a no-op like the objects themselves
+    template<typename T>
+    struct MetadataAllocator
+    {
+        using value_type = T;
+
+        MetadataAllocator() noexcept {}
+        template<typename U>
+        MetadataAllocator(const MetadataAllocator<U>&) noexcept {}
+
+        T* allocate(std::size_t InCount)
+        {
+            return (T*)MetadataAllocate(InCount * sizeof(T), alignof(T));
+        }
+        void deallocate(T*, std::size_t) noexcept {}
+
+        template<typename U>
+        bool operator==(const MetadataAllocator<U>&) const noexcept { return true; }
+    };
+
+    template<typename T>
+    using MetadataVector = std::vector< T, MetadataAllocator<T> >;
+
+    // name stored once in the metadata arena, equal names share a pointer so comparing two is a pointer compare
+    class SPP_REFLECTION_API InternedName
+    {
+    private:
+        const char* _str = nullptr;
+        uint32_t _size = 0;
+
+    public:
+        InternedName() {}
+        explicit InternedName(std::string_view InValue);
+
+        const char* c_str() const { return _str ? _str : ""; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        std::string_view view() const { return std::string_view(c_str(), _size); }
+        operator std::string_view() const { return view(); }
+
+        bool operator==(const InternedName& InValue) const { return _str == InValue._str; }
+        bool operator==(std::string_view InValue) const { return view() == InValue; }
+    };
+
+    // bytes allocated while in scope are reported against InType
+    class SPP_REFLECTION_API MetadataScope
+    {
+    private:
+        const type_data* _previous = nullptr;
+
+    public:
+        MetadataScope(const type_data* InType);
+        ~MetadataScope();
+
+        MetadataScope(const MetadataScope&) = delete;
+        MetadataScope& operator=(const MetadataScope&) = delete;
+    };
+
+    struct MetadataArenaStats
+    {
+        size_t BytesUsed = 0;
+        size_t BytesReserved = 0;
+        size_t BlockCount = 0;
+        size_t InternedNames = 0;
+    };
+
+    SPP_REFLECTION_API MetadataArenaStats GetMetadataArenaStats();
+    // type_data, names, and everything allocated while building the type (its struct, properties, methods)
+    SPP_REFLECTION_API size_t GetMetadataBytes(const type_data* InType);
+    SPP_REFLECTION_API void AddMetadataBytes(const type_data* InType, size_t InBytes);
+    // per type bytes plus arena totals
+    SPP_REFLECTION_API void LogMetadataReport();
+}
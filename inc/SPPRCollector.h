@@ -0,0 +1,132 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include "SPPReflection.h"
+#include "SPPRGraph.h"
+#include "SPPRParallel.h"
+
+namespace SPP
+{
+    struct CollectorSettings
+    {
+        // objects per mark task before half of its stack is handed to another worker
+        size_t MarkSplitSize = 512;
+        // null uses WorkStealingPool::Get()
+        WorkStealingPool* Pool = nullptr;
+    };
+
+    struct CollectorStats
+    {
+        size_t LiveObjects = 0;
+        size_t PoolCount = 0;
+        size_t BlockCount = 0;
+        size_t BlockBytes = 0;
+        // last Mark, it is the whole pause since sweeping is incremental, for an incremental mark the sum of its steps
+        double LastMarkMilliseconds = 0;
+        // longest single MarkStep of the last incremental mark
+        double LastMarkStepMilliseconds = 0;
+        size_t LastMarkSteps = 0;
+        size_t LastMarked = 0;
+        size_t LastFreed = 0;
+    };
+
+    // Opt-in tracing collector for reflected objects it allocated. Objects come from per type pools (64KB
+    // aligned blocks, objects up to 16KB) so any pointer, including one into the middle of an object, can be 
+    // mapped to its managed object with a mask, a lookup and a division. Mark follows each type's precomputed pointer offsets (GetReferenceSlots, parents and
+    // inline structs flattened) with no virtual visit per field, wrapper, variant and array slots go through their
+    // manipulators. Pointers to objects the collector doesn't own aren't followed.
+    //
+    // New, roots and the objects themselves belong to one thread, Mark runs on the pool with that thread
+    // stopped. Sweep is incremental: objects allocated ahead of the sweep are born marked. Marking can be
+    // incremental too (BeginMark, MarkStep), objects allocated during it are born marked, pointers stored into
+    // managed objects between steps must be passed to WriteBarrier and roots are rescanned before it finishes.
+    class SPP_REFLECTION_API ReflectedCollector
+    {
+        NO_COPY_ALLOWED(ReflectedCollector);
+
+    public:
+        struct Pool;
+
+    protected:
+        struct Impl;
+        std::unique_ptr<Impl> _impl;
+
+        Pool* GetPool(CPPType InType, size_t InSize, size_t InAlignment, void(*InDestroy)(void*));
+        void* Allocate(Pool* InPool);
+        // gives back a slot whose constructor didn't finish, no destructor runs
+        void Release(Pool* InPool, void* InSlot);
+
+        struct SlotGuard
+        {
+            ReflectedCollector* Collector = nullptr;
+            Pool* SlotPool = nullptr;
+            void* Slot = nullptr;
+
+            ~SlotGuard()
+            {
+                if (Slot)
+                {
+                    Collector->Release(SlotPool, Slot);
+                }
+            }
+        };
+
+        template<typename T>
+        static void DestroyObject(void* InObject)
+        {
+            ((T*)InObject)->~T();
+        }
+
+    public:
+        ReflectedCollector(const CollectorSettings& InSettings = {});
+        // destroys everything still alive
+        ~ReflectedCollector();
+
+        template<typename T, typename ...Args>
+        T* New(Args&& ...args)
+        {
+            static_assert(sizeof(T) <= 16 * 1024, "collector pools hold objects up to 16KB");
+            auto typePool = GetPool(get_type<T>(), sizeof(T), alignof(T), &DestroyObject<T>);
+            // the slot is live once allocated, a throwing constructor must not leave it for the sweep to destroy
+            SlotGuard slotGuard{ this, typePool, Allocate(typePool) };
+            auto oObject = new (slotGuard.Slot) T(std::forward<Args>(args)...);
+            slotGuard.Slot = nullptr;
+            return oObject;
+        }
+
+        // a root is scanned every Mark, managed or not (a stack or global object holding pointers)
+        void AddRoot(void* InObject, const ReflectedStruct* InStruct);
+        void RemoveRoot(void* InObject);
+
+        template<typename T>
+        void AddRoot(T* InObject)
+        {
+            AddRoot(InObject, get_type<T>()->structureRef.get());
+        }
+
+        // true for any address inside a live managed object
+        bool IsManaged(const void* InObject) const;
+
+        // marks everything reachable from the roots on the work pool, must not be sweeping or marking
+        void Mark();
+
+        // incremental mark on the calling thread, must not be sweeping or marking
+        void BeginMark();
+        // scans for about InMaxMilliseconds, true when marking is done and the sweep can start
+        bool MarkStep(double InMaxMilliseconds = 0.5);
+        bool IsMarking() const;
+        // call with the new pointee after storing a pointer into a managed object while IsMarking
+        void WriteBarrier(void* InPointee);
+
+        // checks about InMaxObjects slots, destroying the unreachable ones and returning them to their pools, true when done
+        bool SweepStep(size_t InMaxObjects = 4096);
+        bool IsSweeping() const;
+        // Mark and the whole sweep
+        void Collect();
+
+        CollectorStats GetStats() const;
+    };
+}
@@ -10,14 +10,21 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <cstring>
+#include <algorithm>
+#include "SPPRTypeTraits.h"
+#include "SPPRArena.h"
 
 namespace SPP
 {
 
     struct ArrayManipulator
     {
+        SPP_METADATA_ALLOCATED
+
         virtual void* Element(void* ArrayPtr, int32_t Idx) = 0;
         virtual size_t Size(void* ArrayPtr) = 0;
+        virtual size_t Capacity(void* ArrayPtr) = 0;
         virtual void Resize(void* ArrayPtr, size_t NewSize) = 0;
     };
 
@@ -36,42 +43,542 @@ namespace SPP
         {
             return AsType(ArrayPtr).size();
         }
+        virtual size_t Capacity(void* ArrayPtr) override
+        {
+            return AsType(ArrayPtr).capacity();
+        }
         virtual void Resize(void* ArrayPtr, size_t NewSize) override
         {
             AsType(ArrayPtr).resize(NewSize);
         }
     };
 
+    // one entry of an associative container, Value is null for sets
+    struct MapEntry
+    {
+        const void* Key = nullptr;
+        void* Value = nullptr;
+    };
+
+    struct MapManipulator
+    {
+        SPP_METADATA_ALLOCATED
+
+        // no mapped value, the entries are the keys
+        bool bIsSet = false;
+        // iterates sorted by key already (std::map, std::set)
+        bool bOrdered = false;
+        // EncodeKey works for the key type, required for Diff
+        bool bEncodableKeys = false;
+
+        virtual size_t Size(void* MapPtr) = 0;
+        virtual void Clear(void* MapPtr) = 0;
+        // ahead of a bulk insert, rehashes hashed containers once instead of growing step by step
+        virtual void Reserve(void* MapPtr, size_t Count) = 0;
+        // appended in container order
+        virtual void GetEntries(void* MapPtr, std::vector< MapEntry >& OutEntries) = 0;
+        // sorts entries of this container by key, false when the key type has no ordering
+        virtual bool SortEntries(std::vector< MapEntry >& InOutEntries) = 0;
+        // mapped value (the key for sets), null if missing
+        virtual void* Find(void* MapPtr, const void* KeyPtr) = 0;
+        // adds a default entry if missing, returns the mapped value (the key for sets)
+        virtual void* FindOrAdd(void* MapPtr, const void* KeyPtr) = 0;
+        virtual bool Erase(void* MapPtr, const void* KeyPtr) = 0;
+        // node and bucket memory, approximate since node layouts aren't visible
+        virtual void MeasureHeap(void* MapPtr, size_t& OutBytes, size_t& OutAllocations) = 0;
+
+        // keys as bytes for patches: raw bytes of trivially copyable keys, characters of strings, false otherwise
+        virtual bool EncodeKey(const void* KeyPtr, std::vector< uint8_t >& OutBytes) = 0;
+        // rebuilds a key from EncodeKey bytes and hands it to InFunc
+        virtual bool DecodeKey(const uint8_t* InBytes, size_t InSize, const std::function< void(const void*) >& InFunc) = 0;
+        virtual std::string KeyToString(const uint8_t* InBytes, size_t InSize) = 0;
+    };
+
+    template<typename T>
+    struct TMapManipulator : public MapManipulator
+    {
+        using key_type = typename T::key_type;
+        static constexpr bool bSetType = std::is_same_v< typename T::key_type, typename T::value_type >;
+
+        TMapManipulator()
+        {
+            bIsSet = bSetType;
+            bOrdered = requires { typename T::key_compare; };
+            bEncodableKeys = std::is_same_v< key_type, std::string > || std::is_trivially_copyable_v< key_type >;
+        }
+
+        auto& AsType(void* MapPtr)
+        {
+            return *(T*)MapPtr;
+        }
+        virtual size_t Size(void* MapPtr) override
+        {
+            return AsType(MapPtr).size();
+        }
+        virtual void Clear(void* MapPtr) override
+        {
+            AsType(MapPtr).clear();
+        }
+        virtual void Reserve(void* MapPtr, size_t Count) override
+        {
+            if constexpr (requires(T& InMap) { InMap.reserve(Count); })
+            {
+                AsType(MapPtr).reserve(Count);
+            }
+        }
+        virtual void GetEntries(void* MapPtr, std::vector< MapEntry >& OutEntries) override
+        {
+            auto& mapValue = AsType(MapPtr);
+            OutEntries.reserve(OutEntries.size() + mapValue.size());
+            for (auto& curEntry : mapValue)
+            {
+                if constexpr (bSetType)
+                {
+                    OutEntries.push_back({ &curEntry, nullptr });
+                }
+                else
+                {
+                    OutEntries.push_back({ &curEntry.first, &curEntry.second });
+                }
+            }
+        }
+        virtual bool SortEntries(std::vector< MapEntry >& InOutEntries) override
+        {
+            if constexpr (requires(const key_type& InA, const key_type& InB) { { InA < InB } -> std::convertible_to<bool>; })
+            {
+                std::sort(InOutEntries.begin(), InOutEntries.end(), [](const MapEntry& InA, const MapEntry& InB)
+                {
+                    return *(const key_type*)InA.Key < *(const key_type*)InB.Key;
+                });
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        virtual void* Find(void* MapPtr, const void* KeyPtr) override
+        {
+            auto& mapValue = AsType(MapPtr);
+            auto foundEntry = mapValue.find(*(const key_type*)KeyPtr);
+            if (foundEntry == mapValue.end())
+            {
+                return nullptr;
+            }
+            if constexpr (bSetType)
+            {
+                return (void*)&*foundEntry;
+            }
+            else
+            {
+                return (void*)&foundEntry->second;
+            }
+        }
+        virtual void* FindOrAdd(void* MapPtr, const void* KeyPtr) override
+        {
+            if constexpr (bSetType)
+            {
+                return (void*)&*AsType(MapPtr).insert(*(const key_type*)KeyPtr).first;
+            }
+            else
+            {
+                return (void*)&AsType(MapPtr).try_emplace(*(const key_type*)KeyPtr).first->second;
+            }
+        }
+        virtual bool Erase(void* MapPtr, const void* KeyPtr) override
+        {
+            return AsType(MapPtr).erase(*(const key_type*)KeyPtr) != 0;
+        }
+        virtual void MeasureHeap(void* MapPtr, size_t& OutBytes, size_t& OutAllocations) override
+        {
+            auto& mapValue = AsType(MapPtr);
+            if constexpr (requires { typename T::key_compare; })
+            {
+                // tree nodes: three links and a color next to the value
+                OutBytes += mapValue.size() * (sizeof(typename T::value_type) + 4 * sizeof(void*));
+                OutAllocations += mapValue.size();
+            }
+            else
+            {
+                // list nodes with a cached hash, plus the bucket array
+                OutBytes += mapValue.size() * (sizeof(typename T::value_type) + 2 * sizeof(void*)) + mapValue.bucket_count() * sizeof(void*);
+                OutAllocations += mapValue.size() + (mapValue.bucket_count() ? 1 : 0);
+            }
+        }
+        virtual bool EncodeKey(const void* KeyPtr, std::vector< uint8_t >& OutBytes) override
+        {
+            if constexpr (std::is_same_v< key_type, std::string >)
+            {
+                auto& keyValue = *(const std::string*)KeyPtr;
+                OutBytes.assign(keyValue.begin(), keyValue.end());
+                return true;
+            }
+            else if constexpr (std::is_trivially_copyable_v< key_type >)
+            {
+                OutBytes.assign((const uint8_t*)KeyPtr, (const uint8_t*)KeyPtr + sizeof(key_type));
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        virtual bool DecodeKey(const uint8_t* InBytes, size_t InSize, const std::function< void(const void*) >& InFunc) override
+        {
+            if constexpr (std::is_same_v< key_type, std::string >)
+            {
+                const std::string keyValue((const char*)InBytes, InSize);
+                InFunc(&keyValue);
+                return true;
+            }
+            else if constexpr (std::is_trivially_copyable_v< key_type > && std::is_default_constructible_v< key_type >)
+            {
+                if (InSize != sizeof(key_type))
+                {
+                    return false;
+                }
+                key_type keyValue;
+                std::memcpy((void*)&keyValue, InBytes, sizeof(key_type));
+                InFunc(&keyValue);
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        virtual std::string KeyToString(const uint8_t* InBytes, size_t InSize) override
+        {
+            if constexpr (std::is_same_v< key_type, std::string >)
+            {
+                return std::string((const char*)InBytes, InSize);
+            }
+            else if constexpr (std::is_arithmetic_v< key_type > || std::is_enum_v< key_type >)
+            {
+                key_type keyValue{};
+                std::memcpy(&keyValue, InBytes, std::min(InSize, sizeof(key_type)));
+                if constexpr (std::is_enum_v< key_type >)
+                {
+                    return std::to_string((int64_t)keyValue);
+                }
+                else
+                {
+                    return std::to_string(keyValue);
+                }
+            }
+            else
+            {
+                return "#";
+            }
+        }
+    };
+
+    enum class EWrapKind : uint8_t
+    {
+        UniquePtr,
+        SharedPtr,
+        Optional,
+        // raw pointer the holder deletes
+        OwningPointer,
+        // raw pointer to a value someone else owns
+        Pointer
+    };
+
+    template<typename T>
+    constexpr EWrapKind default_wrap_kind()
+    {
+        if constexpr (IsSharedPtr<T>) return EWrapKind::SharedPtr;
+        else if constexpr (IsOptional<T>) return EWrapKind::Optional;
+        else if constexpr (std::is_pointer_v<T>) return EWrapKind::Pointer;
+        else return EWrapKind::UniquePtr;
+    }
+
     struct WrapManipulator
     {
+        SPP_METADATA_ALLOCATED
+
+        EWrapKind Kind = EWrapKind::UniquePtr;
+
+        // Layout checked when the manipulator is made, so Has/Get skip the virtual calls: pointer wraps holding
+        // the pointer at offset 0 are read directly, optionals holding the value at 0 read their engaged flag.
+        bool bDirectPointer = false;
+        bool bDirectOptional = false;
+        uint32_t EngagedOffset = 0;
+
+        // nothing else reaches the wrapped value, copies are deep
+        bool IsExclusive() const { return Kind == EWrapKind::UniquePtr || Kind == EWrapKind::Optional || Kind == EWrapKind::OwningPointer; }
+        bool IsOwning() const { return Kind != EWrapKind::Pointer; }
+
+        bool Has(void* ValuePtr)
+        {
+            if (bDirectPointer)
+            {
+                return *(void**)ValuePtr != nullptr;
+            }
+            if (bDirectOptional)
+            {
+                return ((uint8_t*)ValuePtr)[EngagedOffset] != 0;
+            }
+            return IsValid(ValuePtr);
+        }
+
+        // the wrapped value, null when there isn't one
+        void* Get(void* ValuePtr)
+        {
+            if (bDirectPointer)
+            {
+                return *(void**)ValuePtr;
+            }
+            if (bDirectOptional)
+            {
+                return ((uint8_t*)ValuePtr)[EngagedOffset] ? ValuePtr : nullptr;
+            }
+            return IsValid(ValuePtr) ? GetValue(ValuePtr) : nullptr;
+        }
+
         virtual bool IsValid(void* ValuePtr) = 0;
         virtual void* GetValue(void* ValuePtr) = 0;
         virtual void Clear(void* ValuePtr) = 0;
+        // default constructs a new wrapped value, returns null if not possible
+        virtual void* Construct(void* ValuePtr) = 0;
+        // copies the wrapper itself (shares or aliases the value), false for exclusive wraps
+        virtual bool Assign(void* SrcPtr, void* DstPtr) = 0;
     };
 
-    template<typename T>
+    template<typename T, EWrapKind InKind = default_wrap_kind<T>()>
     struct TWrapManipulator : public WrapManipulator
     {
+        template<typename U>
+        struct wrapped_type { using type = typename U::element_type; };
+        template<typename U>
+        struct wrapped_type< std::optional<U> > { using type = U; };
+        template<typename U>
+        struct wrapped_type< U* > { using type = U; };
+
+        using element_type = typename wrapped_type<T>::type;
+
+        TWrapManipulator()
+        {
+            Kind = InKind;
+
+            if constexpr (std::is_pointer_v<T>)
+            {
+                bDirectPointer = true;
+            }
+            else if constexpr (IsUniquePtr<T> || IsSharedPtr<T>)
+            {
+                bDirectPointer = ProbePointerLayout();
+            }
+            else if constexpr (IsOptional<T>)
+            {
+                ProbeOptionalLayout();
+            }
+        }
+
+        // both standard libraries keep the stored pointer first, checked rather than assumed
+        static bool ProbePointerLayout()
+        {
+            if constexpr (std::is_default_constructible_v<T>)
+            {
+                if (sizeof(T) < sizeof(void*))
+                {
+                    return false;
+                }
+
+                T emptyProbe;
+                void* emptyPointer = nullptr;
+                std::memcpy(&emptyPointer, &emptyProbe, sizeof(void*));
+
+                // a fake address that is never dereferenced or freed
+                alignas(element_type) static uint8_t marker[sizeof(element_type)];
+                void* setPointer = nullptr;
+                if constexpr (IsSharedPtr<T>)
+                {
+                    // aliasing an empty owner, no control block
+                    T setProbe(std::shared_ptr<void>(), (element_type*)marker);
+                    std::memcpy(&setPointer, &setProbe, sizeof(void*));
+                }
+                else
+                {
+                    T setProbe((element_type*)marker);
+                    std::memcpy(&setPointer, &setProbe, sizeof(void*));
+                    setProbe.release();
+                }
+
+                return !emptyPointer && setPointer == (void*)marker;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        // the payload first and the engaged bool right after it, needs a default constructible value to check
+        void ProbeOptionalLayout()
+        {
+            if constexpr (std::is_default_constructible_v<element_type>)
+            {
+                constexpr size_t flagOffset = sizeof(element_type);
+                if (flagOffset >= sizeof(T))
+                {
+                    return;
+                }
+
+                T probe;
+                const bool bEmptyClear = ((uint8_t*)&probe)[flagOffset] == 0;
+                probe.emplace();
+                const bool bSetMatches = (void*)&*probe == (void*)&probe && ((uint8_t*)&probe)[flagOffset] == 1;
+                probe.reset();
+
+                if (bEmptyClear && bSetMatches && ((uint8_t*)&probe)[flagOffset] == 0)
+                {
+                    bDirectOptional = true;
+                    EngagedOffset = (uint32_t)flagOffset;
+                }
+            }
+        }
+
         auto& AsType(void* ValuePtr)
         {
             return *(T*)ValuePtr;
         }
         virtual bool IsValid(void* ValuePtr) override
         {
-            if (AsType(ValuePtr))
+            if constexpr (IsOptional<T>)
             {
-                return true;
+                return AsType(ValuePtr).has_value();
+            }
+            else
+            {
+                return AsType(ValuePtr) != nullptr;
             }
-
-            return false;
         }
         virtual void* GetValue(void* ValuePtr) override
         {
-            return AsType(ValuePtr).get();
+            if constexpr (IsOptional<T>)
+            {
+                return (void*)&*AsType(ValuePtr);
+            }
+            else if constexpr (std::is_pointer_v<T>)
+            {
+                return (void*)AsType(ValuePtr);
+            }
+            else
+            {
+                return (void*)AsType(ValuePtr).get();
+            }
         }
         virtual void Clear(void* ValuePtr) override
         {
-            AsType(ValuePtr).reset();
+            if constexpr (std::is_pointer_v<T>)
+            {
+                if constexpr (InKind == EWrapKind::OwningPointer)
+                {
+                    delete AsType(ValuePtr);
+                }
+                AsType(ValuePtr) = nullptr;
+            }
+            else
+            {
+                AsType(ValuePtr).reset();
+            }
+        }
+        virtual void* Construct(void* ValuePtr) override
+        {
+            if constexpr (std::is_default_constructible_v<element_type> && InKind != EWrapKind::Pointer)
+            {
+                if constexpr (IsOptional<T>)
+                {
+                    return (void*)&AsType(ValuePtr).emplace();
+                }
+                else if constexpr (IsSharedPtr<T>)
+                {
+                    AsType(ValuePtr) = std::make_shared<element_type>();
+                    return (void*)AsType(ValuePtr).get();
+                }
+                else if constexpr (std::is_pointer_v<T>)
+                {
+                    delete AsType(ValuePtr);
+                    AsType(ValuePtr) = new element_type();
+                    return (void*)AsType(ValuePtr);
+                }
+                else
+                {
+                    AsType(ValuePtr).reset(new element_type());
+                    return (void*)AsType(ValuePtr).get();
+                }
+            }
+            else
+            {
+                return nullptr;
+            }
+        }
+        virtual bool Assign(void* SrcPtr, void* DstPtr) override
+        {
+            if constexpr (InKind == EWrapKind::SharedPtr || InKind == EWrapKind::Pointer)
+            {
+                AsType(DstPtr) = AsType(SrcPtr);
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+        }
+    };
+
+    struct VariantManipulator
+    {
+        SPP_METADATA_ALLOCATED
+
+        // address of the active alternative and its index, null when valueless
+        virtual void* GetActive(void* VariantPtr, size_t& OutIndex) = 0;
+        // replaces the value with a default constructed alternative InIndex, null if not possible
+        virtual void* Emplace(void* VariantPtr, size_t InIndex) = 0;
+    };
+
+    template<typename T>
+    struct TVariantManipulator : public VariantManipulator
+    {
+        auto& AsType(void* VariantPtr)
+        {
+            return *(T*)VariantPtr;
+        }
+
+        template<size_t Idx>
+        static void* EmplaceAlternative(T& InVariant)
+        {
+            if constexpr (std::is_default_constructible_v< std::variant_alternative_t<Idx, T> >)
+            {
+                return &InVariant.template emplace<Idx>();
+            }
+            else
+            {
+                return nullptr;
+            }
+        }
+
+        template<size_t ...Is>
+        static void* EmplaceIndex(T& InVariant, size_t InIndex, std::index_sequence<Is...>)
+        {
+            using emplace_func = void* (*)(T&);
+            static constexpr emplace_func EmplaceFuncs[] = { &EmplaceAlternative<Is>... };
+            return InIndex < sizeof...(Is) ? EmplaceFuncs[InIndex](InVariant) : nullptr;
+        }
+
+        virtual void* GetActive(void* VariantPtr, size_t& OutIndex) override
+        {
+            auto& variantValue = AsType(VariantPtr);
+            OutIndex = variantValue.index();
+            if (variantValue.valueless_by_exception())
+            {
+                return nullptr;
+            }
+            return std::visit([](auto& InValue) -> void* { return (void*)&InValue; }, variantValue);
+        }
+        virtual void* Emplace(void* VariantPtr, size_t InIndex) override
+        {
+            return EmplaceIndex(AsType(VariantPtr), InIndex, std::make_index_sequence< std::variant_size_v<T> >{});
         }
     };
 }
\ No newline at end of file
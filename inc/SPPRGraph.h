@@ -0,0 +1,90 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include "SPPReflection.h"
+#include <span>
+
+namespace SPP
+{
+    // A field that can lead to another object: a PointerProperty, a wrapper (unique_ptr, shared_ptr, optional,
+    // owned pointer), a variant, or an array holding any of them (or structs holding them). Parent class and inline nested struct fields are flattened in, so Offset
+    // is from the start of the outer object.
+    struct ReferenceSlot
+    {
+        size_t Offset = 0;
+        ReflectedProperty* Property = nullptr;
+        EPropertyKind Kind = EPropertyKind::Pointer;
+    };
+
+    // built on first use per struct and kept, thread safe
+    SPP_REFLECTION_API const std::vector< ReferenceSlot >& GetReferenceSlots(const ReflectedStruct* InStruct);
+
+    static constexpr uint32_t GraphNoParent = ~0u;
+
+    struct GraphNode
+    {
+        void* Object = nullptr;
+        // the resolved (most derived when the pointer property knows how) type
+        const ReflectedStruct* Struct = nullptr;
+        uint32_t Depth = 0;
+        // index of the node it was first reached from, GraphNoParent for roots
+        uint32_t Parent = GraphNoParent;
+    };
+
+    struct GraphWalkSettings
+    {
+        // a batch never mixes depths, this splits wide levels
+        size_t MaxBatchSize = 64 * 1024;
+        // keep every edge (8 bytes each) for FindCycles
+        bool bRecordEdges = false;
+        size_t ReserveNodes = 0;
+    };
+
+    // Breadth first walk over the objects reachable from a set of roots through reflected pointers and owned
+    // (unique_ptr, shared_ptr, owned pointer) structs. Every object is reported once, the visited set is a flat open addressed table keyed
+    // by address. Each node's fields are found through its precomputed reference slots so nothing else about
+    // the object is touched. Objects must stay alive and unmoved for the walk.
+    class SPP_REFLECTION_API ReflectedGraphWalker
+    {
+    protected:
+        struct Impl;
+        std::unique_ptr<Impl> _impl;
+
+    public:
+        ReflectedGraphWalker(const GraphWalkSettings& InSettings = {});
+        ~ReflectedGraphWalker();
+
+        // false if the object was already reached
+        bool AddRoot(void* InObject, const ReflectedStruct* InStruct);
+
+        template<typename T>
+        bool AddRoot(T* InObject)
+        {
+            return AddRoot(InObject, get_type<T>()->structureRef.get());
+        }
+
+        // Next batch of newly reached objects, one depth, empty when the walk is done. The previous batch is
+        // expanded first, so pointers changed (cleared) by the caller while handling a batch are respected.
+        // The span is valid until the next call.
+        std::span< const GraphNode > NextBatch();
+
+        // NextBatch until done
+        void Walk(const std::function< void(std::span< const GraphNode >) >& InFunc);
+
+        // all nodes reached so far in discovery order, node indexes (Parent, FindCycles) point in here
+        std::span< const GraphNode > GetNodes() const;
+        size_t GetVisitedCount() const;
+        // references that reached an already visited object, shared objects and cycles
+        size_t GetRevisitCount() const;
+
+        // needs bRecordEdges and a finished walk: each group is the node indexes of a strongly connected
+        // component, more than one node or a node referencing itself
+        std::vector< std::vector< uint32_t > > FindCycles() const;
+
+        // forget everything, settings are kept
+        void Reset();
+    };
+}
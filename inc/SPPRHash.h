@@ -0,0 +1,25 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace SPP
+{
+    // Stable (no per process seed, little endian) 64 bit hash of a byte run. 
+    // Runs of 64+ bytes go through an 8 lane stripe kernel (SSE2 when available, 
+    // scalar otherwise - both give identical results).
+    SPP_REFLECTION_API uint64_t HashBytes(const void* InData, size_t InSize, uint64_t InSeed = 0);
+
+    // byte equality, 16 bytes at a time when SSE2 is available
+    SPP_REFLECTION_API bool BytesEqual(const void* InA, const void* InB, size_t InSize);
+
+    template<typename T>
+    inline uint64_t HashValue(const T& InValue, uint64_t InSeed = 0)
+    {
+        return HashBytes(&InValue, sizeof(T), InSeed);
+    }
+}
@@ -0,0 +1,123 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Opt-in counters and timings for reflection operations. Off by default, when off every hook is a single
+// relaxed load. Records go to thread local tables that only their thread writes and readers never lock, they are
+// merged when queried and folded into shared totals when the thread exits.
+// Define SPP_REFLECTION_INSTRUMENTATION as 0 to compile the hooks out entirely.
+#ifndef SPP_REFLECTION_INSTRUMENTATION
+    #define SPP_REFLECTION_INSTRUMENTATION 1
+#endif
+
+namespace SPP
+{
+    enum class EReflectionCounter : uint8_t
+    {
+        Invoke,             // per method
+        Visit,              // per struct type, inclusive of nested structs
+        TypeRegistration,   // per type, registrations made while instrumentation is on
+        NameLookup,         // get_type_by_name per name, FindProperty per struct
+        OverloadMatchFail,  // Invoke calls that matched no method, per struct and method name
+        COUNT
+    };
+
+    SPP_REFLECTION_API const char* GetReflectionCounterName(EReflectionCounter InCounter);
+
+    namespace InstrumentMode
+    {
+        enum EInstrumentMode : uint32_t
+        {
+            Off = 0,
+            Counters = 1 << 0,
+            // also keep every timed event per thread for ExportReflectionTrace
+            Trace = 1 << 1
+        };
+    }
+
+    SPP_REFLECTION_API extern std::atomic<uint32_t> GReflectionInstrumentMode;
+
+    inline uint32_t GetReflectionInstrumentMode()
+    {
+        return GReflectionInstrumentMode.load(std::memory_order_relaxed);
+    }
+    SPP_REFLECTION_API void SetReflectionInstrumentMode(uint32_t InMode);
+
+    inline uint64_t GetInstrumentTimeNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // InKey identifies what is counted (method, struct, type), the name is only copied the first time a key is seen
+    // on a thread, as InOwner::InName. Callers check the mode, this always records.
+    SPP_REFLECTION_API void RecordReflectionEvent(EReflectionCounter InCounter, const void* InKey,
+        const char* InOwner, const char* InName, uint64_t InStartNs, uint64_t InEndNs);
+
+    // times its own lifetime, nothing is read or written past the mode check when instrumentation is off
+    class ReflectionScope
+    {
+    private:
+        const void* _key = nullptr;
+        const char* _owner = nullptr;
+        const char* _name = nullptr;
+        uint64_t _startNs = 0;
+        EReflectionCounter _counter = EReflectionCounter::COUNT;
+
+    public:
+        ReflectionScope(EReflectionCounter InCounter, const void* InKey, const char* InOwner, const char* InName)
+        {
+#if SPP_REFLECTION_INSTRUMENTATION
+            if (GetReflectionInstrumentMode())
+            {
+                _counter = InCounter;
+                _key = InKey;
+                _owner = InOwner;
+                _name = InName;
+                _startNs = GetInstrumentTimeNs();
+            }
+#endif
+        }
+
+        ~ReflectionScope()
+        {
+#if SPP_REFLECTION_INSTRUMENTATION
+            if (_counter != EReflectionCounter::COUNT)
+            {
+                RecordReflectionEvent(_counter, _key, _owner, _name, _startNs, GetInstrumentTimeNs());
+            }
+#endif
+        }
+
+        ReflectionScope(const ReflectionScope&) = delete;
+        ReflectionScope& operator=(const ReflectionScope&) = delete;
+    };
+
+    struct ReflectionStat
+    {
+        EReflectionCounter Counter = EReflectionCounter::COUNT;
+        const void* Key = nullptr;
+        std::string Name;
+        uint64_t Count = 0;
+        uint64_t TotalNs = 0;
+        uint64_t MaxNs = 0;
+    };
+
+    // merged over all threads (including ones that have exited), sorted by total time then count
+    SPP_REFLECTION_API std::vector< ReflectionStat > GetReflectionStats();
+    SPP_REFLECTION_API std::vector< ReflectionStat > GetReflectionStats(EReflectionCounter InCounter);
+    SPP_REFLECTION_API void ResetReflectionStats();
+    SPP_REFLECTION_API void LogReflectionStats(size_t InMaxEntries = 20);
+
+    // Chrome trace event format (chrome://tracing, Perfetto), complete events per thread when recorded with
+    // InstrumentMode::Trace, plus the aggregated stats as metadata
+    SPP_REFLECTION_API bool ExportReflectionTrace(const char* InPath);
+}
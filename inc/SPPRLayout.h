@@ -0,0 +1,84 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+
+namespace SPP
+{
+    class ReflectedProperty;
+    class ReflectedStruct;
+
+    // A placed range of a struct. Ranges no reflected property explains and that alignment alone can't account for
+    // (vtable pointer, unreflected members) are kept as opaque fields with a null Property so reordering is honest.
+    struct LayoutField
+    {
+        ReflectedProperty* Property = nullptr;
+        size_t Offset = 0;
+        size_t Size = 0;
+        size_t Alignment = 1;
+        // fits in a cache line but crosses one
+        bool bStraddlesCacheLine = false;
+        uint64_t AccessCount = 0;
+    };
+
+    // alignment padding, Offset == Size of the struct minus Size for tail padding
+    struct LayoutHole
+    {
+        size_t Offset = 0;
+        size_t Size = 0;
+    };
+
+    struct LayoutReport
+    {
+        const ReflectedStruct* Struct = nullptr;
+        size_t Size = 0;
+        size_t Alignment = 1;
+        size_t CacheLineSize = 64;
+        size_t CacheLines = 0;
+
+        // offset order
+        std::vector< LayoutField > Fields;
+        std::vector< LayoutHole > Holes;
+        size_t PaddingBytes = 0;
+        // accessor based properties, their offset can't be known without an instance
+        std::vector< ReflectedProperty* > Unplaced;
+
+        // indexes into Fields, largest alignment first, and the size that order packs to
+        std::vector< size_t > OptimalOrder;
+        size_t OptimalSize = 0;
+
+        // only with access counts: fields at or above the hot threshold, packed size of each side
+        std::vector< size_t > HotFields;
+        std::vector< size_t > ColdFields;
+        size_t HotSize = 0;
+        size_t ColdSize = 0;
+
+        bool CanShrink() const { return OptimalSize < Size; }
+        bool HasHotColdSplit() const { return !HotFields.empty() && !ColdFields.empty(); }
+    };
+
+    // per property access counts from a profile (or anything else), optional
+    using LayoutAccessCounts = std::unordered_map< const ReflectedProperty*, uint64_t >;
+
+    struct LayoutSettings
+    {
+        size_t CacheLineSize = 64;
+        const LayoutAccessCounts* AccessCounts = nullptr;
+        // hot is a count of at least this fraction of the most accessed field
+        double HotFraction = 0.1;
+    };
+
+    SPP_REFLECTION_API LayoutReport AnalyzeLayout(const ReflectedStruct* InStruct, const LayoutSettings& InSettings = {});
+    // every registered struct in one pass
+    SPP_REFLECTION_API std::vector< LayoutReport > AnalyzeAllLayouts(const LayoutSettings& InSettings = {});
+
+    SPP_REFLECTION_API void LogLayoutReport(const LayoutReport& InReport);
+    // JSON, one entry per report
+    SPP_REFLECTION_API bool ExportLayoutReport(const char* InPath, const std::vector< LayoutReport >& InReports);
+}
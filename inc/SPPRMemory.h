@@ -0,0 +1,73 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <span>
+
+namespace SPP
+{
+    class ReflectedProperty;
+    class ReflectedStruct;
+
+    // Memory held by a reflected object, heap figures are capacity based (what was allocated, not what's in use)
+    struct MemoryUsage
+    {
+        // sizeof the measured object(s)
+        size_t InlineBytes = 0;
+        // string buffers past the small string storage, vector buffers, unique_ptr targets
+        size_t HeapBytes = 0;
+        size_t Allocations = 0;
+        // vector capacity past size, included in HeapBytes
+        size_t WastedCapacityBytes = 0;
+        // bytes of structs (inline and on the heap) not covered by a reflected property,
+        // alignment padding or members that aren't reflected
+        size_t PaddingBytes = 0;
+
+        size_t TotalBytes() const { return InlineBytes + HeapBytes; }
+
+        MemoryUsage& operator+=(const MemoryUsage& InValue)
+        {
+            InlineBytes += InValue.InlineBytes;
+            HeapBytes += InValue.HeapBytes;
+            Allocations += InValue.Allocations;
+            WastedCapacityBytes += InValue.WastedCapacityBytes;
+            PaddingBytes += InValue.PaddingBytes;
+            return *this;
+        }
+    };
+
+    struct PropertyMemoryUsage
+    {
+        ReflectedProperty* Property = nullptr;
+        // InlineBytes is the property's own size
+        MemoryUsage Usage;
+    };
+
+    // totals over a set of instances of one type, broken down by top level property (parent class properties included)
+    struct TypeMemoryReport
+    {
+        const ReflectedStruct* Struct = nullptr;
+        size_t InstanceCount = 0;
+        MemoryUsage Total;
+        std::vector< PropertyMemoryUsage > Properties;
+    };
+
+    // InStride of 0 means tightly packed (sizeof)
+    SPP_REFLECTION_API TypeMemoryReport MeasureTypeMemory(const ReflectedStruct* InStruct, void* InObjects, size_t InCount, size_t InStride = 0);
+    // instances that aren't contiguous (pointers to live objects)
+    SPP_REFLECTION_API TypeMemoryReport MeasureTypeMemory(const ReflectedStruct* InStruct, std::span< void* const > InObjects);
+
+    template<typename ObjectType>
+    TypeMemoryReport MeasureTypeMemory(const ReflectedStruct* InStruct, std::span<ObjectType> InObjects)
+    {
+        return MeasureTypeMemory(InStruct, (void*)InObjects.data(), InObjects.size(), sizeof(ObjectType));
+    }
+
+    // totals, then properties by total bytes, flagging wasted capacity and padding
+    SPP_REFLECTION_API void LogMemoryReport(const TypeMemoryReport& InReport);
+}
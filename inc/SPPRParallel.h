@@ -0,0 +1,100 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include "SPPReflection.h"
+#include <atomic>
+#include <functional>
+#include <span>
+
+namespace SPP
+{
+    // fixed set of workers, each owns a deque: it pops its newest task and steals the oldest from the others.
+    // the thread calling RunAndWait joins in as the last worker.
+    class SPP_REFLECTION_API WorkStealingPool
+    {
+        NO_COPY_ALLOWED(WorkStealingPool);
+
+    public:
+        using Task = std::function< void(uint32_t InWorker) >;
+
+        // the tasks one RunAndWait waits for, each caller has its own so concurrent users don't wait on each other
+        struct TaskGroup
+        {
+            std::atomic<int64_t> Pending = 0;
+        };
+
+        static constexpr uint32_t DefaultThreadCount = UINT32_MAX;
+
+        // InThreadCount helper threads, 0 runs everything on the caller, DefaultThreadCount uses hardware_concurrency - 1
+        WorkStealingPool(uint32_t InThreadCount = DefaultThreadCount);
+        ~WorkStealingPool();
+
+        // helpers plus the calling thread
+        uint32_t GetWorkerCount() const;
+
+        // queue a task of InGroup on a worker, tasks may push more tasks (use their own InWorker)
+        void Push(uint32_t InWorker, TaskGroup& InGroup, Task&& InTask);
+
+        // work until every task of InGroup, and everything pushed into it, has finished, sleeping when there is
+        // nothing to take
+        void RunAndWait(TaskGroup& InGroup);
+
+        // shared pool, created on first use
+        static WorkStealingPool& Get();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> _impl;
+    };
+
+    // visitor used by ParallelVisit, an instance is created per work item so it is only ever used by one thread
+    struct IParallelVisitor : IVisitor
+    {
+        virtual ~IParallelVisitor() {}
+
+        // only reads the visited objects and writes its own members, 
+        // visitors that are not get visited serially on a single instance
+        virtual bool IsThreadSafe() const { return false; }
+
+        // a split array, this instance receives the element range [InStart, InEnd) (Begin/EndArrayItem calls)
+        // while the visitor of the owning object only sees BeginArray/EndArray
+        virtual void BeginArrayRange(const ReflectedProperty&, size_t, size_t) {}
+
+        // fold in another work item's results, called on the calling thread in work item order
+        virtual void Merge(IParallelVisitor&) {}
+    };
+
+    using ParallelVisitorFactory = std::function< std::unique_ptr<IParallelVisitor>() >;
+
+    struct ParallelVisitSettings
+    {
+        // top level objects per work item
+        size_t ObjectsPerItem = 256;
+        // arrays longer than this are split into element ranges of this size
+        size_t ArraySplitSize = 4096;
+        // null uses WorkStealingPool::Get()
+        WorkStealingPool* Pool = nullptr;
+    };
+
+    // Visit InCount objects InStride bytes apart. Work items depend only on the data and the settings, 
+    // never on the thread count, so the result is deterministic. It is not object order though: items are merged
+    // in object order, each item's own results first and then, depth first, the ranges of the arrays it split
+    // (in the order the arrays were visited), so split array elements come after the rest of their item.
+    // InFactory is called from the worker threads.
+    SPP_REFLECTION_API std::unique_ptr<IParallelVisitor> ParallelVisit(ReflectedStruct* InStruct, void* InObjects, size_t InCount, size_t InStride,
+        const ParallelVisitorFactory& InFactory, const ParallelVisitSettings& InSettings = {});
+
+    template<typename VisitorT, typename T>
+    std::unique_ptr<VisitorT> ParallelVisit(std::span<T> InObjects, const ParallelVisitSettings& InSettings = {})
+    {
+        auto structRef = get_type<T>().GetTypeData()->structureRef.get();
+        SE_ASSERT(structRef);
+
+        auto oVisitor = ParallelVisit(structRef, (void*)InObjects.data(), InObjects.size(), sizeof(T),
+            []() -> std::unique_ptr<IParallelVisitor> { return std::make_unique<VisitorT>(); }, InSettings);
+        return std::unique_ptr<VisitorT>((VisitorT*)oVisitor.release());
+    }
+}
@@ -0,0 +1,112 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+namespace SPP
+{
+    class ReflectedProperty;
+
+    enum class EPatchOp : uint8_t
+    {
+        // raw value bytes of a leaf property (strings store their characters)
+        SetValue,
+        // run of contiguous array elements, Index is the first element, Count the run length
+        SetElements,
+        // array resize to Count
+        Resize,
+        // allocate a default wrapped value (unique_ptr, optional...), Index picks a variant's alternative,
+        // for maps a default entry for the key in the value bytes
+        Construct,
+        // release the wrapped value
+        Clear,
+        // remove the map entry for the key in the value bytes
+        Erase,
+        // bits of one integer word (the bitfields sharing it), Count is the mask, the value bytes the masked word
+        SetBits
+    };
+
+    // one hop through the object, Index is the array element when the property is an array, map entries are
+    // found by key (KeySize bytes at KeyStart in the patch values)
+    struct PatchStep
+    {
+        ReflectedProperty* Property = nullptr;
+        int32_t Index = -1;
+        uint32_t KeyStart = 0;
+        uint32_t KeySize = 0;
+    };
+
+    struct PatchEntry
+    {
+        uint32_t PathStart = 0;
+        uint32_t PathCount = 0;
+        EPatchOp Op = EPatchOp::SetValue;
+        int32_t Index = -1;
+        size_t Count = 0;
+        uint32_t ValueStart = 0;
+        uint32_t ValueSize = 0;
+    };
+
+    // Compact list of property level edits produced by ReflectedStruct::Diff and consumed by ReflectedStruct::Apply.
+    // Paths reference the registered properties so it only lives as long as the type registry does.
+    class SPP_REFLECTION_API ReflectedPatch
+    {
+    protected:
+        const class ReflectedStruct* _rootStruct = nullptr;
+
+        std::vector< PatchStep > _steps;
+        std::vector< PatchEntry > _entries;
+        std::vector< uint8_t > _values;
+
+        // only used while diffing
+        std::vector< PatchStep > _curPath;
+
+        PatchEntry& AddEntry(ReflectedProperty* InProperty, EPatchOp InOp, int32_t InIndex = -1);
+
+    public:
+        ReflectedPatch() {}
+        ReflectedPatch(const class ReflectedStruct* InRoot) : _rootStruct(InRoot) {}
+
+        void PushPath(ReflectedProperty* InProperty, int32_t InIndex = -1)
+        {
+            _curPath.push_back({ InProperty, InIndex });
+        }
+        void PushKeyPath(ReflectedProperty* InProperty, const void* InKey, size_t InKeySize)
+        {
+            _curPath.push_back({ InProperty, -1, (uint32_t)_values.size(), (uint32_t)InKeySize });
+            _values.insert(_values.end(), (const uint8_t*)InKey, (const uint8_t*)InKey + InKeySize);
+        }
+        void PopPath()
+        {
+            _curPath.pop_back();
+        }
+
+        void AddValue(ReflectedProperty* InProperty, const void* InData, size_t InSize);
+        void AddElements(ReflectedProperty* InProperty, int32_t InStart, size_t InCount, const void* InData, size_t InSize);
+        void AddResize(ReflectedProperty* InProperty, size_t InNewSize);
+        void AddConstruct(ReflectedProperty* InProperty, int32_t InIndex = -1);
+        void AddClear(ReflectedProperty* InProperty);
+        // map entries, the key as MapManipulator::EncodeKey bytes
+        void AddConstructKey(ReflectedProperty* InProperty, const void* InKey, size_t InKeySize);
+        void AddErase(ReflectedProperty* InProperty, const void* InKey, size_t InKeySize);
+        void AddBits(ReflectedProperty* InProperty, uint64_t InBits, uint64_t InMask, size_t InWordSize);
+
+        const class ReflectedStruct* GetRootStruct() const { return _rootStruct; }
+        const auto& GetEntries() const { return _entries; }
+        const PatchStep* GetPath(const PatchEntry& InEntry) const { return _steps.data() + InEntry.PathStart; }
+        const uint8_t* GetValueData(const PatchEntry& InEntry) const { return _values.data() + InEntry.ValueStart; }
+        const uint8_t* GetKeyData(const PatchStep& InStep) const { return _values.data() + InStep.KeyStart; }
+        bool IsEmpty() const { return _entries.empty(); }
+
+        // heap bytes held by this patch
+        size_t GetMemorySize() const;
+        // readable path e.g. "data.TAG" or "Players[1].health"
+        std::string GetPathString(const PatchEntry& InEntry) const;
+        void LogOut() const;
+    };
+}
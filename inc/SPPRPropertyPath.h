@@ -0,0 +1,181 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include "SPPReflection.h"
+#include <string_view>
+
+namespace SPP
+{
+    enum class EPathStep : uint8_t
+    {
+        // add a byte offset
+        Offset,
+        // container element or wrapped target, through ReflectedProperty::Navigate
+        Navigate,
+        // value reached through a property accessor
+        Accessor
+    };
+
+    struct PropertyPathStep
+    {
+        EPathStep Type = EPathStep::Offset;
+        int32_t Index = -1;
+        size_t Offset = 0;
+        ReflectedProperty* Property = nullptr;
+    };
+
+    // A nested property address like "data.TAG", "Players[1].name" or "location.X" resolved once 
+    // against the reflected layout. Consecutive struct members fold into a single offset, containers
+    // and unique_ptrs become navigate steps.
+    class SPP_REFLECTION_API PropertyPath
+    {
+    protected:
+        const ReflectedStruct* _root = nullptr;
+        ReflectedProperty* _leaf = nullptr;
+        std::vector< PropertyPathStep > _steps;
+        // path is a single pointer add
+        bool _bOffsetOnly = false;
+        size_t _offsetOnly = 0;
+
+    public:
+        PropertyPath() {}
+        PropertyPath(const ReflectedStruct* InRoot, std::string_view InPath)
+        {
+            Compile(InRoot, InPath);
+        }
+
+        bool Compile(const ReflectedStruct* InRoot, std::string_view InPath);
+
+        bool IsValid() const { return _leaf != nullptr; }
+        ReflectedProperty* GetLeaf() const { return _leaf; }
+        CPPType GetLeafType() const { return _leaf ? _leaf->GetCPPType() : CPPType(); }
+        const auto& GetSteps() const { return _steps; }
+        // a single pointer add from the object, GetOffset is only meaningful when this is true
+        bool IsOffsetOnly() const { return _bOffsetOnly; }
+        size_t GetOffset() const { return _offsetOnly; }
+
+        // address of the leaf value, null if a container index is out of range or a unique_ptr is empty
+        void* Resolve(void* InStruct) const
+        {
+            if (_bOffsetOnly)
+            {
+                return (uint8_t*)InStruct + _offsetOnly;
+            }
+
+            auto curAddr = (uint8_t*)InStruct;
+            for (const auto& curStep : _steps)
+            {
+                switch (curStep.Type)
+                {
+                case EPathStep::Offset:
+                    curAddr += curStep.Offset;
+                    break;
+                case EPathStep::Navigate:
+                    curAddr = (uint8_t*)curStep.Property->Navigate(curAddr, curStep.Index);
+                    if (!curAddr)
+                    {
+                        return nullptr;
+                    }
+                    break;
+                case EPathStep::Accessor:
+                    curAddr = (uint8_t*)curStep.Property->AccessValueAddress(curAddr);
+                    break;
+                }
+            }
+            return curAddr;
+        }
+
+        template<typename T>
+        bool IsLeafType() const
+        {
+            return _leaf && _leaf->GetCPPType() == get_type<T>();
+        }
+
+        template<typename T>
+        T* Access(void* InStruct) const
+        {
+            return IsLeafType<T>() ? (T*)Resolve(InStruct) : nullptr;
+        }
+
+        template<typename T>
+        bool Get(void* InStruct, T& OutValue) const
+        {
+            auto value = Access<T>(InStruct);
+            if (value)
+            {
+                OutValue = *value;
+            }
+            return value != nullptr;
+        }
+
+        template<typename T>
+        bool Set(void* InStruct, const T& InValue) const
+        {
+            auto value = Access<T>(InStruct);
+            if (value)
+            {
+                *value = InValue;
+            }
+            return value != nullptr;
+        }
+
+        // arrays of objects, InStride is the distance between objects (sizeof for plain arrays)
+        // returns how many objects resolved
+        template<typename T>
+        size_t GetArray(void* InObjects, size_t InCount, size_t InStride, T* OutValues) const
+        {
+            if (!IsLeafType<T>())
+            {
+                return 0;
+            }
+
+            auto curObject = (uint8_t*)InObjects;
+            if (_bOffsetOnly)
+            {
+                GatherStrided(curObject + _offsetOnly, InCount, InStride, OutValues);
+                return InCount;
+            }
+
+            size_t oResolved = 0;
+            for (size_t Iter = 0; Iter < InCount; Iter++, curObject += InStride)
+            {
+                if (auto value = (T*)Resolve(curObject))
+                {
+                    OutValues[Iter] = *value;
+                    oResolved++;
+                }
+            }
+            return oResolved;
+        }
+
+        template<typename T>
+        size_t SetArray(void* InObjects, size_t InCount, size_t InStride, const T* InValues) const
+        {
+            if (!IsLeafType<T>())
+            {
+                return 0;
+            }
+
+            auto curObject = (uint8_t*)InObjects;
+            if (_bOffsetOnly)
+            {
+                ScatterStrided(curObject + _offsetOnly, InCount, InStride, InValues);
+                return InCount;
+            }
+
+            size_t oResolved = 0;
+            for (size_t Iter = 0; Iter < InCount; Iter++, curObject += InStride)
+            {
+                if (auto value = (T*)Resolve(curObject))
+                {
+                    *value = InValues[Iter];
+                    oResolved++;
+                }
+            }
+            return oResolved;
+        }
+    };
+}
@@ -0,0 +1,131 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include "SPPRPropertyPath.h"
+#include <string_view>
+#include <unordered_map>
+
+namespace SPP
+{
+    enum class EQueryOp : uint8_t
+    {
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        And,
+        Or,
+        Not
+    };
+
+    // what the compared value is read as
+    enum class EQueryValue : uint8_t
+    {
+        Int8, Int16, Int32, Int64,
+        UInt8, UInt16, UInt32, UInt64,
+        Float, Double,
+        Bool,
+        String
+    };
+
+    struct QueryNode
+    {
+        EQueryOp Op = EQueryOp::Equal;
+        // children for And/Or/Not
+        int32_t Left = -1;
+        int32_t Right = -1;
+
+        // comparisons
+        std::string PathString;
+        PropertyPath Path;
+        EQueryValue ValueKind = EQueryValue::Int32;
+        int64_t IntLiteral = 0;
+        uint64_t UIntLiteral = 0;
+        double FloatLiteral = 0;
+        std::string StringLiteral;
+    };
+
+    enum class EQueryIndex : uint8_t
+    {
+        // ordered keys, answers range and equality comparisons
+        Sorted,
+        // equality only
+        Hashed
+    };
+
+    // Secondary index over one property of a span of objects. Rebuild after the objects change.
+    // Lookups are conservative, the query re-checks every candidate against the full predicate.
+    class SPP_REFLECTION_API QueryIndex
+    {
+    protected:
+        std::string _pathString;
+        PropertyPath _path;
+        EQueryValue _valueKind = EQueryValue::Int32;
+        EQueryIndex _indexType = EQueryIndex::Sorted;
+
+        std::vector< std::pair<double, uint32_t> > _sortedKeys;
+        std::unordered_multimap< uint64_t, uint32_t > _hashedKeys;
+
+    public:
+        bool Build(const ReflectedStruct* InStruct, std::string_view InPath, EQueryIndex InIndexType,
+            const void* InObjects, size_t InCount, size_t InStride = 0);
+
+        const auto& GetPathString() const { return _pathString; }
+        EQueryIndex GetIndexType() const { return _indexType; }
+
+        // false if this index can't answer the comparison
+        bool Lookup(const QueryNode& InComparison, std::vector<uint32_t>& OutCandidates) const;
+    };
+
+    // Small predicate language compiled against reflected metadata, e.g.
+    //     health < 10 && ourGuy == GoodGuy
+    //     (data.GUID >= 100 || GuyName == "bob") && !(X > 1.5)
+    // Enum literals resolve through the EnumCollection at compile time. Execution gathers each compared
+    // property into a packed column per chunk of objects and runs a tight compare loop into a byte mask.
+    class SPP_REFLECTION_API ReflectedQuery
+    {
+    protected:
+        const ReflectedStruct* _struct = nullptr;
+        std::vector< QueryNode > _nodes;
+        int32_t _root = -1;
+        std::string _error;
+
+        void EvaluateChunk(int32_t InNode, const uint8_t* InObjects, size_t InCount, size_t InStride,
+            std::vector< std::vector<uint8_t> >& InOutMasks, std::vector<uint64_t>& InOutScratch) const;
+        bool EvaluateNode(int32_t InNode, const void* InObject) const;
+        const QueryNode* FindIndexedComparison(int32_t InNode, const std::vector<const QueryIndex*>& InIndices, const QueryIndex*& OutIndex) const;
+
+        friend struct QueryParser;
+
+    public:
+        ReflectedQuery() {}
+        ReflectedQuery(const ReflectedStruct* InStruct, std::string_view InQuery)
+        {
+            Compile(InStruct, InQuery);
+        }
+
+        bool Compile(const ReflectedStruct* InStruct, std::string_view InQuery);
+        bool IsValid() const { return _root >= 0; }
+        const auto& GetError() const { return _error; }
+
+        // single object
+        bool Evaluate(const void* InObject) const;
+
+        // indices of the matching objects in ascending order, InStride of 0 means the struct size
+        std::vector<uint32_t> Execute(const void* InObjects, size_t InCount, size_t InStride = 0) const;
+        // uses one of the indices to narrow candidates when the query allows it (an And chain comparison)
+        std::vector<uint32_t> Execute(const void* InObjects, size_t InCount, size_t InStride, 
+            const std::vector<const QueryIndex*>& InIndices) const;
+
+        template<typename ObjectType>
+        std::vector<uint32_t> Execute(std::span<ObjectType> InObjects) const
+        {
+            return Execute(InObjects.data(), InObjects.size(), sizeof(ObjectType));
+        }
+    };
+}
@@ -0,0 +1,413 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include "SPPReflection.h"
+#include <string_view>
+#include <new>
+#include <utility>
+
+namespace SPP
+{
+    // Packed values of one column, allocated aligned for the element type. Only trivially copyable values are
+    // stored, the allocation and the memcpys into it implicitly create them.
+    class SoAColumnBytes
+    {
+    protected:
+        uint8_t* _data = nullptr;
+        size_t _size = 0;
+        size_t _capacity = 0;
+        size_t _align = alignof(std::max_align_t);
+
+        void Reallocate(size_t InCapacity)
+        {
+            auto newData = (uint8_t*)::operator new(InCapacity, std::align_val_t(_align));
+            if (_size)
+            {
+                std::memcpy(newData, _data, _size);
+            }
+            Free();
+            _data = newData;
+            _capacity = InCapacity;
+        }
+
+        void Free()
+        {
+            if (_data)
+            {
+                ::operator delete(_data, std::align_val_t(_align));
+                _data = nullptr;
+            }
+        }
+
+    public:
+        SoAColumnBytes() {}
+        SoAColumnBytes(size_t InAlign) : _align(std::max< size_t >(InAlign, 1)) {}
+        SoAColumnBytes(const SoAColumnBytes& InOther) : _align(InOther._align)
+        {
+            resize(InOther._size);
+            if (_size)
+            {
+                std::memcpy(_data, InOther._data, _size);
+            }
+        }
+        SoAColumnBytes(SoAColumnBytes&& InOther) noexcept :
+            _data(std::exchange(InOther._data, nullptr)), _size(std::exchange(InOther._size, 0)),
+            _capacity(std::exchange(InOther._capacity, 0)), _align(InOther._align) {}
+        ~SoAColumnBytes() { Free(); }
+
+        SoAColumnBytes& operator=(SoAColumnBytes InOther) noexcept
+        {
+            std::swap(_data, InOther._data);
+            std::swap(_size, InOther._size);
+            std::swap(_capacity, InOther._capacity);
+            std::swap(_align, InOther._align);
+            return *this;
+        }
+
+        uint8_t* data() { return _data; }
+        const uint8_t* data() const { return _data; }
+        size_t size() const { return _size; }
+        size_t alignment() const { return _align; }
+
+        void reserve(size_t InSize)
+        {
+            if (InSize > _capacity)
+            {
+                Reallocate(InSize);
+            }
+        }
+
+        // new bytes are zeroed
+        void resize(size_t InSize)
+        {
+            if (InSize > _capacity)
+            {
+                Reallocate(std::max(InSize, _capacity * 2));
+            }
+            if (InSize > _size)
+            {
+                std::memset(_data + _size, 0, InSize - _size);
+            }
+            _size = InSize;
+        }
+
+        void erase(size_t InOffset, size_t InSize)
+        {
+            SE_ASSERT(InOffset + InSize <= _size);
+            std::memmove(_data + InOffset, _data + InOffset + InSize, _size - InOffset - InSize);
+            _size -= InSize;
+        }
+    };
+
+    // one column of a ReflectedSoA, plain values are kept as packed bytes, strings in their own vector
+    struct SoAColumn
+    {
+        std::string Name;
+        CPPType Type;
+        // offset of the value inside the source struct, or of the accessor owner for accessor properties
+        size_t Offset = 0;
+        size_t ElementSize = 0;
+        ReflectedProperty* Accessor = nullptr;
+        bool bString = false;
+
+        SoAColumnBytes Bytes{};
+        std::vector< std::string > Strings{};
+
+        void* ValueAddress(const void* InObject) const
+        {
+            auto ownerAddr = (uint8_t*)InObject + Offset;
+            return Accessor ? Accessor->AccessValueAddress(ownerAddr) : ownerAddr;
+        }
+    };
+
+    // strided copy for a runtime sized value, picks the typed kernel where one exists
+    inline void GatherStridedBytes(const void* InFirst, size_t InCount, size_t InStride, size_t InElementSize, void* OutValues)
+    {
+        switch (InElementSize)
+        {
+        case 1: GatherStrided(InFirst, InCount, InStride, (uint8_t*)OutValues); return;
+        case 2: GatherStrided(InFirst, InCount, InStride, (uint16_t*)OutValues); return;
+        case 4: GatherStrided(InFirst, InCount, InStride, (uint32_t*)OutValues); return;
+        case 8: GatherStrided(InFirst, InCount, InStride, (uint64_t*)OutValues); return;
+        }
+        for (size_t Iter = 0; Iter < InCount; Iter++)
+        {
+            std::memcpy((uint8_t*)OutValues + Iter * InElementSize, (const uint8_t*)InFirst + Iter * InStride, InElementSize);
+        }
+    }
+
+    inline void ScatterStridedBytes(void* InFirst, size_t InCount, size_t InStride, size_t InElementSize, const void* InValues)
+    {
+        switch (InElementSize)
+        {
+        case 1: ScatterStrided(InFirst, InCount, InStride, (const uint8_t*)InValues); return;
+        case 2: ScatterStrided(InFirst, InCount, InStride, (const uint16_t*)InValues); return;
+        case 4: ScatterStrided(InFirst, InCount, InStride, (const uint32_t*)InValues); return;
+        case 8: ScatterStrided(InFirst, InCount, InStride, (const uint64_t*)InValues); return;
+        }
+        for (size_t Iter = 0; Iter < InCount; Iter++)
+        {
+            std::memcpy((uint8_t*)InFirst + Iter * InStride, (const uint8_t*)InValues + Iter * InElementSize, InElementSize);
+        }
+    }
+
+    // Structure of arrays built from the reflected layout of T. Every arithmetic, enum and string
+    // property (nested structs flattened as "data.GUID") gets its own column. Containers, pointers and
+    // unique_ptrs are not stored, converting back leaves them default constructed.
+    template<typename T>
+    class ReflectedSoA
+    {
+    protected:
+        std::vector< SoAColumn > _columns;
+        size_t _size = 0;
+
+        void AddColumns(const ReflectedStruct* InStruct, size_t InBaseOffset, const std::string& InPrefix)
+        {
+            auto stringType = get_type< std::string >();
+
+            InStruct->IterateProperties([&](ReflectedProperty* InProperty)
+            {
+                auto propType = InProperty->GetCPPType();
+                auto propTypeData = propType.GetTypeData();
+                auto propName = InPrefix + InProperty->GetName().c_str();
+
+                if (InProperty->IsAccessorBased())
+                {
+                    _columns.push_back({ propName, propType, InBaseOffset, propTypeData->get_sizeof, InProperty, false, SoAColumnBytes(propTypeData->get_alignof) });
+                }
+                else if (propTypeData->structureRef && !propTypeData->arrayManipulator && !propTypeData->wrapManipulator)
+                {
+                    AddColumns(propTypeData->structureRef.get(), InBaseOffset + InProperty->GetPropOffset(), propName + ".");
+                }
+                else if (propType == stringType)
+                {
+                    _columns.push_back({ propName, propType, InBaseOffset + InProperty->GetPropOffset(), sizeof(std::string), nullptr, true });
+                }
+                else if (InProperty->IsBlockCopyable() && !propTypeData->is_pointer &&
+                    (propTypeData->is_arithmetic || propTypeData->is_enum || propTypeData->is_class))
+                {
+                    _columns.push_back({ propName, propType, InBaseOffset + InProperty->GetPropOffset(), propTypeData->get_sizeof, nullptr, false, 
+                        SoAColumnBytes(propTypeData->get_alignof) });
+                }
+            });
+        }
+
+        static void CopyOut(SoAColumn& InColumn, size_t InIdx, const T& InObject)
+        {
+            if (InColumn.bString)
+            {
+                InColumn.Strings[InIdx] = *(const std::string*)InColumn.ValueAddress(&InObject);
+            }
+            else
+            {
+                std::memcpy(InColumn.Bytes.data() + InIdx * InColumn.ElementSize, InColumn.ValueAddress(&InObject), InColumn.ElementSize);
+            }
+        }
+
+    public:
+        ReflectedSoA()
+        {
+            auto refStruct = get_type<T>().GetTypeData()->structureRef.get();
+            SE_ASSERT(refStruct);
+            AddColumns(refStruct, 0, "");
+        }
+
+        ReflectedSoA(const std::vector<T>& InObjects) : ReflectedSoA()
+        {
+            FromVector(InObjects);
+        }
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        const auto& GetColumns() const { return _columns; }
+
+        void reserve(size_t InCount)
+        {
+            for (auto& curColumn : _columns)
+            {
+                if (curColumn.bString)
+                {
+                    curColumn.Strings.reserve(InCount);
+                }
+                else
+                {
+                    curColumn.Bytes.reserve(InCount * curColumn.ElementSize);
+                }
+            }
+        }
+
+        void resize(size_t InCount)
+        {
+            for (auto& curColumn : _columns)
+            {
+                if (curColumn.bString)
+                {
+                    curColumn.Strings.resize(InCount);
+                }
+                else
+                {
+                    curColumn.Bytes.resize(InCount * curColumn.ElementSize);
+                }
+            }
+            _size = InCount;
+        }
+
+        void clear()
+        {
+            resize(0);
+        }
+
+        void push_back(const T& InObject)
+        {
+            resize(_size + 1);
+            for (auto& curColumn : _columns)
+            {
+                CopyOut(curColumn, _size - 1, InObject);
+            }
+        }
+
+        // keeps order
+        void erase(size_t InIdx)
+        {
+            SE_ASSERT(InIdx < _size);
+            for (auto& curColumn : _columns)
+            {
+                if (curColumn.bString)
+                {
+                    curColumn.Strings.erase(curColumn.Strings.begin() + InIdx);
+                }
+                else
+                {
+                    curColumn.Bytes.erase(InIdx * curColumn.ElementSize, curColumn.ElementSize);
+                }
+            }
+            _size--;
+        }
+
+        // O(1), moves the last element into the hole
+        void swap_remove(size_t InIdx)
+        {
+            SE_ASSERT(InIdx < _size);
+            const size_t lastIdx = _size - 1;
+            if (InIdx != lastIdx)
+            {
+                for (auto& curColumn : _columns)
+                {
+                    if (curColumn.bString)
+                    {
+                        curColumn.Strings[InIdx] = std::move(curColumn.Strings[lastIdx]);
+                    }
+                    else
+                    {
+                        std::memcpy(curColumn.Bytes.data() + InIdx * curColumn.ElementSize,
+                            curColumn.Bytes.data() + lastIdx * curColumn.ElementSize,
+                            curColumn.ElementSize);
+                    }
+                }
+            }
+            resize(lastIdx);
+        }
+
+        SoAColumn* FindColumn(std::string_view InName)
+        {
+            for (auto& curColumn : _columns)
+            {
+                if (curColumn.Name == InName)
+                {
+                    return &curColumn;
+                }
+            }
+            return nullptr;
+        }
+
+        // typed view of one column, empty on unknown name or type mismatch
+        template<typename U>
+        std::span<U> Column(std::string_view InName)
+        {
+            auto foundColumn = FindColumn(InName);
+            if (!foundColumn || foundColumn->Type != get_type<U>())
+            {
+                return {};
+            }
+            if constexpr (std::is_same_v<U, std::string>)
+            {
+                return std::span<U>(foundColumn->Strings.data(), _size);
+            }
+            else
+            {
+                static_assert(std::is_trivially_copyable_v<U>, "packed columns only hold trivially copyable values");
+                SE_ASSERT(sizeof(U) == foundColumn->ElementSize && alignof(U) <= foundColumn->Bytes.alignment());
+                if (!_size)
+                {
+                    return {};
+                }
+#if defined(__cpp_lib_start_lifetime_as)
+                return std::span<U>(std::start_lifetime_as_array<U>(foundColumn->Bytes.data(), _size), _size);
+#else
+                return std::span<U>(std::launder((U*)foundColumn->Bytes.data()), _size);
+#endif
+            }
+        }
+
+        void FromVector(const std::vector<T>& InObjects)
+        {
+            resize(InObjects.size());
+            if (InObjects.empty())
+            {
+                return;
+            }
+
+            for (auto& curColumn : _columns)
+            {
+                if (curColumn.bString || curColumn.Accessor)
+                {
+                    for (size_t Iter = 0; Iter < InObjects.size(); Iter++)
+                    {
+                        CopyOut(curColumn, Iter, InObjects[Iter]);
+                    }
+                }
+                else
+                {
+                    GatherStridedBytes((const uint8_t*)InObjects.data() + curColumn.Offset, 
+                        InObjects.size(), sizeof(T), curColumn.ElementSize, curColumn.Bytes.data());
+                }
+            }
+        }
+
+        std::vector<T> ToVector() const
+        {
+            std::vector<T> oObjects(_size);
+            if (_size == 0)
+            {
+                return oObjects;
+            }
+
+            for (const auto& curColumn : _columns)
+            {
+                if (curColumn.bString)
+                {
+                    for (size_t Iter = 0; Iter < _size; Iter++)
+                    {
+                        *(std::string*)curColumn.ValueAddress(&oObjects[Iter]) = curColumn.Strings[Iter];
+                    }
+                }
+                else if (curColumn.Accessor)
+                {
+                    for (size_t Iter = 0; Iter < _size; Iter++)
+                    {
+                        std::memcpy(curColumn.ValueAddress(&oObjects[Iter]), curColumn.Bytes.data() + Iter * curColumn.ElementSize, curColumn.ElementSize);
+                    }
+                }
+                else
+                {
+                    ScatterStridedBytes((uint8_t*)oObjects.data() + curColumn.Offset, 
+                        _size, sizeof(T), curColumn.ElementSize, curColumn.Bytes.data());
+                }
+            }
+            return oObjects;
+        }
+    };
+}
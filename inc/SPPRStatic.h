@@ -0,0 +1,147 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include "SPPRTypeTraits.h"
+#include "SPPRHash.h"
+#include <string_view>
+#include <tuple>
+
+// Compile time description of a class, at namespace scope:
+//
+//  REFL_STATIC_START(PlayerFighters)
+//      RS_ADD_PROP(name)
+//      RS_ADD_PROP(health)
+//  REFL_STATIC_END
+//
+// the runtime class can then be registered from the same table with REFL_CLASS_START_STATIC
+
+#define REFL_STATIC_START(InClass)                              \
+    template<>                                                  \
+    struct SPP::static_reflection< InClass >                    \
+    {                                                           \
+        using _REF_CC = InClass;                                \
+        static constexpr bool enabled = true;                   \
+        static constexpr std::string_view name = #InClass;      \
+        static constexpr auto properties = std::tuple_cat( std::tuple<>()
+
+#define RS_ADD_PROP(InProp) \
+    , std::make_tuple( SPP::make_static_property( #InProp, &_REF_CC::InProp ) )
+
+#define REFL_STATIC_END ); };
+
+namespace SPP
+{
+    template<typename Class, typename Member>
+    struct static_property
+    {
+        using class_type = Class;
+        using member_type = Member;
+
+        std::string_view name;
+        Member Class::* pointer = nullptr;
+
+        constexpr Member& get(Class& InObject) const { return InObject.*pointer; }
+        constexpr const Member& get(const Class& InObject) const { return InObject.*pointer; }
+    };
+
+    template<typename Class, typename Member>
+    constexpr auto make_static_property(std::string_view InName, Member Class::* InPointer)
+    {
+        return static_property< Class, Member >{ InName, InPointer };
+    }
+
+    // specialized by REFL_STATIC_START
+    template<typename T>
+    struct static_reflection
+    {
+        static constexpr bool enabled = false;
+    };
+
+    template<typename T>
+    concept StaticReflected = static_reflection< std::remove_cv_t<T> >::enabled;
+
+    template<StaticReflected T>
+    constexpr size_t static_property_count()
+    {
+        return std::tuple_size_v< std::remove_cv_t< decltype(static_reflection< std::remove_cv_t<T> >::properties) > >;
+    }
+
+    // InFunc(name, member&) for every property in declaration order, unrolled at compile time
+    template<StaticReflected T, typename Func>
+    constexpr void for_each_property(T& InObject, Func&& InFunc)
+    {
+        std::apply([&](const auto&... InProps)
+        {
+            (InFunc(InProps.name, InProps.get(InObject)), ...);
+        }, static_reflection< std::remove_cv_t<T> >::properties);
+    }
+
+    // InFunc(static_property) without an object
+    template<StaticReflected T, typename Func>
+    constexpr void for_each_static_property(Func&& InFunc)
+    {
+        std::apply([&](const auto&... InProps)
+        {
+            (InFunc(InProps), ...);
+        }, static_reflection< std::remove_cv_t<T> >::properties);
+    }
+
+    // Member by member hash for statically described types, everything inlines.
+    // Values are chained per member so they differ from ReflectedStruct::Hash, which hashes merged blocks.
+    template<typename T>
+    inline uint64_t static_hash(const T& InValue, uint64_t InSeed = 0)
+    {
+        if constexpr (StaticReflected<T>)
+        {
+            for_each_property(InValue, [&](std::string_view, const auto& InMember)
+            {
+                InSeed = static_hash(InMember, InSeed);
+            });
+            return InSeed;
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            return HashBytes(InValue.data(), InValue.size(), HashValue((uint64_t)InValue.size(), InSeed));
+        }
+        else if constexpr (IsSTLVector<T>)
+        {
+            InSeed = HashValue((uint64_t)InValue.size(), InSeed);
+            if constexpr (std::is_arithmetic_v< typename T::value_type >)
+            {
+                return HashBytes(InValue.data(), InValue.size() * sizeof(typename T::value_type), InSeed);
+            }
+            else
+            {
+                for (const auto& curElement : InValue)
+                {
+                    InSeed = static_hash(curElement, InSeed);
+                }
+                return InSeed;
+            }
+        }
+        else
+        {
+            static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "static_hash: type has no static description");
+            return HashValue(InValue, InSeed);
+        }
+    }
+
+    template<typename T>
+    inline bool static_equals(const T& InA, const T& InB)
+    {
+        if constexpr (StaticReflected<T>)
+        {
+            return std::apply([&](const auto&... InProps)
+            {
+                return (static_equals(InProps.get(InA), InProps.get(InB)) && ...);
+            }, static_reflection<T>::properties);
+        }
+        else
+        {
+            return InA == InB;
+        }
+    }
+}
@@ -0,0 +1,145 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include "SPPRArchive.h"
+#include <cstdio>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+namespace SPP
+{
+    // where a StreamArchiveReader pulls its bytes from, called from the reader's own thread
+    class SPP_REFLECTION_API IArchiveSource
+    {
+    public:
+        virtual ~IArchiveSource() {}
+        // up to InMaxSize bytes, blocking until some are there, 0 at the end of the data, on an error or once cancelled
+        virtual size_t ReadSome(void* OutData, size_t InMaxSize) = 0;
+        // bytes left when the source knows (regular files)
+        virtual std::optional<uint64_t> GetSizeHint() const { return std::nullopt; }
+        // from another thread, wakes a blocked ReadSome and ends the data early
+        virtual void Cancel() {}
+        // a 0 from ReadSome was an error rather than the end
+        virtual bool HasFailed() const { return false; }
+    };
+
+    // stdio file, from the current position
+    class SPP_REFLECTION_API FileArchiveSource : public IArchiveSource
+    {
+        NO_COPY_ALLOWED(FileArchiveSource);
+
+    protected:
+        FILE* _file = nullptr;
+        bool _bOwned = false;
+        std::optional<uint64_t> _sizeHint;
+        std::atomic<bool> _bCancelled{ false };
+        bool _bFailed = false;
+
+    public:
+        FileArchiveSource(FILE* InFile, bool bInOwned = false);
+        ~FileArchiveSource();
+
+        // null if it can't be opened
+        static std::unique_ptr<FileArchiveSource> Open(const char* InPath);
+
+        virtual size_t ReadSome(void* OutData, size_t InMaxSize) override;
+        virtual std::optional<uint64_t> GetSizeHint() const override { return _sizeHint; }
+        // best effort, a read already inside fread finishes first
+        virtual void Cancel() override { _bCancelled = true; }
+        virtual bool HasFailed() const override { return _bFailed; }
+    };
+
+    // file descriptor: a file, pipe or socket, not closed. Non blocking descriptors are waited on, Cancel wakes the
+    // wait through a pipe of its own (between reads only on Windows).
+    class SPP_REFLECTION_API DescriptorArchiveSource : public IArchiveSource
+    {
+        NO_COPY_ALLOWED(DescriptorArchiveSource);
+
+    protected:
+        int _descriptor = -1;
+        std::optional<uint64_t> _sizeHint;
+        // read and write ends, -1 if the pipe couldn't be made
+        int _cancelPipe[2] = { -1, -1 };
+        std::atomic<bool> _bCancelled{ false };
+        bool _bFailed = false;
+
+    public:
+        DescriptorArchiveSource(int InDescriptor);
+        ~DescriptorArchiveSource();
+
+        virtual size_t ReadSome(void* OutData, size_t InMaxSize) override;
+        virtual std::optional<uint64_t> GetSizeHint() const override { return _sizeHint; }
+        virtual void Cancel() override;
+        virtual bool HasFailed() const override { return _bFailed; }
+    };
+
+    // Fixed size byte ring between a producer thread (Write, Close) and the reader, Write blocks while it's full.
+    class SPP_REFLECTION_API RingArchiveSource : public IArchiveSource
+    {
+        NO_COPY_ALLOWED(RingArchiveSource);
+
+    protected:
+        std::unique_ptr<uint8_t[]> _ring;
+        size_t _capacity = 0;
+        size_t _readPos = 0;
+        size_t _size = 0;
+        bool _bClosed = false;
+        std::mutex _lock;
+        std::condition_variable _changed;
+
+    public:
+        RingArchiveSource(size_t InCapacity = 256 * 1024);
+
+        void Write(const void* InData, size_t InSize);
+        // no more writes, the reader sees the end once the ring drains
+        void Close();
+
+        virtual size_t ReadSome(void* OutData, size_t InMaxSize) override;
+        virtual void Cancel() override { Close(); }
+    };
+
+    struct StreamReaderSettings
+    {
+        size_t ChunkSize = 64 * 1024;
+        // chunks read ahead of the decoder, memory held is (ChunkCount + 1) chunks whatever the archive size
+        size_t ChunkCount = 4;
+        // counts in the archive are checked against this when the source doesn't know its size, strings and arrays
+        // are still only allocated as their bytes arrive
+        uint64_t MaxArchiveSize = 1ull << 32;
+    };
+
+    struct StreamReaderStats
+    {
+        uint64_t BytesRead = 0;
+        size_t ChunksRead = 0;
+        // all chunk buffers, allocated up front
+        size_t BufferBytes = 0;
+        // times the decoder caught up with the read thread
+        size_t DecoderWaits = 0;
+    };
+
+    // BinaryArchiveReader over a source read in chunks on a second thread, so reading overlaps decoding and only
+    // a fixed number of chunks is ever held. The decoder keeps its place across chunks (values split by a chunk
+    // edge are joined in front of the next chunk), large strings and arrays are copied out chunk by chunk.
+    // Destroying the reader before the source ends cancels the source. A source error fails the reader.
+    class SPP_REFLECTION_API StreamArchiveReader : public BinaryArchiveReader
+    {
+        NO_COPY_ALLOWED(StreamArchiveReader);
+
+    protected:
+        struct Impl;
+        std::unique_ptr<Impl> _impl;
+
+        virtual bool Fetch(size_t InWanted) override;
+
+    public:
+        StreamArchiveReader(IArchiveSource& InSource, const StreamReaderSettings& InSettings = {});
+        ~StreamArchiveReader();
+
+        StreamReaderStats GetStats() const;
+    };
+}
@@ -0,0 +1,120 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX2__)
+    #define SPP_STRIDED_AVX2 1
+    #include <immintrin.h>
+#else
+    #define SPP_STRIDED_AVX2 0
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <xmmintrin.h>
+    #define SPP_PREFETCH(InAddr) _mm_prefetch((const char*)(InAddr), _MM_HINT_T0)
+#elif defined(__GNUC__) || defined(__clang__)
+    #define SPP_PREFETCH(InAddr) __builtin_prefetch((const void*)(InAddr))
+#else
+    #define SPP_PREFETCH(InAddr) ((void)0)
+#endif
+
+namespace SPP
+{
+    // how many objects ahead to prefetch when walking strided memory
+    static constexpr size_t StridedPrefetchDistance = 16;
+
+    // copy a value at a fixed stride (one object to the next) into a packed array
+    template<typename T>
+    void GatherStrided(const void* InFirst, size_t InCount, size_t InStride, T* OutValues)
+    {
+        auto curSrc = (const uint8_t*)InFirst;
+        size_t Iter = 0;
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (InStride == sizeof(T))
+            {
+                std::memcpy(OutValues, InFirst, InCount * sizeof(T));
+                return;
+            }
+
+#if SPP_STRIDED_AVX2
+            if constexpr (sizeof(T) == 4)
+            {
+                if (InStride <= INT32_MAX / 8)
+                {
+                    const int32_t stride = (int32_t)InStride;
+                    const __m256i offsets = _mm256_setr_epi32(0, stride, stride * 2, stride * 3, stride * 4, stride * 5, stride * 6, stride * 7);
+                    for (; Iter + 8 <= InCount; Iter += 8)
+                    {
+                        if (Iter + StridedPrefetchDistance < InCount)
+                        {
+                            SPP_PREFETCH(curSrc + (Iter + StridedPrefetchDistance) * InStride);
+                        }
+                        const __m256i values = _mm256_i32gather_epi32((const int*)(curSrc + Iter * InStride), offsets, 1);
+                        _mm256_storeu_si256((__m256i*)(OutValues + Iter), values);
+                    }
+                }
+            }
+            else if constexpr (sizeof(T) == 8)
+            {
+                if (InStride <= INT32_MAX / 4)
+                {
+                    const int32_t stride = (int32_t)InStride;
+                    const __m128i offsets = _mm_setr_epi32(0, stride, stride * 2, stride * 3);
+                    for (; Iter + 4 <= InCount; Iter += 4)
+                    {
+                        if (Iter + StridedPrefetchDistance < InCount)
+                        {
+                            SPP_PREFETCH(curSrc + (Iter + StridedPrefetchDistance) * InStride);
+                        }
+                        const __m256i values = _mm256_i32gather_epi64((const long long*)(curSrc + Iter * InStride), offsets, 1);
+                        _mm256_storeu_si256((__m256i*)(OutValues + Iter), values);
+                    }
+                }
+            }
+#endif
+        }
+
+        for (; Iter < InCount; Iter++)
+        {
+            if (Iter + StridedPrefetchDistance < InCount)
+            {
+                SPP_PREFETCH(curSrc + (Iter + StridedPrefetchDistance) * InStride);
+            }
+            OutValues[Iter] = *(const T*)(curSrc + Iter * InStride);
+        }
+    }
+
+    // inverse of GatherStrided, there is no AVX2 scatter so this is prefetch and scalar stores
+    template<typename T>
+    void ScatterStrided(void* InFirst, size_t InCount, size_t InStride, const T* InValues)
+    {
+        auto curDst = (uint8_t*)InFirst;
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (InStride == sizeof(T))
+            {
+                std::memcpy(InFirst, InValues, InCount * sizeof(T));
+                return;
+            }
+        }
+
+        for (size_t Iter = 0; Iter < InCount; Iter++)
+        {
+            if (Iter + StridedPrefetchDistance < InCount)
+            {
+                SPP_PREFETCH(curDst + (Iter + StridedPrefetchDistance) * InStride);
+            }
+            *(T*)(curDst + Iter * InStride) = InValues[Iter];
+        }
+    }
+}
@@ -0,0 +1,83 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#pragma once
+
+#include "SPPReflection.h"
+#include <chrono>
+
+namespace SPP
+{
+    struct TraversalBudget
+    {
+        // nodes (properties and array items) per slice, 0 is unlimited
+        size_t MaxNodes = 0;
+        // wall time per slice, 0 is unlimited
+        double MaxMilliseconds = 0;
+    };
+
+    // ReflectedStruct::Visit that can stop partway through and pick up again later (next frame).
+    // The cursor is an explicit stack of struct/property index and array/element index frames, addresses are 
+    // re-derived from the root at every resume so arrays may be resized between slices: removed elements are
+    // skipped (their open callbacks are closed), appended elements are visited. Unique pointers and other
+    // leaf properties are visited whole as one node. The root object itself has to stay alive.
+    class SPP_REFLECTION_API ReflectedTraversal
+    {
+    protected:
+        enum class EFrame : uint8_t
+        {
+            Struct,
+            Array
+        };
+
+        struct Frame
+        {
+            EFrame Type = EFrame::Struct;
+            // the property that led here, null for the root
+            ReflectedProperty* Property = nullptr;
+            // object holding Property, re-derived on resume
+            void* Owner = nullptr;
+
+            // struct frames, Struct is the visited struct and CurStruct walks its parents
+            ReflectedStruct* Struct = nullptr;
+            ReflectedStruct* CurStruct = nullptr;
+            size_t PropertyIdx = 0;
+
+            // array frames
+            size_t ElementIdx = 0;
+
+            void* GetValue() const { return Property ? Property->AccessValueAddress(Owner) : Owner; }
+        };
+
+        ReflectedStruct* _struct = nullptr;
+        void* _object = nullptr;
+        IVisitor* _visitor = nullptr;
+
+        std::vector< Frame > _stack;
+        bool _started = false;
+        size_t _nodesVisited = 0;
+
+        bool PushValue(ReflectedProperty* InProperty, void* InOwner);
+        void FinishChild(ReflectedProperty* InChildProperty);
+        void AbortTop();
+        void Refresh();
+        void StepStruct(Frame& InFrame);
+        void StepArray(Frame& InFrame);
+
+    public:
+        ReflectedTraversal() {}
+        ReflectedTraversal(ReflectedStruct* InStruct, void* InObject, IVisitor* InVisitor);
+
+        // start over, can be used to restart a finished traversal
+        void Reset(ReflectedStruct* InStruct, void* InObject, IVisitor* InVisitor);
+
+        // run until finished or the budget runs out, returns true when finished
+        bool Step(const TraversalBudget& InBudget = {});
+
+        bool IsDone() const { return _started && _stack.empty(); }
+        size_t GetNodesVisited() const { return _nodesVisited; }
+        // nesting of the cursor, 0 when not started or done
+        size_t GetDepth() const { return _stack.size(); }
+    };
+}
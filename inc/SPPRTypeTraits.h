@@ -10,6 +10,13 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <variant>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <bitset>
 
 namespace SPP
 {
@@ -35,6 +42,38 @@ namespace SPP
     };
 
 
+    // std::map, std::unordered_map, std::set, std::unordered_set
+    template <class T>
+    struct is_associative {
+        static constexpr bool value = false;
+    };
+    template <class K, class V, class C, class A>
+    struct is_associative<std::map<K, V, C, A> > {
+        static constexpr bool value = true;
+    };
+    template <class K, class V, class H, class E, class A>
+    struct is_associative<std::unordered_map<K, V, H, E, A> > {
+        static constexpr bool value = true;
+    };
+    template <class K, class C, class A>
+    struct is_associative<std::set<K, C, A> > {
+        static constexpr bool value = true;
+    };
+    template <class K, class H, class E, class A>
+    struct is_associative<std::unordered_set<K, H, E, A> > {
+        static constexpr bool value = true;
+    };
+
+    template <class T>
+    struct is_bitset {
+        static constexpr bool value = false;
+    };
+    template <size_t N>
+    struct is_bitset<std::bitset<N> > {
+        static constexpr bool value = true;
+        static constexpr size_t bit_count = N;
+    };
+
     template <class T>
     struct is_unique_ptr {
         static constexpr bool value = false;
@@ -44,13 +83,71 @@ namespace SPP
         static constexpr bool value = true;
     };
 
+    template <class T>
+    struct is_shared_ptr {
+        static constexpr bool value = false;
+    };
+    template <class T>
+    struct is_shared_ptr<std::shared_ptr<T> > {
+        static constexpr bool value = true;
+    };
+
+    template <class T>
+    struct is_optional {
+        static constexpr bool value = false;
+    };
+    template <class T>
+    struct is_optional<std::optional<T> > {
+        static constexpr bool value = true;
+    };
+
+    template <class T>
+    struct is_variant {
+        static constexpr bool value = false;
+    };
+    template <class ...T>
+    struct is_variant<std::variant<T...> > {
+        static constexpr bool value = true;
+    };
+
+
+    // values that can be hashed and compared as raw bytes: no padding, no addresses (not stable), 
+    // floats included (bitwise semantics)
+    template<typename T, typename Enable = void>
+    struct is_bitwise_comparable {
+        static constexpr bool value = false;
+    };
+    template<typename T>
+    struct is_bitwise_comparable<T, std::enable_if_t<std::is_object_v<T> && !std::is_pointer_v<T> && !std::is_member_pointer_v<T> > > {
+        static constexpr bool value = std::has_unique_object_representations_v<T> ||
+            (std::is_floating_point_v<T> && sizeof(T) <= sizeof(double));
+    };
 
     template <typename T>
     concept IsSTLVector = is_vector<T>::value;
 
+    template <typename T>
+    concept IsSTLAssociative = is_associative<T>::value;
+
+    template <typename T>
+    concept IsBitset = is_bitset<T>::value;
+
     template <typename T>
     concept IsUniquePtr = is_unique_ptr<T>::value;
 
+    template <typename T>
+    concept IsSharedPtr = is_shared_ptr<T>::value;
+
+    template <typename T>
+    concept IsOptional = is_optional<T>::value;
+
+    template <typename T>
+    concept IsVariant = is_variant<T>::value;
+
+    // single value wrappers a WrapManipulator handles, raw pointers are decided per property
+    template <typename T>
+    concept IsWrapper = IsUniquePtr<T> || IsSharedPtr<T> || IsOptional<T>;
+
     /////////////////////////////////////////////////////////////////////////////////////////
     // This trait will removes cv-qualifiers, pointers and reference from type T.
     template<typename T, typename Enable = void>
@@ -92,6 +189,24 @@ namespace SPP
         }
     };
 
+    template<typename T, typename Enable = void>
+    struct get_align_of
+    {
+        static constexpr std::size_t value()
+        {
+            return alignof(T);
+        }
+    };
+
+    template<typename T>
+    struct get_align_of<T, std::enable_if_t<std::is_same<T, void>::value || std::is_function<T>::value>>
+    {
+        static constexpr std::size_t value()
+        {
+            return 1;
+        }
+    };
+
     template<typename T>
     struct is_function_ptr : std::integral_constant<bool, std::is_pointer<T>::value&&
         std::is_function<std::remove_pointer<T>>::value>
@@ -24,6 +24,13 @@
 #include <functional>
 #include <memory>
 #include <array>
+#include <cstring>
+#include <algorithm>
+#include <span>
+#include <optional>
+#include <variant>
+#include <bit>
+#include <new>
 
 #if _WIN32 && !defined(SPP_REFLECTION_STATIC)
     #ifdef SPP_REFLECTION_EXPORT
@@ -35,8 +42,16 @@
     #define SPP_REFLECTION_API 
 #endif
 
+#include "SPPRArena.h"
+#include "SPPRInstrument.h"
 #include "SPPRDataManipulators.h"
 #include "SPPRTypeTraits.h"
+#include "SPPRHash.h"
+#include "SPPRPatch.h"
+#include "SPPRMemory.h"
+#include "SPPRLayout.h"
+#include "SPPRStrided.h"
+#include "SPPRStatic.h"
 
 #define TYPE_LIST(...) type_list<__VA_ARGS__>
 
@@ -49,7 +64,9 @@
     template<typename Class_Type>   \
     friend struct ClassBuilder;     \
     template <typename T>           \
-    friend struct TRegisterStruct;  
+    friend struct TRegisterStruct;  \
+    template <typename T>           \
+    friend struct ::SPP::static_reflection;
 
 #define ENABLE_VF_REFL \
     public: \
@@ -79,25 +96,52 @@
 #define RC_ADD_PROP_ACCESS(InProp, InAccess) \
     .property_access( InProp, &_REF_CC::InAccess )
 
+// RC_ADD_PROP_FLAGS(health, Replicated | SaveGame), names come from SPP::PropertyFlags
+#define RC_ADD_PROP_FLAGS(InProp, InFlags) \
+    .property( #InProp, &_REF_CC::InProp, []() { using namespace ::SPP::PropertyFlags; return (uint32_t)(InFlags); }() )
+
+// raw pointer the object owns (deletes), Clone makes its own copy
+#define RC_ADD_OWNED_PROP(InProp) \
+    .owned_property( #InProp, &_REF_CC::InProp )
+
+// C++ bitfield member (uint32_t bAlive : 1), located by setting it on a default constructed object
+#define RC_ADD_BITFIELD(InProp) \
+    .bitfield_property< decltype(_REF_CC::InProp) >( #InProp, [](_REF_CC& InObject, int64_t InValue) { InObject.InProp = (decltype(_REF_CC::InProp))InValue; } )
+
+// named bit range of an integer member, RC_ADD_BITS(Flags, bVisible, 3, 1)
+#define RC_ADD_BITS(InWord, InName, InShift, InWidth) \
+    .bit_property( #InName, &_REF_CC::InWord, InShift, InWidth )
+
+// attribute on the property added last, RC_PROP_ATTRIBUTE("Max", 100)
+#define RC_PROP_ATTRIBUTE(InName, InValue) \
+    .attribute( InName, InValue )
+
 #define RC_ADD_METHOD(InMethod) \
     .method( #InMethod, &_REF_CC::InMethod )
 
 #define RC_ADD_CONSTRUCTOR(...) \
     .constructor< __VA_ARGS__ >()
 
+// runtime class from the REFL_STATIC_START table, methods and constructors can still be chained on
+#define REFL_CLASS_START_STATIC(InClass)    \
+    {                                       \
+    using _REF_CC = InClass;                \
+    add_static_properties(build_class<_REF_CC>(#InClass))
+
 #define REFL_CLASS_END ; } \
 
 
 #define REFL_ENUM_START(InEnumType) \
     { \
         auto EnumCPP = get_type< InEnumType >(); \
+        MetadataScope _enumScope(EnumCPP.GetTypeData()); \
         auto newEnum = std::make_unique< EnumCollection >(); 
 
 #define RC_ENUM_VALUE(InEnumValue, InEnumString) \
-        newEnum->EnumValues.push_back({ #InEnumString, (int32_t)InEnumValue });
+        newEnum->EnumValues.push_back({ #InEnumString, (int64_t)InEnumValue });
 
 #define RC_ENUM_VALUE_V2(InEnumString, InEnumValue ) \
-        newEnum->EnumValues.push_back({ InEnumString, (int32_t)InEnumValue });
+        newEnum->EnumValues.push_back({ InEnumString, (int64_t)InEnumValue });
 
 #define REFL_ENUM_END \
         EnumCPP.GetTypeData()->enumCollection = std::move(newEnum); \
@@ -133,6 +177,8 @@ namespace SPP
 
     struct DataAllocation
     {
+        SPP_METADATA_ALLOCATED
+
         virtual void* Construct() = 0;
     };
 
@@ -154,14 +200,19 @@ namespace SPP
 
     struct EnumCollection
     {
-        std::vector< std::tuple< std::string, int32_t  > > EnumValues;
+        SPP_METADATA_ALLOCATED
+
+        MetadataVector< std::tuple< std::string, int64_t > > EnumValues;
     };
 
     struct SPP_REFLECTION_API type_data
     {        
-        std::string compile_time_name;
-        std::size_t get_sizeof;
-        std::size_t get_pointer_dimension;
+        SPP_METADATA_ALLOCATED
+
+        InternedName compile_time_name;
+        std::size_t get_sizeof = 0;
+        std::size_t get_alignof = 0;
+        std::size_t get_pointer_dimension = 0;
 
         union {
             struct {
@@ -178,19 +229,26 @@ namespace SPP
                 uint32_t is_reference : 1;
                 uint32_t is_lvalue_reference : 1;
                 uint32_t is_rvalue_reference : 1;
+                uint32_t is_trivially_copyable : 1;
+                uint32_t is_bitwise_comparable : 1;
             };
-            uint32_t is_values;
+            uint32_t is_values = 0;
         };
 
-        std::string runtime_defined_name;
+        InternedName runtime_defined_name;
         type_data* raw_type_data = nullptr;
 
         std::unique_ptr< struct DataAllocation > dataAllocation;
         std::unique_ptr< struct ArrayManipulator > arrayManipulator;
         std::unique_ptr< struct WrapManipulator > wrapManipulator;
+        std::unique_ptr< struct VariantManipulator > variantManipulator;
+        std::unique_ptr< struct MapManipulator > mapManipulator;
         std::unique_ptr< struct EnumCollection > enumCollection;
         std::unique_ptr< class ReflectedStruct > structureRef;
 
+        // handler slot for custom visited types, 0 until GetVisitKind is asked
+        uint32_t visit_kind = 0;
+
         bool operator==(const type_data& InValue) const
         {
             return
@@ -228,6 +286,8 @@ namespace SPP
         {
         }
 
+        CPPType& operator=(const CPPType& other) noexcept = default;
+
         type_data* GetTypeData() const
         {
             return _typeData;
@@ -344,32 +404,39 @@ namespace SPP
 
     SPP_REFLECTION_API CPPType get_type_by_name(const char* InString);
 
+    // small dense id per type, indexes IVisitor's handler table
+    SPP_REFLECTION_API uint32_t GetVisitKind(CPPType InType);
+
     template<typename T>
     std::unique_ptr<type_data> make_type_data()
     {
-        auto obj = std::unique_ptr<type_data>
-            (
-                new type_data
-                {
-                    get_type_name<T>(),
-                    get_size_of<T>::value(),
-                    pointer_count<T>::value,
-
-                    std::is_class_v<T>, //is_class
-                    std::is_enum_v<T>, //is_enum
-                    std::is_array_v<T>, //is_array
-                    std::is_const_v<T>, //is_const
-                    std::is_volatile_v<T>, //is_volatile
-                    std::is_pointer_v<T>, //is_pointer
-                    std::is_arithmetic_v<T>, //is_arithmetic
-                    std::is_function_v<T>, //is_function_pointer
-                    std::is_member_object_pointer_v<T>, //is_member_object_pointer
-                    std::is_member_function_pointer_v<T>, //is_member_function_pointer
-                    std::is_reference_v<T>, //is_reference
-                    std::is_lvalue_reference_v<T>, //is_lvalue_reference
-                    std::is_rvalue_reference_v<T> //is_rvalue_reference
-                }
-            );
+        // the type_data is counted against itself, not whichever type is being built
+        MetadataScope noOwnerScope(nullptr);
+        auto obj = std::unique_ptr<type_data>(new type_data());
+        obj->get_sizeof = get_size_of<T>::value();
+        obj->get_alignof = get_align_of<T>::value();
+        obj->get_pointer_dimension = pointer_count<T>::value;
+
+        obj->is_class = std::is_class_v<T>;
+        obj->is_enum = std::is_enum_v<T>;
+        obj->is_array = std::is_array_v<T>;
+        obj->is_const = std::is_const_v<T>;
+        obj->is_volatile = std::is_volatile_v<T>;
+        obj->is_pointer = std::is_pointer_v<T>;
+        obj->is_arithmetic = std::is_arithmetic_v<T>;
+        obj->is_function = std::is_function_v<T>;
+        obj->is_member_object_pointer = std::is_member_object_pointer_v<T>;
+        obj->is_member_function_pointer = std::is_member_function_pointer_v<T>;
+        obj->is_reference = std::is_reference_v<T>;
+        obj->is_lvalue_reference = std::is_lvalue_reference_v<T>;
+        obj->is_rvalue_reference = std::is_rvalue_reference_v<T>;
+        obj->is_trivially_copyable = std::is_trivially_copyable_v<T>;
+        obj->is_bitwise_comparable = is_bitwise_comparable<T>::value;
+
+        AddMetadataBytes(obj.get(), sizeof(type_data));
+        MetadataScope typeScope(obj.get());
+        // charged to this type when it's the first to intern the name
+        obj->compile_time_name = InternedName(get_type_name<T>());
 
         if constexpr (IsSTLVector<T>)
         {
@@ -377,12 +444,22 @@ namespace SPP
             obj->arrayManipulator = std::make_unique< TArrayManipulator< T > >();
         }
 
-        if constexpr (IsUniquePtr<T>)
+        if constexpr (IsWrapper<T>)
         {
             //element_type
             obj->wrapManipulator = std::make_unique< TWrapManipulator< T > >();
         }
 
+        if constexpr (IsSTLAssociative<T>)
+        {
+            obj->mapManipulator = std::make_unique< TMapManipulator< T > >();
+        }
+
+        if constexpr (IsVariant<T>)
+        {
+            obj->variantManipulator = std::make_unique< TVariantManipulator< T > >();
+        }
+
         if constexpr (!std::is_same_v<T, typename raw_type<T>::type >)
         {
             obj->raw_type_data = get_type<typename raw_type<T>::type>().GetTypeData();
@@ -394,42 +471,140 @@ namespace SPP
     class ReflectedStruct;
     class ReflectedProperty;
     
+    template<typename T>
+    struct visit_method_traits;
+
+    template<typename VisitorT, typename T>
+    struct visit_method_traits< void (VisitorT::*)(const ReflectedProperty&, T&) >
+    {
+        using visitor_type = VisitorT;
+        using value_type = T;
+    };
 
     struct IVisitor
     {
-        virtual bool EnterStructure(const ReflectedStruct& inValue) { return true; }
-        virtual void ExitStructure(const ReflectedStruct& inValue) {}
+        using VisitHandler = void(*)(IVisitor& InVisitor, const ReflectedProperty& InProperty, void* InValue);
+        // is InVisitor the visitor type the handler was bound for
+        using VisitorTypeCheck = bool(*)(IVisitor& InVisitor);
+
+    protected:
+        struct VisitHandlerEntry
+        {
+            VisitHandler Handler = nullptr;
+            VisitorTypeCheck IsBoundType = nullptr;
+            // checked on the first call, the visitor's type doesn't change after that
+            bool bChecked = false;
+        };
+
+        // indexed by GetVisitKind of the value type
+        std::vector< VisitHandlerEntry > _visitHandlers;
+
+        void SetVisitHandler(CPPType InType, VisitHandler InHandler, VisitorTypeCheck InTypeCheck)
+        {
+            auto visitKind = GetVisitKind(InType);
+            if (visitKind >= _visitHandlers.size())
+            {
+                _visitHandlers.resize(visitKind + 1);
+            }
+            _visitHandlers[visitKind] = { InHandler, InTypeCheck };
+        }
+
+        // route custom values of T to a method, BindVisitHandler<&MyVisitor::VisitObject>() in the constructor.
+        // virtual methods still dispatch to overrides.
+        template<auto InMethod>
+        void BindVisitHandler()
+        {
+            using traits = visit_method_traits< decltype(InMethod) >;
+
+            SetVisitHandler(get_type< typename traits::value_type >(), [](IVisitor& InVisitor, const ReflectedProperty& InProperty, void* InValue)
+            {
+                (static_cast<typename traits::visitor_type&>(InVisitor).*InMethod)(InProperty, *(typename traits::value_type*)InValue);
+            },
+            [](IVisitor& InVisitor)
+            {
+                return dynamic_cast<typename traits::visitor_type*>(&InVisitor) != nullptr;
+            });
+        }
+
+    public:
+        IVisitor() {}
+        // a copy (possibly sliced into another visitor type) checks its handlers again
+        IVisitor(const IVisitor& InOther) : _visitHandlers(InOther._visitHandlers)
+        {
+            for (auto& curEntry : _visitHandlers)
+            {
+                curEntry.bChecked = false;
+            }
+        }
+        IVisitor& operator=(const IVisitor& InOther)
+        {
+            _visitHandlers = InOther._visitHandlers;
+            for (auto& curEntry : _visitHandlers)
+            {
+                curEntry.bChecked = false;
+            }
+            return *this;
+        }
+        virtual ~IVisitor() {}
+
+        // called by TCustomProperty, no handler bound means the value is skipped
+        void VisitCustom(uint32_t InVisitKind, const ReflectedProperty& InProperty, void* InValue)
+        {
+            if (InVisitKind < _visitHandlers.size() && _visitHandlers[InVisitKind].Handler)
+            {
+                auto& curEntry = _visitHandlers[InVisitKind];
+                if (!curEntry.bChecked)
+                {
+                    // bound for another visitor type, the handler's static_cast would be undefined
+                    SE_ASSERT(curEntry.IsBoundType(*this));
+                    curEntry.bChecked = true;
+                }
+                curEntry.Handler(*this, InProperty, InValue);
+            }
+        }
 
-        virtual bool EnterProprety(const ReflectedProperty& inValue) { return true; }
-        virtual void ExitProprety(const ReflectedProperty& inValue) { }
+        virtual bool EnterStructure(const ReflectedStruct&) { return true; }
+        virtual void ExitStructure(const ReflectedStruct&) {}
+
+        virtual bool EnterProprety(const ReflectedProperty&) { return true; }
+        virtual void ExitProprety(const ReflectedProperty&) { }
 
         // ARRAY
-        virtual void BeginArray(const ReflectedProperty& inValue) { }
-        virtual void BeginArrayItem(size_t InIdx) { }
-        virtual void EndArrayItem(size_t InIdx) { }
-        virtual void EndArray(const ReflectedProperty& inValue) { }
+        virtual void BeginArray(const ReflectedProperty&) { }
+        virtual void BeginArrayItem(size_t) { }
+        virtual void EndArrayItem(size_t) { }
+        virtual void EndArray(const ReflectedProperty&) { }
+
+        // MAP, per entry the key then the value (sets have none), keys must not be changed
+        virtual void BeginMap(const ReflectedProperty&, size_t) { }
+        virtual void BeginMapEntry(size_t) { }
+        virtual void EndMapEntry(size_t) { }
+        virtual void EndMap(const ReflectedProperty&) { }
 
-        virtual bool DataTypeResolved(const CPPType& inValue) { return false; }    
+        virtual bool DataTypeResolved(const CPPType&) { return false; }    
 
         //
-        virtual void VisitValue(const ReflectedProperty& InProperty, uint8_t& InValue) {}
-        virtual void VisitValue(const ReflectedProperty& InProperty, uint16_t& InValue) {}
-        virtual void VisitValue(const ReflectedProperty& InProperty, uint32_t& InValue) {}
-        virtual void VisitValue(const ReflectedProperty& InProperty, uint64_t& InValue) {}
+        virtual void VisitValue(const ReflectedProperty&, uint8_t&) {}
+        virtual void VisitValue(const ReflectedProperty&, uint16_t&) {}
+        virtual void VisitValue(const ReflectedProperty&, uint32_t&) {}
+        virtual void VisitValue(const ReflectedProperty&, uint64_t&) {}
          
-        virtual void VisitValue(const ReflectedProperty& InProperty, int8_t& InValue) {}
-        virtual void VisitValue(const ReflectedProperty& InProperty, int16_t& InValue) {}
-        virtual void VisitValue(const ReflectedProperty& InProperty, int32_t& InValue) {}
-        virtual void VisitValue(const ReflectedProperty& InProperty, int64_t& InValue) {}
+        virtual void VisitValue(const ReflectedProperty&, int8_t&) {}
+        virtual void VisitValue(const ReflectedProperty&, int16_t&) {}
+        virtual void VisitValue(const ReflectedProperty&, int32_t&) {}
+        virtual void VisitValue(const ReflectedProperty&, int64_t&) {}
          
-        virtual void VisitValue(const ReflectedProperty& InProperty, float& InValue) {}
-        virtual void VisitValue(const ReflectedProperty& InProperty, double& InValue) {}
+        virtual void VisitValue(const ReflectedProperty&, float&) {}
+        virtual void VisitValue(const ReflectedProperty&, double&) {}
 
-        virtual void VisitValue(const ReflectedProperty& InProperty, std::string& InValue) {}
-        virtual void VisitValue(const ReflectedProperty& InProperty, Strumber& InValue) {}
-        virtual void VisitValue(const ReflectedProperty& InProperty, GUID& InValue) {}
+        virtual void VisitValue(const ReflectedProperty&, std::string&) {}
+        virtual void VisitValue(const ReflectedProperty&, Strumber&) {}
+        virtual void VisitValue(const ReflectedProperty&, GUID&) {}
 
-        virtual void VisitValue(const ReflectedProperty& InProperty, bool& InValue) {}
+        virtual void VisitValue(const ReflectedProperty&, bool&) {}
+
+        // PointerProperty, the pointee isn't entered (see ReflectedGraphWalker for following them)
+        virtual void VisitPointer(const ReflectedProperty&, void*&) {}
     };
 
     
@@ -440,14 +615,91 @@ namespace SPP
     // 
     ////////////////////////////////////////////
 
+    namespace PropertyFlags
+    {
+        enum EPropertyFlag : uint32_t
+        {
+            None = 0,
+            // runtime only, never saved or sent
+            Transient = 1 << 0,
+            SaveGame = 1 << 1,
+            Replicated = 1 << 2,
+            EditorOnly = 1 << 3,
+            ReadOnly = 1 << 4,
+            // hashed containers are walked sorted by key (Visit, Diff) so output is reproducible, costs a sort
+            DeterministicOrder = 1 << 5,
+
+            // free for the game to use
+            User0 = 1 << 16,
+            User1 = 1 << 17,
+            User2 = 1 << 18,
+            User3 = 1 << 19
+        };
+    }
+
+    static constexpr uint32_t PropertyFlagCount = 32;
+
+    using PropertyAttributeValue = std::variant< bool, int64_t, double, InternedName >;
+
+    enum class EPropertyKind : uint8_t
+    {
+        Int8, Int16, Int32, Int64,
+        UInt8, UInt16, UInt32, UInt64,
+        Float, Double,
+        Bool,
+        String,
+        Strumber,
+        GUID,
+        Enum,
+        Struct,
+        DynamicArray,
+        UniquePtr,
+        // raw pointer to a struct, not owned
+        Pointer,
+        // shared_ptr, optional, raw pointers to values, owned raw pointers (WrapProperty)
+        Wrapped,
+        Variant,
+        // map, unordered_map, set, unordered_set
+        Map,
+        // bit range of an integer word (BitfieldProperty), the value is the word
+        Bitfield,
+        // std::bitset (BitArrayProperty)
+        BitArray,
+        // anything else, only reachable through its virtual Visit
+        Custom
+    };
+
+    template<typename T>
+    constexpr EPropertyKind numeric_property_kind()
+    {
+        if constexpr (std::is_same_v<T, bool>) return EPropertyKind::Bool;
+        else if constexpr (std::is_same_v<T, float>) return EPropertyKind::Float;
+        else if constexpr (std::is_same_v<T, double>) return EPropertyKind::Double;
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            return sizeof(T) == 1 ? EPropertyKind::Int8 : sizeof(T) == 2 ? EPropertyKind::Int16 : sizeof(T) == 4 ? EPropertyKind::Int32 : EPropertyKind::Int64;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            return sizeof(T) == 1 ? EPropertyKind::UInt8 : sizeof(T) == 2 ? EPropertyKind::UInt16 : sizeof(T) == 4 ? EPropertyKind::UInt32 : EPropertyKind::UInt64;
+        }
+        else return EPropertyKind::Custom;
+    }
+
+    template<typename VisitorT>
+    inline void VisitStatic(ReflectedProperty* InProperty, EPropertyKind InKind, void* InValue, void* InOwner, VisitorT& InVisitor);
+
     class SPP_REFLECTION_API ReflectedProperty
     {
         BEFRIEND_REFL_STRUCTS
+        SPP_METADATA_ALLOCATED
 
     protected:
-        std::string _name;
+        InternedName _name;
         CPPType _type;
         size_t _propOffset = 0;
+        uint32_t _flags = 0;
+        MetadataVector< std::pair< InternedName, PropertyAttributeValue > > _attributes;
 
     public:
         ReflectedProperty(const std::string &InName, CPPType InType, size_t InOffset = 0) : _name(InName), _type(InType), _propOffset(InOffset) {}
@@ -456,9 +708,203 @@ namespace SPP
         const auto& GetName() const { return _name; }
         auto GetCPPType() const { return _type; }
         auto GetPropOffset() const { return _propOffset; }
+        auto GetFlags() const { return _flags; }
+        // all of InFlags set
+        bool HasFlags(uint32_t InFlags) const { return (_flags & InFlags) == InFlags; }
+
+        const PropertyAttributeValue* FindAttribute(std::string_view InName) const
+        {
+            for (const auto& curAttribute : _attributes)
+            {
+                if (curAttribute.first == InName)
+                {
+                    return &curAttribute.second;
+                }
+            }
+            return nullptr;
+        }
+
+        // numbers convert between integer and floating point, strings come back as std::string_view
+        template<typename T>
+        std::optional<T> GetAttribute(std::string_view InName) const
+        {
+            auto foundValue = FindAttribute(InName);
+            if (!foundValue)
+            {
+                return std::nullopt;
+            }
+
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                if (auto boolValue = std::get_if<bool>(foundValue)) return *boolValue;
+            }
+            else if constexpr (std::is_arithmetic_v<T>)
+            {
+                if (auto intValue = std::get_if<int64_t>(foundValue)) return (T)*intValue;
+                if (auto floatValue = std::get_if<double>(foundValue)) return (T)*floatValue;
+            }
+            else if constexpr (std::is_same_v<T, std::string_view>)
+            {
+                if (auto nameValue = std::get_if<InternedName>(foundValue)) return nameValue->view();
+            }
+            return std::nullopt;
+        }
         virtual const char* GetPropertyClass() const { return "UNSET"; }
-        virtual void Visit(void* InStruct, IVisitor* InVisitor) {}
-        virtual void LogOut(void* structAddr, int8_t Indent = 0) {}
+        // what the statically dispatched Visit<VisitorT> switches on
+        virtual EPropertyKind GetKind() const { return EPropertyKind::Custom; }
+        virtual void Visit(void*, IVisitor*) {}
+        virtual void LogOut(void*, int8_t = 0) {}
+
+        // value reached through a function instead of the offset
+        virtual bool IsAccessorBased() const { return false; }
+        // address of the value itself
+        virtual void* AccessValueAddress(void* InStruct) { return (uint8_t*)InStruct + _propOffset; }
+        // the element/target property of containers and wrappers
+        virtual ReflectedProperty* GetInner() const { return nullptr; }
+
+        // pull this property out of a run of objects into a packed buffer (column), InStride is the 
+        // distance between objects. Returns the count written, 0 on a type mismatch.
+        template<typename T>
+        size_t Gather(const void* InObjects, size_t InCount, size_t InStride, T* OutValues)
+        {
+            // bit ranges share their word, they have no value of their own at the offset
+            if (_type != get_type<T>() || GetKind() == EPropertyKind::Bitfield)
+            {
+                return 0;
+            }
+
+            if (IsAccessorBased())
+            {
+                auto curObject = (uint8_t*)InObjects;
+                for (size_t Iter = 0; Iter < InCount; Iter++, curObject += InStride)
+                {
+                    OutValues[Iter] = *(T*)AccessValueAddress(curObject);
+                }
+            }
+            else
+            {
+                GatherStrided((const uint8_t*)InObjects + _propOffset, InCount, InStride, OutValues);
+            }
+            return InCount;
+        }
+
+        // push a packed buffer back into the property of each object
+        template<typename T>
+        size_t Scatter(void* InObjects, size_t InCount, size_t InStride, const T* InValues)
+        {
+            // bit ranges share their word, they have no value of their own at the offset
+            if (_type != get_type<T>() || GetKind() == EPropertyKind::Bitfield)
+            {
+                return 0;
+            }
+
+            if (IsAccessorBased())
+            {
+                auto curObject = (uint8_t*)InObjects;
+                for (size_t Iter = 0; Iter < InCount; Iter++, curObject += InStride)
+                {
+                    *(T*)AccessValueAddress(curObject) = InValues[Iter];
+                }
+            }
+            else
+            {
+                ScatterStrided((uint8_t*)InObjects + _propOffset, InCount, InStride, InValues);
+            }
+            return InCount;
+        }
+
+        template<typename T, typename ObjectType>
+        size_t Gather(std::span<ObjectType> InObjects, T* OutValues)
+        {
+            return Gather(InObjects.data(), InObjects.size(), sizeof(ObjectType), OutValues);
+        }
+
+        template<typename T, typename ObjectType>
+        size_t Scatter(std::span<ObjectType> InObjects, const T* InValues)
+        {
+            return Scatter(InObjects.data(), InObjects.size(), sizeof(ObjectType), InValues);
+        }
+
+        // can this property be copied as raw bytes at its offset
+        virtual bool IsBlockCopyable() const
+        {
+            return _type.GetTypeData() && _type->is_trivially_copyable;
+        }
+
+        // deep copy from one structure to another, anything that isn't a block must override it
+        virtual void Clone(void* InSrcStruct, void* InDstStruct)
+        {
+            SE_ASSERT(IsBlockCopyable());
+            std::memcpy((uint8_t*)InDstStruct + _propOffset, (uint8_t*)InSrcStruct + _propOffset, _type->get_sizeof);
+        }
+
+        // can this property be hashed and compared as raw bytes at its offset
+        virtual bool IsBlockComparable() const
+        {
+            return _type.GetTypeData() && _type->is_bitwise_comparable;
+        }
+
+        // opaque properties (raw pointers, etc) don't contribute
+        virtual uint64_t Hash(void* InStruct, uint64_t InSeed)
+        {
+            if (IsBlockComparable())
+            {
+                return HashBytes((uint8_t*)InStruct + _propOffset, _type->get_sizeof, InSeed);
+            }
+            return InSeed;
+        }
+
+        virtual bool Equals(void* InStructA, void* InStructB)
+        {
+            if (IsBlockComparable())
+            {
+                return BytesEqual((uint8_t*)InStructA + _propOffset, (uint8_t*)InStructB + _propOffset, _type->get_sizeof);
+            }
+            return true;
+        }
+
+        // appends the edits turning A into B, a null A means B is new (diff against nothing)
+        virtual void Diff(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch)
+        {
+            if (!IsBlockCopyable())
+            {
+                return;
+            }
+
+            // Equals skips what isn't comparable (raw pointers), but Clone copies it so the patch must carry it
+            auto valueB = (uint8_t*)InStructB + _propOffset;
+            const bool bChanged = !InStructA || 
+                (IsBlockComparable() ? !Equals(InStructA, InStructB) : !BytesEqual((uint8_t*)InStructA + _propOffset, valueB, _type->get_sizeof));
+            if (bChanged)
+            {
+                InOutPatch.AddValue(this, valueB, _type->get_sizeof);
+            }
+        }
+
+        // address of the next hop of a patch path, InIndex is the element for arrays
+        virtual void* Navigate(void*, int32_t)
+        {
+            return nullptr;
+        }
+
+        // next hop by key (maps), the key as MapManipulator::EncodeKey bytes
+        virtual void* NavigateKey(void*, const uint8_t*, size_t)
+        {
+            return nullptr;
+        }
+
+        // adds what the value owns beyond its inline size (heap, nested padding), the inline size is the owner's
+        virtual void MeasureMemory(void*, MemoryUsage&) {}
+
+        virtual bool ApplyPatch(void* InStruct, const PatchEntry& InEntry, const uint8_t* InData)
+        {
+            if (InEntry.Op == EPatchOp::SetValue && IsBlockCopyable() && InEntry.ValueSize == _type->get_sizeof)
+            {
+                std::memcpy((uint8_t*)InStruct + _propOffset, InData, InEntry.ValueSize);
+                return true;
+            }
+            return false;
+        }
     };
 
     class SPP_REFLECTION_API StringProperty : public ReflectedProperty
@@ -484,7 +930,56 @@ namespace SPP
             SPP_LOG(LOG_REFLECTION, LOG_INFO, "%sString: %s", GetIndent(Indent), AccessValue(structAddr)->c_str());
         }
 
+        virtual void Clone(void* InSrcStruct, void* InDstStruct) override
+        {
+            *AccessValue(InDstStruct) = *AccessValue(InSrcStruct);
+        }
+
+        virtual uint64_t Hash(void* InStruct, uint64_t InSeed) override
+        {
+            const auto& value = *AccessValue(InStruct);
+            return HashBytes(value.data(), value.size(), HashValue((uint64_t)value.size(), InSeed));
+        }
+
+        virtual bool Equals(void* InStructA, void* InStructB) override
+        {
+            return *AccessValue(InStructA) == *AccessValue(InStructB);
+        }
+
+        virtual void Diff(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) override
+        {
+            if (!InStructA || !Equals(InStructA, InStructB))
+            {
+                const auto& value = *AccessValue(InStructB);
+                InOutPatch.AddValue(this, value.data(), value.size());
+            }
+        }
+
+        virtual bool ApplyPatch(void* InStruct, const PatchEntry& InEntry, const uint8_t* InData) override
+        {
+            if (InEntry.Op == EPatchOp::SetValue)
+            {
+                AccessValue(InStruct)->assign((const char*)InData, InEntry.ValueSize);
+                return true;
+            }
+            return false;
+        }
+
+        virtual void MeasureMemory(void* InStruct, MemoryUsage& InOutUsage) override
+        {
+            // anything past the small string buffer is its own allocation
+            static const size_t smallCapacity = std::string().capacity();
+
+            const auto& value = *AccessValue(InStruct);
+            if (value.capacity() > smallCapacity)
+            {
+                InOutUsage.HeapBytes += value.capacity() + 1;
+                InOutUsage.Allocations++;
+            }
+        }
+
         virtual const char* GetPropertyClass() const override { return "StringProperty"; }
+        virtual EPropertyKind GetKind() const override { return EPropertyKind::String; }
     };
 
     class SPP_REFLECTION_API StrumberProperty : public ReflectedProperty
@@ -510,7 +1005,36 @@ namespace SPP
             SPP_LOG(LOG_REFLECTION, LOG_INFO, "%sStrumber: %s", GetIndent(Indent), AccessValue(structAddr)->ToString().c_str());
         }
 
+        virtual void Clone(void* InSrcStruct, void* InDstStruct) override
+        {
+            *AccessValue(InDstStruct) = *AccessValue(InSrcStruct);
+        }
+
+        // has padding, so by member
+        virtual uint64_t Hash(void* InStruct, uint64_t InSeed) override
+        {
+            const auto& value = *AccessValue(InStruct);
+            return HashValue(value._number, HashValue(value._id, InSeed));
+        }
+
+        virtual bool Equals(void* InStructA, void* InStructB) override
+        {
+            const auto& valueA = *AccessValue(InStructA);
+            const auto& valueB = *AccessValue(InStructB);
+            return valueA._id == valueB._id && valueA._number == valueB._number;
+        }
+
+        // by member like Equals, padding bytes that differ aren't a change
+        virtual void Diff(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) override
+        {
+            if (!InStructA || !Equals(InStructA, InStructB))
+            {
+                InOutPatch.AddValue(this, AccessValue(InStructB), sizeof(Strumber));
+            }
+        }
+
         virtual const char* GetPropertyClass() const override { return "StrumberProperty"; }
+        virtual EPropertyKind GetKind() const override { return EPropertyKind::Strumber; }
     };
 
     class SPP_REFLECTION_API GUIDProperty : public ReflectedProperty
@@ -536,7 +1060,13 @@ namespace SPP
             SPP_LOG(LOG_REFLECTION, LOG_INFO, "%sGUID: %s", GetIndent(Indent), AccessValue(structAddr)->ToString().c_str());
         }
 
+        virtual void Clone(void* InSrcStruct, void* InDstStruct) override
+        {
+            *AccessValue(InDstStruct) = *AccessValue(InSrcStruct);
+        }
+
         virtual const char* GetPropertyClass() const override { return "GUIDProperty"; }
+        virtual EPropertyKind GetKind() const override { return EPropertyKind::GUID; }
     };
 
     template<typename T>
@@ -577,60 +1107,219 @@ namespace SPP
             SPP_LOG(LOG_REFLECTION, LOG_INFO, "%sNumber: %s", GetIndent(Indent), std::to_string(*AccessValue(structAddr)).c_str());
         }
 
-        virtual const char* GetPropertyClass() const override { return "TNumericalProperty"; }
-    };
+        virtual bool IsAccessorBased() const override
+        {
+            return (bool)_accessValue;
+        }
 
-    class SPP_REFLECTION_API EnumProperty : public ReflectedProperty
-    {
-    public:
-        EnumProperty(const std::string& InName, CPPType InType, size_t InOffset = 0) :
-            ReflectedProperty(InName, InType, InOffset) {}
+        virtual void* AccessValueAddress(void* InStruct) override
+        {
+            return AccessValue(InStruct);
+        }
 
-        virtual ~EnumProperty() {}
+        // accessor based values have no meaningful offset
+        virtual bool IsBlockCopyable() const override
+        {
+            return !_accessValue;
+        }
 
-        int32_t* AccessValue(void* structAddr)
+        virtual bool IsBlockComparable() const override
         {
-            return (int32_t*)((uint8_t*)structAddr + _propOffset);
+            return !_accessValue && ReflectedProperty::IsBlockComparable();
         }
 
-        virtual void Visit(void* InStruct, IVisitor* InVisitor)
+        virtual void Clone(void* InSrcStruct, void* InDstStruct) override
         {
-            auto& curValue = *AccessValue(InStruct);
+            *AccessValue(InDstStruct) = *AccessValue(InSrcStruct);
+        }
 
-            SE_ASSERT(_type.GetTypeData()->enumCollection);
+        virtual uint64_t Hash(void* InStruct, uint64_t InSeed) override
+        {
+            return HashValue(*AccessValue(InStruct), InSeed);
+        }
 
-            for (auto& pairs : _type.GetTypeData()->enumCollection->EnumValues)
+        virtual bool Equals(void* InStructA, void* InStructB) override
+        {
+            return BytesEqual(AccessValue(InStructA), AccessValue(InStructB), sizeof(T));
+        }
+
+        virtual void Diff(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) override
+        {
+            if (!InStructA || !Equals(InStructA, InStructB))
             {
-                if (curValue == std::get<1>(pairs))
-                {
-                    // visit as string
-                    InVisitor->VisitValue(*this, std::get<0>(pairs));   
-                    return;
-                }
+                InOutPatch.AddValue(this, AccessValue(InStructB), sizeof(T));
             }
-
-            // visit as number if no match?
-            InVisitor->VisitValue(*this, curValue);
         }
 
-        virtual void LogOut(void* structAddr, int8_t Indent = 0) override
+        virtual bool ApplyPatch(void* InStruct, const PatchEntry& InEntry, const uint8_t* InData) override
         {
-            auto curValue = *AccessValue(structAddr);
-
-            SE_ASSERT(_type.GetTypeData()->enumCollection);
-
-            for (const auto& pairs : _type.GetTypeData()->enumCollection->EnumValues)
+            if (InEntry.Op == EPatchOp::SetValue && InEntry.ValueSize == sizeof(T))
             {
-                if (curValue == std::get<1>(pairs))
-                {
-                    SPP_LOG(LOG_REFLECTION, LOG_INFO, "%sEnum Value: %s", GetIndent(Indent), std::get<0>(pairs).c_str());
-                }
+                std::memcpy(AccessValue(InStruct), InData, sizeof(T));
+                return true;
+            }
+            return false;
+        }
+
+        virtual const char* GetPropertyClass() const override { return "TNumericalProperty"; }
+        virtual EPropertyKind GetKind() const override { return numeric_property_kind<T>(); }
+    };
+
+    // enum of any underlying integer size, numbers not in the EnumCollection are visited as that integer type
+    class SPP_REFLECTION_API EnumProperty : public ReflectedProperty
+    {
+    protected:
+        bool _bSigned = true;
+
+    public:
+        EnumProperty(const std::string& InName, CPPType InType, size_t InOffset = 0, bool bInSigned = true) :
+            ReflectedProperty(InName, InType, InOffset), _bSigned(bInSigned) 
+        {
+            SE_ASSERT(std::has_single_bit(_type->get_sizeof) && _type->get_sizeof <= sizeof(int64_t));
+        }
+
+        virtual ~EnumProperty() {}
+
+        void* AccessValue(void* structAddr)
+        {
+            return (uint8_t*)structAddr + _propOffset;
+        }
+
+        bool IsSigned() const { return _bSigned; }
+
+        // InFunc gets the value as its underlying integer type, InValue is the enum itself
+        template<typename FuncT>
+        void VisitUnderlying(void* InValue, FuncT&& InFunc) const
+        {
+            switch (_type->get_sizeof)
+            {
+            case 1: if (_bSigned) InFunc(*(int8_t*)InValue); else InFunc(*(uint8_t*)InValue); break;
+            case 2: if (_bSigned) InFunc(*(int16_t*)InValue); else InFunc(*(uint16_t*)InValue); break;
+            case 4: if (_bSigned) InFunc(*(int32_t*)InValue); else InFunc(*(uint32_t*)InValue); break;
+            default: if (_bSigned) InFunc(*(int64_t*)InValue); else InFunc(*(uint64_t*)InValue); break;
+            }
+        }
+
+        int64_t GetValue(void* structAddr)
+        {
+            int64_t oValue = 0;
+            VisitUnderlying(AccessValue(structAddr), [&oValue](auto& InValue) { oValue = (int64_t)InValue; });
+            return oValue;
+        }
+
+        std::string* FindValueName(int64_t InValue) const
+        {
+            SE_ASSERT(_type.GetTypeData()->enumCollection);
+
+            for (auto& pairs : _type.GetTypeData()->enumCollection->EnumValues)
+            {
+                if (InValue == std::get<1>(pairs))
+                {
+                    return &std::get<0>(pairs);
+                }
+            }
+            return nullptr;
+        }
+
+        virtual void Visit(void* InStruct, IVisitor* InVisitor)
+        {
+            if (auto valueName = FindValueName(GetValue(InStruct)))
+            {
+                // visit as string
+                InVisitor->VisitValue(*this, *valueName);
+                return;
+            }
+
+            // visit as number if no match?
+            VisitUnderlying(AccessValue(InStruct), [&](auto& InValue) { InVisitor->VisitValue(*this, InValue); });
+        }
+
+        virtual void LogOut(void* structAddr, int8_t Indent = 0) override
+        {
+            if (auto valueName = FindValueName(GetValue(structAddr)))
+            {
+                SPP_LOG(LOG_REFLECTION, LOG_INFO, "%sEnum Value: %s", GetIndent(Indent), valueName->c_str());
+                return;
             }
 
             SPP_LOG(LOG_REFLECTION, LOG_INFO, "%sUnknown enum value", GetIndent(Indent));
         }
 
         virtual const char* GetPropertyClass() const override { return "EnumProperty"; }
+        virtual EPropertyKind GetKind() const override { return EPropertyKind::Enum; }
+    };
+
+    // leaf property of a type IVisitor has no VisitValue overload for. Visit hands the value to the handler 
+    // the visitor bound for T, an indexed call instead of a dynamic_cast on every visit.
+    template<typename T>
+    class TCustomProperty : public ReflectedProperty
+    {
+    protected:
+        uint32_t _visitKind = 0;
+
+    public:
+        TCustomProperty(const std::string& InName, CPPType InType, size_t InOffset = 0) :
+            ReflectedProperty(InName, InType, InOffset), _visitKind(GetVisitKind(get_type<T>())) {}
+        virtual ~TCustomProperty() {}
+
+        T* AccessValue(void* structAddr)
+        {
+            return (T*)AccessValueAddress(structAddr);
+        }
+
+        virtual void Visit(void* InStruct, IVisitor* InVisitor) override
+        {
+            InVisitor->VisitCustom(_visitKind, *this, AccessValueAddress(InStruct));
+        }
+
+        // the type's own copy when it isn't a block
+        virtual void Clone(void* InSrcStruct, void* InDstStruct) override
+        {
+            if constexpr (std::is_copy_assignable_v<T>)
+            {
+                *AccessValue(InDstStruct) = *AccessValue(InSrcStruct);
+            }
+            else
+            {
+                ReflectedProperty::Clone(InSrcStruct, InDstStruct);
+            }
+        }
+    };
+
+    // Raw pointer to a class type, not owned so Clone copies the address and Hash/Equals skip it.
+    // Subclasses can resolve the pointee's dynamic type for polymorphic hierarchies.
+    class SPP_REFLECTION_API PointerProperty : public ReflectedProperty
+    {
+    protected:
+        CPPType _pointeeType;
+
+    public:
+        PointerProperty(const std::string& InName, CPPType InType, CPPType InPointeeType, size_t InOffset = 0) :
+            ReflectedProperty(InName, InType, InOffset), _pointeeType(InPointeeType) {}
+        virtual ~PointerProperty() {}
+
+        void*& AccessValue(void* structAddr)
+        {
+            return *(void**)AccessValueAddress(structAddr);
+        }
+
+        // declared type
+        CPPType GetPointeeType() const { return _pointeeType; }
+        // actual type of a non null pointee, the declared type unless overridden
+        virtual CPPType ResolvePointeeType(void*) const { return _pointeeType; }
+
+        virtual void Visit(void* InStruct, IVisitor* InVisitor) override
+        {
+            InVisitor->VisitPointer(*this, AccessValue(InStruct));
+        }
+
+        virtual void LogOut(void* structAddr, int8_t Indent = 0) override
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "%sPOINTER: %s %p", GetIndent(Indent), _pointeeType->GetName().c_str(), AccessValue(structAddr));
+        }
+
+        virtual const char* GetPropertyClass() const override { return "PointerProperty"; }
+        virtual EPropertyKind GetKind() const override { return EPropertyKind::Pointer; }
     };
 
     class SPP_REFLECTION_API DynamicArrayProperty : public ReflectedProperty
@@ -685,53 +1374,1261 @@ namespace SPP
             }
         }
 
+        virtual void Clone(void* InSrcStruct, void* InDstStruct) override
+        {
+            SE_ASSERT(_type.GetTypeData()->arrayManipulator);
+            auto& arrayManip = *_type.GetTypeData()->arrayManipulator;
+
+            auto srcArrayAddr = AccessValue(InSrcStruct);
+            auto dstArrayAddr = AccessValue(InDstStruct);
+            auto totalSize = arrayManip.Size(srcArrayAddr);
+            arrayManip.Resize(dstArrayAddr, totalSize);
+
+            if (totalSize == 0)
+            {
+                return;
+            }
+
+            // contiguous elements, one copy for the whole run
+            if (_inner->IsBlockCopyable())
+            {
+                std::memcpy(arrayManip.Element(dstArrayAddr, 0), 
+                    arrayManip.Element(srcArrayAddr, 0), 
+                    totalSize * _inner->GetCPPType()->get_sizeof);
+                return;
+            }
+
+            for (size_t Iter = 0; Iter < totalSize; Iter++)
+            {
+                _inner->Clone(arrayManip.Element(srcArrayAddr, (int32_t)Iter), arrayManip.Element(dstArrayAddr, (int32_t)Iter));
+            }
+        }
+
+        virtual uint64_t Hash(void* InStruct, uint64_t InSeed) override
+        {
+            SE_ASSERT(_type.GetTypeData()->arrayManipulator);
+            auto& arrayManip = *_type.GetTypeData()->arrayManipulator;
+
+            auto arrayAddr = AccessValue(InStruct);
+            auto totalSize = arrayManip.Size(arrayAddr);
+            InSeed = HashValue((uint64_t)totalSize, InSeed);
+
+            if (totalSize == 0)
+            {
+                return InSeed;
+            }
+
+            if (_inner->IsBlockComparable())
+            {
+                return HashBytes(arrayManip.Element(arrayAddr, 0), totalSize * _inner->GetCPPType()->get_sizeof, InSeed);
+            }
+
+            for (size_t Iter = 0; Iter < totalSize; Iter++)
+            {
+                InSeed = _inner->Hash(arrayManip.Element(arrayAddr, (int32_t)Iter), InSeed);
+            }
+            return InSeed;
+        }
+
+        virtual bool Equals(void* InStructA, void* InStructB) override
+        {
+            SE_ASSERT(_type.GetTypeData()->arrayManipulator);
+            auto& arrayManip = *_type.GetTypeData()->arrayManipulator;
+
+            auto arrayAddrA = AccessValue(InStructA);
+            auto arrayAddrB = AccessValue(InStructB);
+            auto totalSize = arrayManip.Size(arrayAddrA);
+
+            if (totalSize != arrayManip.Size(arrayAddrB))
+            {
+                return false;
+            }
+            if (totalSize == 0)
+            {
+                return true;
+            }
+
+            if (_inner->IsBlockComparable())
+            {
+                return BytesEqual(arrayManip.Element(arrayAddrA, 0), 
+                    arrayManip.Element(arrayAddrB, 0), 
+                    totalSize * _inner->GetCPPType()->get_sizeof);
+            }
+
+            for (size_t Iter = 0; Iter < totalSize; Iter++)
+            {
+                if (!_inner->Equals(arrayManip.Element(arrayAddrA, (int32_t)Iter), arrayManip.Element(arrayAddrB, (int32_t)Iter)))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        virtual void Diff(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) override
+        {
+            SE_ASSERT(_type.GetTypeData()->arrayManipulator);
+            auto& arrayManip = *_type.GetTypeData()->arrayManipulator;
+
+            auto arrayAddrA = InStructA ? AccessValue(InStructA) : nullptr;
+            auto arrayAddrB = AccessValue(InStructB);
+            auto sizeA = arrayAddrA ? arrayManip.Size(arrayAddrA) : 0;
+            auto sizeB = arrayManip.Size(arrayAddrB);
+            auto sharedSize = std::min(sizeA, sizeB);
+
+            if (sizeA != sizeB)
+            {
+                InOutPatch.AddResize(this, sizeB);
+            }
+
+            // runs of changed (or new) elements become a single entry
+            if (_inner->IsBlockComparable())
+            {
+                auto elementSize = _inner->GetCPPType()->get_sizeof;
+                size_t Iter = 0;
+                while (Iter < sizeB)
+                {
+                    if (Iter < sharedSize && 
+                        BytesEqual(arrayManip.Element(arrayAddrA, (int32_t)Iter), arrayManip.Element(arrayAddrB, (int32_t)Iter), elementSize))
+                    {
+                        Iter++;
+                        continue;
+                    }
+
+                    const size_t runStart = Iter;
+                    while (Iter < sizeB && 
+                        (Iter >= sharedSize || 
+                            !BytesEqual(arrayManip.Element(arrayAddrA, (int32_t)Iter), arrayManip.Element(arrayAddrB, (int32_t)Iter), elementSize)))
+                    {
+                        Iter++;
+                    }
+
+                    InOutPatch.AddElements(this, (int32_t)runStart, Iter - runStart,
+                        arrayManip.Element(arrayAddrB, (int32_t)runStart), (Iter - runStart) * elementSize);
+                }
+                return;
+            }
+
+            for (size_t Iter = 0; Iter < sizeB; Iter++)
+            {
+                InOutPatch.PushPath(this, (int32_t)Iter);
+                _inner->Diff(Iter < sharedSize ? arrayManip.Element(arrayAddrA, (int32_t)Iter) : nullptr,
+                    arrayManip.Element(arrayAddrB, (int32_t)Iter), 
+                    InOutPatch);
+                InOutPatch.PopPath();
+            }
+        }
+
+        virtual void* Navigate(void* InStruct, int32_t InIndex) override
+        {
+            SE_ASSERT(_type.GetTypeData()->arrayManipulator);
+            auto& arrayManip = *_type.GetTypeData()->arrayManipulator;
+
+            auto arrayAddr = AccessValue(InStruct);
+            if (InIndex < 0 || (size_t)InIndex >= arrayManip.Size(arrayAddr))
+            {
+                return nullptr;
+            }
+            return arrayManip.Element(arrayAddr, InIndex);
+        }
+
+        virtual bool ApplyPatch(void* InStruct, const PatchEntry& InEntry, const uint8_t* InData) override
+        {
+            SE_ASSERT(_type.GetTypeData()->arrayManipulator);
+            auto& arrayManip = *_type.GetTypeData()->arrayManipulator;
+            auto arrayAddr = AccessValue(InStruct);
+
+            if (InEntry.Op == EPatchOp::Resize)
+            {
+                arrayManip.Resize(arrayAddr, InEntry.Count);
+                return true;
+            }
+            else if (InEntry.Op == EPatchOp::SetElements)
+            {
+                auto elementSize = _inner->GetCPPType()->get_sizeof;
+                if (InEntry.Count == 0 ||
+                    !_inner->IsBlockCopyable() ||
+                    InEntry.ValueSize != InEntry.Count * elementSize ||
+                    InEntry.Index < 0 ||
+                    InEntry.Index + InEntry.Count > arrayManip.Size(arrayAddr))
+                {
+                    return false;
+                }
+                std::memcpy(arrayManip.Element(arrayAddr, InEntry.Index), InData, InEntry.ValueSize);
+                return true;
+            }
+            return false;
+        }
+
+        virtual void MeasureMemory(void* InStruct, MemoryUsage& InOutUsage) override
+        {
+            SE_ASSERT(_type.GetTypeData()->arrayManipulator);
+            auto& arrayManip = *_type.GetTypeData()->arrayManipulator;
+
+            auto arrayAddr = AccessValue(InStruct);
+            const size_t arraySize = arrayManip.Size(arrayAddr);
+            const size_t arrayCapacity = arrayManip.Capacity(arrayAddr);
+            const size_t elementSize = _inner->GetCPPType()->get_sizeof;
+
+            if (arrayCapacity)
+            {
+                InOutUsage.HeapBytes += arrayCapacity * elementSize;
+                InOutUsage.WastedCapacityBytes += (arrayCapacity - arraySize) * elementSize;
+                InOutUsage.Allocations++;
+            }
+
+            if (!arraySize)
+            {
+                return;
+            }
+
+            // trivially copyable elements own nothing and pad the same way, measure one
+            if (_inner->IsBlockCopyable())
+            {
+                MemoryUsage elementUsage;
+                _inner->MeasureMemory(arrayManip.Element(arrayAddr, 0), elementUsage);
+                InOutUsage.PaddingBytes += elementUsage.PaddingBytes * arraySize;
+                return;
+            }
+
+            for (size_t Iter = 0; Iter < arraySize; Iter++)
+            {
+                _inner->MeasureMemory(arrayManip.Element(arrayAddr, (int32_t)Iter), InOutUsage);
+            }
+        }
+
         virtual const char* GetPropertyClass() const override { return "DynamicArrayProperty"; }
+        virtual EPropertyKind GetKind() const override { return EPropertyKind::DynamicArray; }
+        virtual ReflectedProperty* GetInner() const override { return _inner.get(); }
     };
 
-    class SPP_REFLECTION_API UniquePtrProperty : public ReflectedProperty
+    // unique_ptr, shared_ptr, optional and raw pointers (owned, or to plain values). The inner property is the
+    // wrapped value, reached through the manipulator's inline Has/Get. Exclusive wraps copy deep, shared_ptr
+    // shares on Clone and non owning pointers copy the address and are skipped by Hash/Equals.
+    class SPP_REFLECTION_API WrapProperty : public ReflectedProperty
     {
         BEFRIEND_REFL_STRUCTS
 
     protected:
         std::unique_ptr<ReflectedProperty> _inner;
+        WrapManipulator* _wrap = nullptr;
 
     public:
-        UniquePtrProperty(const std::string& InName, 
+        WrapProperty(const std::string& InName, 
             CPPType InType, 
+            WrapManipulator* InWrap,
             std::unique_ptr<ReflectedProperty> && InInner, 
             size_t InOffset = 0) :
-            ReflectedProperty(InName, InType, InOffset), _inner(std::move(InInner)) {}
-        virtual ~UniquePtrProperty() {}
+            ReflectedProperty(InName, InType, InOffset), _inner(std::move(InInner)), _wrap(InWrap) 
+        {
+            SE_ASSERT(_wrap);
+        }
+        virtual ~WrapProperty() {}
+
+        void* AccessValue(void* structAddr)
+        {
+            return (void*)((uint8_t*)structAddr + _propOffset);
+        }
+
+        WrapManipulator* GetWrap() const { return _wrap; }
+
+        virtual void Visit(void* InStruct, IVisitor* InVisitor)
+        {
+            if (auto wrappedValue = _wrap->Get(AccessValue(InStruct)))
+            {
+                _inner->Visit(wrappedValue, InVisitor);
+            }
+        }
+
+        virtual void LogOut(void* structAddr, int8_t Indent = 0) override
+        {
+            static const char* WrapNames[] = { "UNIQUE_PTR", "SHARED_PTR", "OPTIONAL", "OWNED_PTR", "PTR" };
+
+            if (auto wrappedValue = _wrap->Get(AccessValue(structAddr)))
+            {
+                SPP_LOG(LOG_REFLECTION, LOG_INFO, "%s%s: ", GetIndent(Indent), WrapNames[(uint8_t)_wrap->Kind]);
+                _inner->LogOut(wrappedValue);
+            }
+        }
+
+        // owned raw pointers are trivially copyable but must not be shared
+        virtual bool IsBlockCopyable() const override
+        {
+            return _wrap->Kind != EWrapKind::OwningPointer && ReflectedProperty::IsBlockCopyable();
+        }
+
+        virtual void Clone(void* InSrcStruct, void* InDstStruct) override
+        {
+            auto srcPtrAddr = AccessValue(InSrcStruct);
+            auto dstPtrAddr = AccessValue(InDstStruct);
+
+            if (_wrap->Assign(srcPtrAddr, dstPtrAddr))
+            {
+                return;
+            }
+
+            auto srcValue = _wrap->Get(srcPtrAddr);
+            if (!srcValue)
+            {
+                _wrap->Clear(dstPtrAddr);
+                return;
+            }
+
+            auto dstValue = _wrap->Get(dstPtrAddr);
+            if (!dstValue)
+            {
+                dstValue = _wrap->Construct(dstPtrAddr);
+            }
+            SE_ASSERT(dstValue);
+            _inner->Clone(srcValue, dstValue);
+        }
+
+        virtual uint64_t Hash(void* InStruct, uint64_t InSeed) override
+        {
+            if (!_wrap->IsOwning())
+            {
+                return InSeed;
+            }
+
+            auto wrappedValue = _wrap->Get(AccessValue(InStruct));
+            const uint8_t bValid = wrappedValue ? 1 : 0;
+            InSeed = HashValue(bValid, InSeed);
+            return bValid ? _inner->Hash(wrappedValue, InSeed) : InSeed;
+        }
+
+        virtual bool Equals(void* InStructA, void* InStructB) override
+        {
+            if (!_wrap->IsOwning())
+            {
+                return true;
+            }
+
+            auto valueA = _wrap->Get(AccessValue(InStructA));
+            auto valueB = _wrap->Get(AccessValue(InStructB));
+
+            // both empty, or the same shared value
+            if (valueA == valueB)
+            {
+                return true;
+            }
+            return valueA && valueB && _inner->Equals(valueA, valueB);
+        }
+
+        virtual void Diff(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) override
+        {
+            if (!_wrap->IsOwning())
+            {
+                ReflectedProperty::Diff(InStructA, InStructB, InOutPatch);
+                return;
+            }
+
+            void* valueA = InStructA ? _wrap->Get(AccessValue(InStructA)) : nullptr;
+            void* valueB = _wrap->Get(AccessValue(InStructB));
+
+            if (!valueB)
+            {
+                if (valueA)
+                {
+                    InOutPatch.AddClear(this);
+                }
+                return;
+            }
+
+            if (!valueA)
+            {
+                InOutPatch.AddConstruct(this);
+            }
+
+            InOutPatch.PushPath(this);
+            _inner->Diff(valueA, valueB, InOutPatch);
+            InOutPatch.PopPath();
+        }
+
+        virtual void* Navigate(void* InStruct, int32_t) override
+        {
+            return _wrap->Get(AccessValue(InStruct));
+        }
+
+        virtual bool ApplyPatch(void* InStruct, const PatchEntry& InEntry, const uint8_t* InData) override
+        {
+            if (InEntry.Op == EPatchOp::Construct)
+            {
+                return _wrap->Construct(AccessValue(InStruct)) != nullptr;
+            }
+            else if (InEntry.Op == EPatchOp::Clear)
+            {
+                _wrap->Clear(AccessValue(InStruct));
+                return true;
+            }
+            return ReflectedProperty::ApplyPatch(InStruct, InEntry, InData);
+        }
+
+        virtual void MeasureMemory(void* InStruct, MemoryUsage& InOutUsage) override
+        {
+            auto wrappedValue = _wrap->Get(AccessValue(InStruct));
+            if (!wrappedValue || !_wrap->IsOwning())
+            {
+                return;
+            }
+
+            // optionals are inline, the rest sized as the declared type (a shared value by each owner)
+            if (_wrap->Kind != EWrapKind::Optional)
+            {
+                InOutUsage.HeapBytes += _inner->GetCPPType()->get_sizeof;
+                InOutUsage.Allocations++;
+            }
+            _inner->MeasureMemory(wrappedValue, InOutUsage);
+        }
+
+        virtual const char* GetPropertyClass() const override { return "WrapProperty"; }
+        virtual EPropertyKind GetKind() const override { return _wrap->Kind == EWrapKind::UniquePtr ? EPropertyKind::UniquePtr : EPropertyKind::Wrapped; }
+        virtual ReflectedProperty* GetInner() const override { return _inner.get(); }
+    };
+
+    // std::variant, one inner property per alternative (at offset 0 of it), the active one does the work
+    class SPP_REFLECTION_API VariantProperty : public ReflectedProperty
+    {
+        BEFRIEND_REFL_STRUCTS
+
+    protected:
+        MetadataVector< std::unique_ptr<ReflectedProperty> > _alternatives;
+        VariantManipulator* _variant = nullptr;
+
+    public:
+        VariantProperty(const std::string& InName,
+            CPPType InType,
+            std::vector< std::unique_ptr<ReflectedProperty> >&& InAlternatives,
+            size_t InOffset = 0) :
+            ReflectedProperty(InName, InType, InOffset), 
+            _alternatives(std::make_move_iterator(InAlternatives.begin()), std::make_move_iterator(InAlternatives.end())), 
+            _variant(InType->variantManipulator.get())
+        {
+            SE_ASSERT(_variant);
+        }
+        virtual ~VariantProperty() {}
+
+        void* AccessValue(void* structAddr)
+        {
+            return (void*)((uint8_t*)structAddr + _propOffset);
+        }
+
+        size_t GetAlternativeCount() const { return _alternatives.size(); }
+        ReflectedProperty* GetAlternative(size_t InIndex) const { return _alternatives[InIndex].get(); }
+
+        // property of the active alternative and its value, null when valueless, InVariant is the variant itself
+        ReflectedProperty* GetActive(void* InVariant, void*& OutValue, size_t* OutIndex = nullptr) const
+        {
+            size_t activeIndex = 0;
+            OutValue = _variant->GetActive(InVariant, activeIndex);
+            if (OutIndex)
+            {
+                *OutIndex = activeIndex;
+            }
+            return OutValue ? _alternatives[activeIndex].get() : nullptr;
+        }
+
+        virtual void Visit(void* InStruct, IVisitor* InVisitor)
+        {
+            void* activeValue = nullptr;
+            if (auto activeProp = GetActive(AccessValue(InStruct), activeValue))
+            {
+                activeProp->Visit(activeValue, InVisitor);
+            }
+        }
+
+        virtual void LogOut(void* structAddr, int8_t Indent = 0) override
+        {
+            void* activeValue = nullptr;
+            size_t activeIndex = 0;
+            if (auto activeProp = GetActive(AccessValue(structAddr), activeValue, &activeIndex))
+            {
+                SPP_LOG(LOG_REFLECTION, LOG_INFO, "%sVARIANT: %zd", GetIndent(Indent), activeIndex);
+                activeProp->LogOut(activeValue, Indent + 1);
+            }
+        }
+
+        virtual void Clone(void* InSrcStruct, void* InDstStruct) override
+        {
+            if (IsBlockCopyable())
+            {
+                ReflectedProperty::Clone(InSrcStruct, InDstStruct);
+                return;
+            }
+
+            void* srcValue = nullptr;
+            size_t srcIndex = 0;
+            auto srcProp = GetActive(AccessValue(InSrcStruct), srcValue, &srcIndex);
+            if (!srcProp)
+            {
+                return;
+            }
+
+            void* dstValue = nullptr;
+            size_t dstIndex = 0;
+            GetActive(AccessValue(InDstStruct), dstValue, &dstIndex);
+            if (!dstValue || dstIndex != srcIndex)
+            {
+                dstValue = _variant->Emplace(AccessValue(InDstStruct), srcIndex);
+            }
+            SE_ASSERT(dstValue);
+            srcProp->Clone(srcValue, dstValue);
+        }
+
+        virtual uint64_t Hash(void* InStruct, uint64_t InSeed) override
+        {
+            void* activeValue = nullptr;
+            size_t activeIndex = 0;
+            auto activeProp = GetActive(AccessValue(InStruct), activeValue, &activeIndex);
+            InSeed = HashValue((uint64_t)activeIndex, InSeed);
+            return activeProp ? activeProp->Hash(activeValue, InSeed) : InSeed;
+        }
+
+        virtual bool Equals(void* InStructA, void* InStructB) override
+        {
+            void* valueA = nullptr, * valueB = nullptr;
+            size_t indexA = 0, indexB = 0;
+            auto activeProp = GetActive(AccessValue(InStructA), valueA, &indexA);
+            GetActive(AccessValue(InStructB), valueB, &indexB);
+
+            if (indexA != indexB || !valueA != !valueB)
+            {
+                return false;
+            }
+            return !activeProp || activeProp->Equals(valueA, valueB);
+        }
+
+        virtual void Diff(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) override
+        {
+            void* valueB = nullptr;
+            size_t indexB = 0;
+            auto activeProp = GetActive(AccessValue(InStructB), valueB, &indexB);
+            if (!activeProp)
+            {
+                return;
+            }
+
+            void* valueA = nullptr;
+            size_t indexA = 0;
+            if (InStructA)
+            {
+                GetActive(AccessValue(InStructA), valueA, &indexA);
+            }
+
+            // a different alternative is diffed against nothing
+            if (!valueA || indexA != indexB)
+            {
+                valueA = nullptr;
+                InOutPatch.AddConstruct(this, (int32_t)indexB);
+            }
+
+            InOutPatch.PushPath(this, (int32_t)indexB);
+            activeProp->Diff(valueA, valueB, InOutPatch);
+            InOutPatch.PopPath();
+        }
+
+        // the active alternative, only when it is InIndex
+        virtual void* Navigate(void* InStruct, int32_t InIndex) override
+        {
+            void* activeValue = nullptr;
+            size_t activeIndex = 0;
+            GetActive(AccessValue(InStruct), activeValue, &activeIndex);
+            return (int32_t)activeIndex == InIndex ? activeValue : nullptr;
+        }
+
+        virtual bool ApplyPatch(void* InStruct, const PatchEntry& InEntry, const uint8_t*) override
+        {
+            if (InEntry.Op == EPatchOp::Construct)
+            {
+                return InEntry.Index >= 0 && _variant->Emplace(AccessValue(InStruct), (size_t)InEntry.Index) != nullptr;
+            }
+            return false;
+        }
+
+        virtual void MeasureMemory(void* InStruct, MemoryUsage& InOutUsage) override
+        {
+            void* activeValue = nullptr;
+            if (auto activeProp = GetActive(AccessValue(InStruct), activeValue))
+            {
+                activeProp->MeasureMemory(activeValue, InOutUsage);
+            }
+        }
+
+        virtual const char* GetPropertyClass() const override { return "VariantProperty"; }
+        virtual EPropertyKind GetKind() const override { return EPropertyKind::Variant; }
+    };
+
+    // Per thread entry lists reused by map visits and compares, one per nesting level since a mapped value can hold
+    // another map. Lives outside MapProperty, exported classes can't have thread_local members.
+    class MapEntryScratch
+    {
+    private:
+        static std::vector< std::unique_ptr< std::vector< MapEntry > > >& GetBuffers(size_t*& OutDepth)
+        {
+            thread_local std::vector< std::unique_ptr< std::vector< MapEntry > > > tBuffers;
+            thread_local size_t tDepth = 0;
+            OutDepth = &tDepth;
+            return tBuffers;
+        }
+
+        size_t* _depth = nullptr;
+
+    public:
+        std::vector< MapEntry >& Entries;
+
+        MapEntryScratch() : Entries(Acquire(_depth)) {}
+        ~MapEntryScratch()
+        {
+            Entries.clear();
+            (*_depth)--;
+        }
+
+        MapEntryScratch(const MapEntryScratch&) = delete;
+        MapEntryScratch& operator=(const MapEntryScratch&) = delete;
+
+    private:
+        static std::vector< MapEntry >& Acquire(size_t*& OutDepth)
+        {
+            auto& buffers = GetBuffers(OutDepth);
+            if (*OutDepth == buffers.size())
+            {
+                buffers.push_back(std::make_unique< std::vector< MapEntry > >());
+            }
+            return *buffers[(*OutDepth)++];
+        }
+    };
+
+    // std::map, std::unordered_map, std::set and std::unordered_set. The key and value properties sit at offset 0
+    // of the key and mapped value, sets have no value property. Hash is order independent, with the
+    // DeterministicOrder flag hashed containers are also visited and diffed sorted by key.
+    class SPP_REFLECTION_API MapProperty : public ReflectedProperty
+    {
+        BEFRIEND_REFL_STRUCTS
+
+    protected:
+        std::unique_ptr<ReflectedProperty> _key;
+        std::unique_ptr<ReflectedProperty> _value;
+        MapManipulator* _map = nullptr;
+
+    public:
+        MapProperty(const std::string& InName,
+            CPPType InType,
+            std::unique_ptr<ReflectedProperty>&& InKey,
+            std::unique_ptr<ReflectedProperty>&& InValue,
+            size_t InOffset = 0) :
+            ReflectedProperty(InName, InType, InOffset), _key(std::move(InKey)), _value(std::move(InValue)), _map(InType->mapManipulator.get())
+        {
+            SE_ASSERT(_map);
+        }
+        virtual ~MapProperty() {}
+
+        void* AccessValue(void* structAddr)
+        {
+            return (void*)((uint8_t*)structAddr + _propOffset);
+        }
+
+        MapManipulator* GetMap() const { return _map; }
+        ReflectedProperty* GetKey() const { return _key.get(); }
+        // null for sets
+        ReflectedProperty* GetValue() const { return _value.get(); }
+
+        // entries of the container at InMap, sorted by key when asked and the container isn't already
+        void GetEntries(void* InMap, std::vector< MapEntry >& OutEntries, bool bInSorted) const
+        {
+            _map->GetEntries(InMap, OutEntries);
+            if (bInSorted && !_map->bOrdered && !_map->SortEntries(OutEntries))
+            {
+                SortByKeyHash(OutEntries);
+            }
+        }
+
+        // no ordering on the key type, its reflected hash is the next best stable order. Colliding hashes are
+        // ordered by their encoded key bytes so the order doesn't depend on the container's.
+        void SortByKeyHash(std::vector< MapEntry >& InOutEntries) const
+        {
+            std::vector< std::pair< uint64_t, MapEntry > > hashedEntries;
+            hashedEntries.reserve(InOutEntries.size());
+            for (const auto& curEntry : InOutEntries)
+            {
+                hashedEntries.push_back({ _key->Hash((void*)curEntry.Key, 0), curEntry });
+            }
+            std::sort(hashedEntries.begin(), hashedEntries.end(), [](const auto& InA, const auto& InB) { return InA.first < InB.first; });
+
+            std::vector< uint8_t > keyBytesA, keyBytesB;
+            for (size_t Iter = 0; Iter < hashedEntries.size(); )
+            {
+                size_t runEnd = Iter + 1;
+                while (runEnd < hashedEntries.size() && hashedEntries[runEnd].first == hashedEntries[Iter].first)
+                {
+                    runEnd++;
+                }
+                if (runEnd - Iter > 1 && _map->bEncodableKeys)
+                {
+                    std::sort(hashedEntries.begin() + Iter, hashedEntries.begin() + runEnd, [&](const auto& InA, const auto& InB)
+                    {
+                        _map->EncodeKey(InA.second.Key, keyBytesA);
+                        _map->EncodeKey(InB.second.Key, keyBytesB);
+                        return keyBytesA < keyBytesB;
+                    });
+                }
+                Iter = runEnd;
+            }
+
+            for (size_t Iter = 0; Iter < hashedEntries.size(); Iter++)
+            {
+                InOutEntries[Iter] = hashedEntries[Iter].second;
+            }
+        }
+
+        bool IsDeterministic() const { return (_flags & PropertyFlags::DeterministicOrder) != 0; }
+
+        virtual void Visit(void* InStruct, IVisitor* InVisitor)
+        {
+            auto mapAddr = AccessValue(InStruct);
+            MapEntryScratch entryScratch;
+            auto& mapEntries = entryScratch.Entries;
+            GetEntries(mapAddr, mapEntries, IsDeterministic());
+
+            InVisitor->BeginMap(*this, mapEntries.size());
+            for (size_t Iter = 0; Iter < mapEntries.size(); Iter++)
+            {
+                InVisitor->BeginMapEntry(Iter);
+                _key->Visit((void*)mapEntries[Iter].Key, InVisitor);
+                if (_value)
+                {
+                    _value->Visit(mapEntries[Iter].Value, InVisitor);
+                }
+                InVisitor->EndMapEntry(Iter);
+            }
+            InVisitor->EndMap(*this);
+        }
+
+        virtual void LogOut(void* structAddr, int8_t Indent = 0) override
+        {
+            std::vector< MapEntry > mapEntries;
+            GetEntries(AccessValue(structAddr), mapEntries, true);
+
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "%sMAP: size: %zd", GetIndent(Indent), mapEntries.size());
+            for (const auto& curEntry : mapEntries)
+            {
+                _key->LogOut((void*)curEntry.Key, Indent + 1);
+                if (_value)
+                {
+                    _value->LogOut(curEntry.Value, Indent + 2);
+                }
+            }
+        }
+
+        // sized from the source count up front, hashed containers rehash once
+        virtual void Clone(void* InSrcStruct, void* InDstStruct) override
+        {
+            auto srcMap = AccessValue(InSrcStruct);
+            auto dstMap = AccessValue(InDstStruct);
+
+            std::vector< MapEntry > srcEntries;
+            GetEntries(srcMap, srcEntries, false);
+
+            _map->Clear(dstMap);
+            _map->Reserve(dstMap, srcEntries.size());
+            for (const auto& curEntry : srcEntries)
+            {
+                auto dstValue = _map->FindOrAdd(dstMap, curEntry.Key);
+                if (_value)
+                {
+                    _value->Clone(curEntry.Value, dstValue);
+                }
+            }
+        }
+
+        virtual uint64_t Hash(void* InStruct, uint64_t InSeed) override
+        {
+            MapEntryScratch entryScratch;
+            auto& mapEntries = entryScratch.Entries;
+            GetEntries(AccessValue(InStruct), mapEntries, false);
+
+            // summed so container order doesn't matter
+            uint64_t entrySum = 0;
+            for (const auto& curEntry : mapEntries)
+            {
+                uint64_t entryHash = _key->Hash((void*)curEntry.Key, 0);
+                if (_value)
+                {
+                    entryHash = _value->Hash(curEntry.Value, entryHash);
+                }
+                entrySum += HashValue(entryHash, 0);
+            }
+            return HashValue(entrySum, HashValue((uint64_t)mapEntries.size(), InSeed));
+        }
+
+        virtual bool Equals(void* InStructA, void* InStructB) override
+        {
+            auto mapA = AccessValue(InStructA);
+            auto mapB = AccessValue(InStructB);
+            if (_map->Size(mapA) != _map->Size(mapB))
+            {
+                return false;
+            }
+
+            MapEntryScratch entryScratch;
+            auto& entriesA = entryScratch.Entries;
+            GetEntries(mapA, entriesA, false);
+            for (const auto& curEntry : entriesA)
+            {
+                auto valueB = _map->Find(mapB, curEntry.Key);
+                if (!valueB || (_value && !_value->Equals(curEntry.Value, valueB)))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Per key: erased keys, then added keys with a reserve ahead of them, then value edits. Keys have to
+        // encode as bytes (trivially copyable or strings), diffing any other map is an error.
+        virtual void Diff(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) override
+        {
+            SE_ASSERT(_map->bEncodableKeys);
+
+            void* mapA = InStructA ? AccessValue(InStructA) : nullptr;
+            auto mapB = AccessValue(InStructB);
+            const bool bSorted = IsDeterministic();
+
+            std::vector< uint8_t > keyBytes;
+            if (mapA)
+            {
+                std::vector< MapEntry > entriesA;
+                GetEntries(mapA, entriesA, bSorted);
+                for (const auto& curEntry : entriesA)
+                {
+                    if (!_map->Find(mapB, curEntry.Key))
+                    {
+                        _map->EncodeKey(curEntry.Key, keyBytes);
+                        InOutPatch.AddErase(this, keyBytes.data(), keyBytes.size());
+                    }
+                }
+            }
+
+            std::vector< MapEntry > entriesB;
+            GetEntries(mapB, entriesB, bSorted);
+
+            std::vector< std::pair< const MapEntry*, void* > > changedEntries;
+            size_t addedCount = 0;
+            for (const auto& curEntry : entriesB)
+            {
+                auto valueA = mapA ? _map->Find(mapA, curEntry.Key) : nullptr;
+                addedCount += valueA ? 0 : 1;
+                if (!valueA || (_value && !_value->Equals(valueA, curEntry.Value)))
+                {
+                    changedEntries.push_back({ &curEntry, valueA });
+                }
+            }
+
+            if (addedCount)
+            {
+                InOutPatch.AddResize(this, entriesB.size());
+            }
+
+            for (const auto& [curEntry, valueA] : changedEntries)
+            {
+                _map->EncodeKey(curEntry->Key, keyBytes);
+                if (!valueA)
+                {
+                    InOutPatch.AddConstructKey(this, keyBytes.data(), keyBytes.size());
+                }
+                if (_value)
+                {
+                    InOutPatch.PushKeyPath(this, keyBytes.data(), keyBytes.size());
+                    _value->Diff(valueA, curEntry->Value, InOutPatch);
+                    InOutPatch.PopPath();
+                }
+            }
+        }
+
+        virtual void* NavigateKey(void* InStruct, const uint8_t* InKey, size_t InKeySize) override
+        {
+            void* oValue = nullptr;
+            _map->DecodeKey(InKey, InKeySize, [&](const void* InKeyValue)
+            {
+                oValue = _map->Find(AccessValue(InStruct), InKeyValue);
+            });
+            return oValue;
+        }
+
+        virtual bool ApplyPatch(void* InStruct, const PatchEntry& InEntry, const uint8_t* InData) override
+        {
+            auto mapAddr = AccessValue(InStruct);
+            bool bApplied = false;
+
+            switch (InEntry.Op)
+            {
+            // a reserve ahead of the inserts
+            case EPatchOp::Resize:
+                _map->Reserve(mapAddr, InEntry.Count);
+                return true;
+            case EPatchOp::Construct:
+                return _map->DecodeKey(InData, InEntry.ValueSize, [&](const void* InKeyValue)
+                {
+                    bApplied = _map->FindOrAdd(mapAddr, InKeyValue) != nullptr;
+                }) && bApplied;
+            case EPatchOp::Erase:
+                return _map->DecodeKey(InData, InEntry.ValueSize, [&](const void* InKeyValue)
+                {
+                    bApplied = _map->Erase(mapAddr, InKeyValue);
+                }) && bApplied;
+            default:
+                return false;
+            }
+        }
+
+        virtual void MeasureMemory(void* InStruct, MemoryUsage& InOutUsage) override
+        {
+            auto mapAddr = AccessValue(InStruct);
+            _map->MeasureHeap(mapAddr, InOutUsage.HeapBytes, InOutUsage.Allocations);
+
+            std::vector< MapEntry > mapEntries;
+            GetEntries(mapAddr, mapEntries, false);
+            for (const auto& curEntry : mapEntries)
+            {
+                _key->MeasureMemory((void*)curEntry.Key, InOutUsage);
+                if (_value)
+                {
+                    _value->MeasureMemory(curEntry.Value, InOutUsage);
+                }
+            }
+        }
+
+        virtual const char* GetPropertyClass() const override { return "MapProperty"; }
+        virtual EPropertyKind GetKind() const override { return EPropertyKind::Map; }
+        // the mapped value, the key for sets
+        virtual ReflectedProperty* GetInner() const override { return _value ? _value.get() : _key.get(); }
+    };
+
+    // Bits [Shift, Shift + Width) of the 1, 2, 4 or 8 byte integer word at the offset: a C++ bitfield (RC_ADD_BITFIELD)
+    // or a named range of a flags member (RC_ADD_BITS). Words are read little endian. The properties sharing a word
+    // are grouped when the struct builds its plans, copy/compare/hash and Diff then move the word once under the
+    // combined mask, a fully described word becomes a plain block.
+    class SPP_REFLECTION_API BitfieldProperty : public ReflectedProperty
+    {
+        BEFRIEND_REFL_STRUCTS
+        friend class ReflectedStruct;
+
+    protected:
+        uint8_t _wordSize = 4;
+        uint8_t _shift = 0;
+        uint8_t _width = 1;
+        bool _bSigned = false;
+        // first property on the word, it carries the combined mask of all of them
+        BitfieldProperty* _wordLeader = nullptr;
+        uint64_t _wordMask = 0;
+
+    public:
+        BitfieldProperty(const std::string& InName, CPPType InType, size_t InWordOffset, uint8_t InWordSize, uint8_t InShift, uint8_t InWidth, bool bInSigned) :
+            ReflectedProperty(InName, InType, InWordOffset), _wordSize(InWordSize), _shift(InShift), _width(InWidth), _bSigned(bInSigned)
+        {
+            SE_ASSERT(InWordSize == 1 || InWordSize == 2 || InWordSize == 4 || InWordSize == 8);
+            SE_ASSERT(InWidth && InShift + InWidth <= InWordSize * 8);
+            _wordLeader = this;
+            _wordMask = GetMask();
+        }
+        virtual ~BitfieldProperty() {}
+
+        uint8_t GetWordSize() const { return _wordSize; }
+        uint8_t GetShift() const { return _shift; }
+        uint8_t GetWidth() const { return _width; }
+        bool IsSigned() const { return _bSigned; }
+        bool IsWordLeader() const { return _wordLeader == this; }
+        // every reflected bit of the word, on the leader
+        uint64_t GetWordMask() const { return _wordLeader->_wordMask; }
+
+        uint64_t GetMask() const
+        {
+            return (_width == 64 ? ~0ull : ((1ull << _width) - 1)) << _shift;
+        }
+
+        // the bytes of the word its reflected bits are in, the word can reach into the member before it (Itanium
+        // places bitfields in a base's tail padding) or past the last field, layout and memory reports use these
+        size_t GetUsedOffset() const { return _propOffset + std::countr_zero(GetWordMask()) / 8; }
+        size_t GetUsedSize() const
+        {
+            const uint64_t wordMask = GetWordMask();
+            return (63 - std::countl_zero(wordMask)) / 8 + 1 - std::countr_zero(wordMask) / 8;
+        }
+
+        uint64_t ReadWord(const void* InWord) const
+        {
+            uint64_t oWord = 0;
+            std::memcpy(&oWord, InWord, _wordSize);
+            return oWord;
+        }
+        void WriteWord(void* InWord, uint64_t InValue) const
+        {
+            std::memcpy(InWord, &InValue, _wordSize);
+        }
+
+        // InWord is the word address (AccessValueAddress), signed ranges come back sign extended
+        uint64_t GetBitsAt(const void* InWord) const
+        {
+            uint64_t oValue = (ReadWord(InWord) & GetMask()) >> _shift;
+            if (_bSigned && _width < 64 && (oValue >> (_width - 1)) & 1)
+            {
+                oValue |= ~0ull << _width;
+            }
+            return oValue;
+        }
+        void SetBitsAt(void* InWord, uint64_t InValue) const
+        {
+            const uint64_t rangeMask = GetMask();
+            WriteWord(InWord, (ReadWord(InWord) & ~rangeMask) | ((InValue << _shift) & rangeMask));
+        }
+
+        uint64_t GetBits(void* InStruct) const { return GetBitsAt((uint8_t*)InStruct + _propOffset); }
+        void SetBits(void* InStruct, uint64_t InValue) const { SetBitsAt((uint8_t*)InStruct + _propOffset, InValue); }
+
+        // bools for single bits, 64 bit integers otherwise, written back if the visitor changed it
+        template<typename VisitFunc>
+        void VisitBits(void* InWord, VisitFunc&& InFunc)
+        {
+            const uint64_t curBits = GetBitsAt(InWord);
+            uint64_t newBits = curBits;
+            if (_width == 1 && !_bSigned)
+            {
+                bool boolValue = curBits != 0;
+                InFunc(boolValue);
+                newBits = boolValue ? 1 : 0;
+            }
+            else if (_bSigned)
+            {
+                int64_t signedValue = (int64_t)curBits;
+                InFunc(signedValue);
+                newBits = (uint64_t)signedValue;
+            }
+            else
+            {
+                InFunc(newBits);
+            }
+
+            if (newBits != curBits)
+            {
+                SetBitsAt(InWord, newBits);
+            }
+        }
+
+        virtual void Visit(void* InStruct, IVisitor* InVisitor) override
+        {
+            VisitBits(AccessValueAddress(InStruct), [&](auto& InValue)
+            {
+                InVisitor->VisitValue(*this, InValue);
+            });
+        }
+
+        virtual void LogOut(void* structAddr, int8_t Indent = 0) override
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "%s%s: %lld (bits %d-%d)", GetIndent(Indent), _name.c_str(),
+                (long long)GetBits(structAddr), _shift, _shift + _width - 1);
+        }
+
+        // whole words go through the struct plans, these are for a property on its own
+        virtual bool IsBlockCopyable() const override { return false; }
+        virtual bool IsBlockComparable() const override { return false; }
+
+        virtual void Clone(void* InSrcStruct, void* InDstStruct) override
+        {
+            SetBits(InDstStruct, GetBits(InSrcStruct));
+        }
+
+        virtual uint64_t Hash(void* InStruct, uint64_t InSeed) override
+        {
+            return HashValue(GetBits(InStruct), InSeed);
+        }
+
+        virtual bool Equals(void* InStructA, void* InStructB) override
+        {
+            return GetBits(InStructA) == GetBits(InStructB);
+        }
+
+        // the leader sends the word's changed bits in one entry for the whole group
+        virtual void Diff(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) override
+        {
+            if (!IsWordLeader())
+            {
+                return;
+            }
+
+            const uint64_t wordB = ReadWord((uint8_t*)InStructB + _propOffset) & _wordMask;
+            if (!InStructA || (ReadWord((uint8_t*)InStructA + _propOffset) & _wordMask) != wordB)
+            {
+                InOutPatch.AddBits(this, wordB, _wordMask, _wordSize);
+            }
+        }
+
+        virtual bool ApplyPatch(void* InStruct, const PatchEntry& InEntry, const uint8_t* InData) override
+        {
+            if (InEntry.Op != EPatchOp::SetBits || InEntry.ValueSize != _wordSize)
+            {
+                return false;
+            }
+
+            auto wordAddr = (uint8_t*)InStruct + _propOffset;
+            const uint64_t entryMask = (uint64_t)InEntry.Count;
+            WriteWord(wordAddr, (ReadWord(wordAddr) & ~entryMask) | (ReadWord(InData) & entryMask));
+            return true;
+        }
+
+        virtual const char* GetPropertyClass() const override { return "BitfieldProperty"; }
+        virtual EPropertyKind GetKind() const override { return EPropertyKind::Bitfield; }
+    };
+
+    // std::bitset, a packed bool array. Bit i sits in byte i / 8 (the words of every standard library are little
+    // endian here), Diff sends the changed 64 bit words and Visit hands out words rather than single bools.
+    class SPP_REFLECTION_API BitArrayProperty : public ReflectedProperty
+    {
+    protected:
+        size_t _bitCount = 0;
+        size_t _byteCount = 0;
+
+    public:
+        BitArrayProperty(const std::string& InName, CPPType InType, size_t InBitCount, size_t InOffset = 0) :
+            ReflectedProperty(InName, InType, InOffset), _bitCount(InBitCount), _byteCount((InBitCount + 7) / 8)
+        {
+            SE_ASSERT(_byteCount <= InType->get_sizeof);
+        }
+        virtual ~BitArrayProperty() {}
+
+        uint8_t* AccessValue(void* structAddr)
+        {
+            return (uint8_t*)structAddr + _propOffset;
+        }
+
+        size_t GetBitCount() const { return _bitCount; }
+        size_t GetWordCount() const { return (_bitCount + 63) / 64; }
+
+        bool GetBit(void* InStruct, size_t InIndex)
+        {
+            SE_ASSERT(InIndex < _bitCount);
+            return (AccessValue(InStruct)[InIndex >> 3] >> (InIndex & 7)) & 1;
+        }
+        void SetBit(void* InStruct, size_t InIndex, bool bInValue)
+        {
+            SE_ASSERT(InIndex < _bitCount);
+            auto& curByte = AccessValue(InStruct)[InIndex >> 3];
+            curByte = bInValue ? (uint8_t)(curByte | (1u << (InIndex & 7))) : (uint8_t)(curByte & ~(1u << (InIndex & 7)));
+        }
+
+        // the last word is short when the bit count isn't a multiple of 64
+        size_t GetWordBytes(size_t InWordIndex) const
+        {
+            return std::min< size_t >(8, _byteCount - InWordIndex * 8);
+        }
+        uint64_t ReadWordAt(const uint8_t* InBits, size_t InWordIndex) const
+        {
+            uint64_t oWord = 0;
+            std::memcpy(&oWord, InBits + InWordIndex * 8, GetWordBytes(InWordIndex));
+            return oWord;
+        }
+        void WriteWordAt(uint8_t* InBits, size_t InWordIndex, uint64_t InWord) const
+        {
+            std::memcpy(InBits + InWordIndex * 8, &InWord, GetWordBytes(InWordIndex));
+        }
+
+        template<typename VisitFunc>
+        void VisitWords(void* InBitsAddr, VisitFunc&& InFunc)
+        {
+            auto bitsAddr = (uint8_t*)InBitsAddr;
+            for (size_t Iter = 0; Iter < GetWordCount(); Iter++)
+            {
+                const uint64_t curWord = ReadWordAt(bitsAddr, Iter);
+                uint64_t newWord = curWord;
+                InFunc(newWord);
+                if (newWord != curWord)
+                {
+                    // bits past the count stay clear, std::bitset relies on it
+                    if (Iter + 1 == GetWordCount() && (_bitCount & 63))
+                    {
+                        newWord &= (1ull << (_bitCount & 63)) - 1;
+                    }
+                    WriteWordAt(bitsAddr, Iter, newWord);
+                }
+            }
+        }
 
-        void* AccessValue(void* structAddr)
+        virtual void Visit(void* InStruct, IVisitor* InVisitor) override
         {
-            return (void*)((uint8_t*)structAddr + _propOffset);
+            InVisitor->BeginArray(*this);
+            size_t wordIndex = 0;
+            VisitWords(AccessValue(InStruct), [&](uint64_t& InWord)
+            {
+                InVisitor->BeginArrayItem(wordIndex);
+                InVisitor->VisitValue(*this, InWord);
+                InVisitor->EndArrayItem(wordIndex++);
+            });
+            InVisitor->EndArray(*this);
         }
 
-        virtual void Visit(void* InStruct, IVisitor* InVisitor)
+        virtual void LogOut(void* structAddr, int8_t Indent = 0) override
         {
-            SE_ASSERT(_type.GetTypeData()->wrapManipulator);
-            auto uniquePtrAddr = AccessValue(InStruct);
-            if (_type.GetTypeData()->wrapManipulator->IsValid(uniquePtrAddr))
+            std::string bitString(_bitCount, '0');
+            for (size_t Iter = 0; Iter < _bitCount; Iter++)
             {
-                _inner->Visit(_type.GetTypeData()->wrapManipulator->GetValue(uniquePtrAddr), InVisitor);
+                bitString[Iter] = GetBit(structAddr, Iter) ? '1' : '0';
             }
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "%s%s: %s", GetIndent(Indent), _name.c_str(), bitString.c_str());
         }
 
-        virtual void LogOut(void* structAddr, int8_t Indent = 0) override
+        // unused bits are kept clear so the whole storage copies and compares as bytes
+        virtual bool IsBlockComparable() const override { return true; }
+
+        virtual uint64_t Hash(void* InStruct, uint64_t InSeed) override
+        {
+            return HashBytes(AccessValue(InStruct), _byteCount, InSeed);
+        }
+
+        virtual bool Equals(void* InStructA, void* InStructB) override
+        {
+            return BytesEqual(AccessValue(InStructA), AccessValue(InStructB), _byteCount);
+        }
+
+        // runs of changed words, Index and Count in words
+        virtual void Diff(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) override
         {
-            SE_ASSERT(_type.GetTypeData()->wrapManipulator);
+            auto bitsB = AccessValue(InStructB);
+            if (!InStructA)
+            {
+                InOutPatch.AddElements(this, 0, GetWordCount(), bitsB, _byteCount);
+                return;
+            }
+
+            auto bitsA = AccessValue(InStructA);
+            const size_t wordCount = GetWordCount();
+            for (size_t Iter = 0; Iter < wordCount; )
+            {
+                if (ReadWordAt(bitsA, Iter) == ReadWordAt(bitsB, Iter))
+                {
+                    Iter++;
+                    continue;
+                }
 
-            auto uniquePtrAddr = AccessValue(structAddr);
+                size_t runEnd = Iter + 1;
+                while (runEnd < wordCount && ReadWordAt(bitsA, runEnd) != ReadWordAt(bitsB, runEnd))
+                {
+                    runEnd++;
+                }
+                InOutPatch.AddElements(this, (int32_t)Iter, runEnd - Iter, bitsB + Iter * 8, std::min(_byteCount, runEnd * 8) - Iter * 8);
+                Iter = runEnd;
+            }
+        }
 
-            if (_type.GetTypeData()->wrapManipulator->IsValid(uniquePtrAddr))
+        virtual bool ApplyPatch(void* InStruct, const PatchEntry& InEntry, const uint8_t* InData) override
+        {
+            if (InEntry.Op == EPatchOp::SetElements && InEntry.Index >= 0 && 
+                (size_t)InEntry.Index * 8 + InEntry.ValueSize <= _byteCount)
             {
-                SPP_LOG(LOG_REFLECTION, LOG_INFO, "%sUNIQUE_PTR: ", GetIndent(Indent));
-                _inner->LogOut(_type.GetTypeData()->wrapManipulator->GetValue(uniquePtrAddr));
+                std::memcpy(AccessValue(InStruct) + (size_t)InEntry.Index * 8, InData, InEntry.ValueSize);
+                return true;
             }
+            return ReflectedProperty::ApplyPatch(InStruct, InEntry, InData);
         }
 
-        virtual const char* GetPropertyClass() const override { return "UniquePtrProperty"; }
+        virtual const char* GetPropertyClass() const override { return "BitArrayProperty"; }
+        virtual EPropertyKind GetKind() const override { return EPropertyKind::BitArray; }
     };
 
 
@@ -759,13 +2656,14 @@ namespace SPP
     class SPP_REFLECTION_API ReflectedMethod
     {
         BEFRIEND_REFL_STRUCTS
+        SPP_METADATA_ALLOCATED
 
     protected:
-        std::string _name;
+        InternedName _name;
 
         CPPType _type;
         CPPType _returnType;
-        std::vector< CPPType > _propertyTypes;
+        MetadataVector< CPPType > _propertyTypes;
         std::function<void(void*, Argument&, const std::vector< Argument >&)> _method;
 
     public:
@@ -774,7 +2672,7 @@ namespace SPP
         const auto& GetArgTypes() const { return _propertyTypes; }
         const auto& GetReturnType() const { return _returnType; }
 
-        virtual void LogOut(void* structAddr, int8_t Indent = 0) {}
+        virtual void LogOut(void*, int8_t = 0) {}
     };
 
 
@@ -787,19 +2685,58 @@ namespace SPP
     class SPP_REFLECTION_API ReflectedStruct
     {
         BEFRIEND_REFL_STRUCTS
+        SPP_METADATA_ALLOCATED
         NO_COPY_ALLOWED(ReflectedStruct);
 
     protected:
         CPPType _type;
         ReflectedStruct* _parent = nullptr;
 
-        std::vector< std::unique_ptr<ReflectedProperty> > _properties;
-        std::vector< std::unique_ptr<ReflectedMethod> > _methods;
-        std::vector< std::unique_ptr<ReflectedMethod> > _constructors;
+        MetadataVector< std::unique_ptr<ReflectedProperty> > _properties;
+        MetadataVector< std::unique_ptr<ReflectedMethod> > _methods;
+        MetadataVector< std::unique_ptr<ReflectedMethod> > _constructors;
+
+        // precompiled steps, adjacent block properties are merged into one block (Property == nullptr), an integer
+        // word only partly described by bitfields is a block with the Mask of its reflected bits
+        struct PlanStep
+        {
+            size_t Offset = 0;
+            size_t Size = 0;
+            ReflectedProperty* Property = nullptr;
+            uint64_t Mask = 0;
+        };
+        // blocks are trivially copyable
+        MetadataVector< PlanStep > _copyPlan;
+        // blocks are bitwise comparable, never include padding
+        MetadataVector< PlanStep > _comparePlan;
+        // the plan is one unmasked block over the whole object, so the object can be taken as bytes. Unreflected
+        // members and bits keep it off, they never count whatever the layout.
+        bool _bWholeCopy = false;
+        bool _bWholeCompare = false;
+        // per flag bit, properties (parents included, Visit order) that have it
+        std::array< MetadataVector< ReflectedProperty* >, PropertyFlagCount > _flagProperties;
+
+        // every property with nested structs folded in, for Visit<VisitorT>
+        struct FlatStep
+        {
+            // value offset, or the owner's offset for accessor based properties
+            size_t Offset = 0;
+            ReflectedProperty* Property = nullptr;
+            EPropertyKind Kind = EPropertyKind::Custom;
+            bool Accessor = false;
+        };
+        MetadataVector< FlatStep > _flatLayout;
+
+        void BuildFlatLayout();
+
+        void BuildPlan(MetadataVector< PlanStep >& OutPlan, bool (ReflectedProperty::* InIsBlock)() const);
+        void BuildPlans();
 
     public:
         ReflectedStruct() {}
 
+        auto GetCPPType() const { return _type; }
+
         virtual void DumpLayout()
         {
             auto curStruct = this;
@@ -852,6 +2789,82 @@ namespace SPP
 
         void Visit(void* InStruct, struct IVisitor* InVisitor);
 
+        // Statically dispatched visit, instantiated per visitor type: a switch on the property kind over the
+        // flattened layout and direct (inlinable) calls to InVisitor.VisitValue(property, value&), only for the 
+        // value types VisitorT has an overload for. Enums are visited as their underlying integer type, no 
+        // structure callbacks.
+        template<typename VisitorT>
+        void Visit(void* InStruct, VisitorT& InVisitor) const
+        {
+            ReflectionScope visitScope(EReflectionCounter::Visit, this, nullptr, _type->GetName().c_str());
+            for (const auto& curStep : _flatLayout)
+            {
+                // the accessor owner, or the struct the offset property sits in
+                auto ownerAddr = (uint8_t*)InStruct + curStep.Offset - (curStep.Accessor ? 0 : curStep.Property->GetPropOffset());
+                auto valueAddr = curStep.Accessor ?
+                    curStep.Property->AccessValueAddress(ownerAddr) :
+                    (uint8_t*)InStruct + curStep.Offset;
+                VisitStatic(curStep.Property, curStep.Kind, valueAddr, ownerAddr, InVisitor);
+            }
+        }
+        const auto& GetFlatLayout() const { return _flatLayout; }
+
+        // by name, including parent classes
+        ReflectedProperty* FindProperty(std::string_view InName) const;
+        // all properties, own first then parent classes (same order as Visit)
+        void IterateProperties(const std::function< void(ReflectedProperty*) >& InFunc) const;
+
+        ReflectedStruct* GetParent() const { return _parent; }
+
+        // properties with a single flag, O(selected)
+        const MetadataVector< ReflectedProperty* >& GetPropertiesWithFlag(PropertyFlags::EPropertyFlag InFlag) const;
+        // properties with all of InFlags, walks the list of the rarest flag
+        void IteratePropertiesWithFlags(uint32_t InFlags, const std::function< void(ReflectedProperty*) >& InFunc) const;
+        // Visit restricted to the top level properties with all of InFlags
+        void VisitWithFlags(void* InStruct, struct IVisitor* InVisitor, uint32_t InFlags);
+        // own properties only, parent classes are reached through GetParent
+        size_t GetPropertyCount() const { return _properties.size(); }
+        ReflectedProperty* GetProperty(size_t InIdx) const { return _properties[InIdx].get(); }
+
+        // column access across an array of this struct, InStride of 0 means tightly packed (sizeof)
+        template<typename T>
+        size_t Gather(std::string_view InPropName, const void* InObjects, size_t InCount, T* OutValues, size_t InStride = 0) const
+        {
+            auto foundProp = FindProperty(InPropName);
+            return foundProp ? foundProp->Gather(InObjects, InCount, InStride ? InStride : _type->get_sizeof, OutValues) : 0;
+        }
+
+        template<typename T>
+        size_t Scatter(std::string_view InPropName, void* InObjects, size_t InCount, const T* InValues, size_t InStride = 0) const
+        {
+            auto foundProp = FindProperty(InPropName);
+            return foundProp ? foundProp->Scatter(InObjects, InCount, InStride ? InStride : _type->get_sizeof, InValues) : 0;
+        }
+
+        // inline size plus everything owned through strings, vectors and unique_ptrs, recursively
+        MemoryUsage MeasureMemory(void* InStruct) const;
+        // same without the inline size, for a struct held inside something else
+        void MeasureContents(void* InStruct, MemoryUsage& InOutUsage) const;
+        // inline bytes of one instance not covered by a reflected property (nested structs not included)
+        size_t GetPaddingBytes(void* InStruct) const;
+
+        // deep copy of all reflected properties from one existing instance to another
+        void Clone(void* InSrcStruct, void* InDstStruct) const;
+        const auto& GetCopyPlan() const { return _copyPlan; }
+        bool IsWholeCopy() const { return _bWholeCopy; }
+        bool IsWholeCompare() const { return _bWholeCompare; }
+
+        // structural hash, stable across processes (content only, raw pointers are skipped)
+        uint64_t Hash(void* InStruct, uint64_t InSeed = 0) const;
+        // structural equality, arithmetic values compare bitwise to stay consistent with Hash
+        bool Equals(void* InStructA, void* InStructB) const;
+
+        // property level edits turning A into B, sized by the change not the object
+        ReflectedPatch Diff(void* InStructA, void* InStructB) const;
+        void DiffInto(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) const;
+        // returns false if any entry could not be applied (object doesn't match the patch source)
+        bool Apply(void* InStruct, const ReflectedPatch& InPatch) const;
+
         template<typename Ret, typename ...Args>
         Ret Invoke(void* structAddr, const std::string& MethodName, Args&& ...args) const
         {
@@ -892,6 +2905,7 @@ namespace SPP
 
                             if (bValid)
                             {
+                                ReflectionScope invokeScope(EReflectionCounter::Invoke, method.get(), _type->GetName().c_str(), method->GetName().c_str());
                                 if constexpr (std::is_same<Ret, void>::value)
                                 {
                                     Argument returnArgument(get_type < void >(), nullptr);
@@ -913,6 +2927,14 @@ namespace SPP
                 curStruct = curStruct->_parent;
             }
 
+#if SPP_REFLECTION_INSTRUMENTATION
+            if (GetReflectionInstrumentMode())
+            {
+                auto failNs = GetInstrumentTimeNs();
+                RecordReflectionEvent(EReflectionCounter::OverloadMatchFail, this, _type->GetName().c_str(), MethodName.c_str(), failNs, failNs);
+            }
+#endif
+
             if constexpr (!std::is_same<Ret, void>::value)
             {
                 return {};
@@ -947,6 +2969,18 @@ namespace SPP
             return (void*)((uint8_t*)structAddr + _propOffset);
         }
 
+        // a block only when every byte is reflected, as the struct's own Clone/Equals would see it
+        virtual bool IsBlockCopyable() const override
+        {
+            auto refStruct = _type.GetTypeData() ? _type->structureRef.get() : nullptr;
+            return refStruct ? refStruct->IsWholeCopy() : ReflectedProperty::IsBlockCopyable();
+        }
+        virtual bool IsBlockComparable() const override
+        {
+            auto refStruct = _type.GetTypeData() ? _type->structureRef.get() : nullptr;
+            return refStruct ? refStruct->IsWholeCompare() : ReflectedProperty::IsBlockComparable();
+        }
+
         virtual void Visit(void* InStruct, IVisitor* InVisitor)
         {
             auto newOffset = AccessValue(InStruct);
@@ -966,9 +3000,211 @@ namespace SPP
             refStruct->LogOut(newOffset, Indent + 1);
         }
 
+        virtual void Clone(void* InSrcStruct, void* InDstStruct) override
+        {
+            if (IsBlockCopyable())
+            {
+                ReflectedProperty::Clone(InSrcStruct, InDstStruct);
+                return;
+            }
+
+            auto refStruct = _type.GetTypeData()->structureRef.get();
+            SE_ASSERT(refStruct);
+            refStruct->Clone(AccessValue(InSrcStruct), AccessValue(InDstStruct));
+        }
+
+        virtual uint64_t Hash(void* InStruct, uint64_t InSeed) override
+        {
+            if (IsBlockComparable())
+            {
+                return ReflectedProperty::Hash(InStruct, InSeed);
+            }
+
+            auto refStruct = _type.GetTypeData()->structureRef.get();
+            SE_ASSERT(refStruct);
+            return refStruct->Hash(AccessValue(InStruct), InSeed);
+        }
+
+        virtual bool Equals(void* InStructA, void* InStructB) override
+        {
+            if (IsBlockComparable())
+            {
+                return ReflectedProperty::Equals(InStructA, InStructB);
+            }
+
+            auto refStruct = _type.GetTypeData()->structureRef.get();
+            SE_ASSERT(refStruct);
+            return refStruct->Equals(AccessValue(InStructA), AccessValue(InStructB));
+        }
+
+        virtual void Diff(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) override
+        {
+            if (IsBlockComparable())
+            {
+                ReflectedProperty::Diff(InStructA, InStructB, InOutPatch);
+                return;
+            }
+
+            auto refStruct = _type.GetTypeData()->structureRef.get();
+            SE_ASSERT(refStruct);
+            InOutPatch.PushPath(this);
+            refStruct->DiffInto(InStructA ? AccessValue(InStructA) : nullptr, AccessValue(InStructB), InOutPatch);
+            InOutPatch.PopPath();
+        }
+
+        virtual void* Navigate(void* InStruct, int32_t) override
+        {
+            return AccessValue(InStruct);
+        }
+
+        virtual void MeasureMemory(void* InStruct, MemoryUsage& InOutUsage) override
+        {
+            auto refStruct = _type.GetTypeData()->structureRef.get();
+            SE_ASSERT(refStruct);
+            refStruct->MeasureContents(AccessValue(InStruct), InOutUsage);
+        }
+
         virtual const char* GetPropertyClass() const override { return "StructProperty"; }
+        virtual EPropertyKind GetKind() const override { return EPropertyKind::Struct; }
     };
 
+    template<typename T, typename VisitorT>
+    inline void VisitStaticLeaf(ReflectedProperty* InProperty, void* InValue, VisitorT& InVisitor)
+    {
+        if constexpr (requires(VisitorT& visitor, ReflectedProperty& property, T& value) { visitor.VisitValue(property, value); })
+        {
+            InVisitor.VisitValue(*InProperty, *(T*)InValue);
+        }
+    }
+
+    template<typename VisitorT>
+    void VisitStaticComposite(ReflectedProperty* InProperty, EPropertyKind InKind, void* InValue, void* InOwner, VisitorT& InVisitor);
+
+    // leaves inline into the caller's loop, containers go out of line. InOwner is what the property's offset or 
+    // accessor is relative to (the struct, the element, the wrapped value).
+    template<typename VisitorT>
+    inline void VisitStatic(ReflectedProperty* InProperty, EPropertyKind InKind, void* InValue, void* InOwner, VisitorT& InVisitor)
+    {
+        switch (InKind)
+        {
+        case EPropertyKind::Int8: VisitStaticLeaf<int8_t>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::Int16: VisitStaticLeaf<int16_t>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::Int32: VisitStaticLeaf<int32_t>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::Int64: VisitStaticLeaf<int64_t>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::UInt8: VisitStaticLeaf<uint8_t>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::UInt16: VisitStaticLeaf<uint16_t>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::UInt32: VisitStaticLeaf<uint32_t>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::UInt64: VisitStaticLeaf<uint64_t>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::Float: VisitStaticLeaf<float>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::Double: VisitStaticLeaf<double>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::Bool: VisitStaticLeaf<bool>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::String: VisitStaticLeaf<std::string>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::Strumber: VisitStaticLeaf<Strumber>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::GUID: VisitStaticLeaf<GUID>(InProperty, InValue, InVisitor); break;
+        case EPropertyKind::Enum:
+            static_cast<EnumProperty*>(InProperty)->VisitUnderlying(InValue, [&](auto& InUnderlying)
+            {
+                VisitStaticLeaf< std::remove_reference_t<decltype(InUnderlying)> >(InProperty, &InUnderlying, InVisitor);
+            });
+            break;
+        default: VisitStaticComposite(InProperty, InKind, InValue, InOwner, InVisitor); break;
+        }
+    }
+
+    template<typename VisitorT>
+    void VisitStaticComposite(ReflectedProperty* InProperty, EPropertyKind InKind, void* InValue, void* InOwner, VisitorT& InVisitor)
+    {
+        switch (InKind)
+        {
+        case EPropertyKind::Struct:
+        {
+            auto refStruct = InProperty->GetCPPType().GetTypeData()->structureRef.get();
+            SE_ASSERT(refStruct);
+            refStruct->Visit(InValue, InVisitor);
+            break;
+        }
+        case EPropertyKind::DynamicArray:
+        {
+            auto arrayManipulator = InProperty->GetCPPType().GetTypeData()->arrayManipulator.get();
+            auto innerProp = InProperty->GetInner();
+            const auto innerKind = innerProp->GetKind();
+            const size_t totalSize = arrayManipulator->Size(InValue);
+            if (!totalSize)
+            {
+                break;
+            }
+
+            // vectors are contiguous, one manipulator call for the base then a plain stride
+            auto firstElement = (uint8_t*)arrayManipulator->Element(InValue, 0);
+            const size_t elementSize = innerProp->GetCPPType()->get_sizeof;
+            for (size_t Iter = 0; Iter < totalSize; Iter++)
+            {
+                auto curElement = firstElement + Iter * elementSize;
+                VisitStatic(innerProp, innerKind, innerProp->AccessValueAddress(curElement), curElement, InVisitor);
+            }
+            break;
+        }
+        case EPropertyKind::UniquePtr:
+        case EPropertyKind::Wrapped:
+        {
+            if (auto wrappedValue = static_cast<WrapProperty*>(InProperty)->GetWrap()->Get(InValue))
+            {
+                auto innerProp = InProperty->GetInner();
+                VisitStatic(innerProp, innerProp->GetKind(), innerProp->AccessValueAddress(wrappedValue), wrappedValue, InVisitor);
+            }
+            break;
+        }
+        case EPropertyKind::Variant:
+        {
+            void* activeValue = nullptr;
+            if (auto activeProp = static_cast<VariantProperty*>(InProperty)->GetActive(InValue, activeValue))
+            {
+                VisitStatic(activeProp, activeProp->GetKind(), activeProp->AccessValueAddress(activeValue), activeValue, InVisitor);
+            }
+            break;
+        }
+        case EPropertyKind::Bitfield:
+            // InValue is the word
+            static_cast<BitfieldProperty*>(InProperty)->VisitBits(InValue, [&](auto& InBits)
+            {
+                VisitStaticLeaf< std::remove_reference_t<decltype(InBits)> >(InProperty, &InBits, InVisitor);
+            });
+            break;
+        case EPropertyKind::BitArray:
+            static_cast<BitArrayProperty*>(InProperty)->VisitWords(InValue, [&](uint64_t& InWord)
+            {
+                VisitStaticLeaf<uint64_t>(InProperty, &InWord, InVisitor);
+            });
+            break;
+        case EPropertyKind::Map:
+        {
+            auto mapProp = static_cast<MapProperty*>(InProperty);
+            auto keyProp = mapProp->GetKey();
+            auto valueProp = mapProp->GetValue();
+            const auto keyKind = keyProp->GetKind();
+            const auto valueKind = valueProp ? valueProp->GetKind() : EPropertyKind::Custom;
+
+            std::vector< MapEntry > mapEntries;
+            mapProp->GetEntries(InValue, mapEntries, mapProp->IsDeterministic());
+            for (const auto& curEntry : mapEntries)
+            {
+                VisitStatic(keyProp, keyKind, keyProp->AccessValueAddress((void*)curEntry.Key), (void*)curEntry.Key, InVisitor);
+                if (valueProp)
+                {
+                    VisitStatic(valueProp, valueKind, valueProp->AccessValueAddress(curEntry.Value), curEntry.Value, InVisitor);
+                }
+            }
+            break;
+        }
+        default:
+            if constexpr (std::is_base_of_v<IVisitor, VisitorT>)
+            {
+                InProperty->Visit(InOwner, &InVisitor);
+            }
+            break;
+        }
+    }
+
     template<typename T, typename U>
     constexpr size_t offsetOf(U T::* member)
     {
@@ -990,7 +3226,7 @@ namespace SPP
     {
         auto curType = get_type<T>();
         auto newProp = std::make_unique< TNumericalProperty<T> >(InName, curType, calcOffset);
-        return std::move(newProp);
+        return newProp;
     }
 
     template<typename T> requires (std::is_same_v<std::string, T>)
@@ -998,7 +3234,7 @@ namespace SPP
     {
         auto curType = get_type<T>();
         auto newProp = std::make_unique< StringProperty >(InName, curType, calcOffset);
-        return std::move(newProp);
+        return newProp;
     }
 
     template<typename T> requires (std::is_same_v<Strumber, T>)
@@ -1006,7 +3242,7 @@ namespace SPP
     {
         auto curType = get_type<T>();
         auto newProp = std::make_unique< StrumberProperty >(InName, curType, calcOffset);
-        return std::move(newProp);
+        return newProp;
     }
 
     template<typename T> requires (std::is_same_v<GUID, T>)
@@ -1014,16 +3250,15 @@ namespace SPP
     {
         auto curType = get_type<T>();
         auto newProp = std::make_unique< GUIDProperty >(InName, curType, calcOffset);
-        return std::move(newProp);
+        return newProp;
     }
 
     template<typename T> requires (std::is_enum_v<T>)
     std::unique_ptr< ReflectedProperty > CreatePropertyDirect(const char* InName, size_t calcOffset)
     {
-        static_assert(sizeof(T) == sizeof(int32_t));
         auto curType = get_type<T>();
-        auto newProp = std::make_unique< EnumProperty >(InName, curType, calcOffset);
-        return std::move(newProp);
+        auto newProp = std::make_unique< EnumProperty >(InName, curType, calcOffset, std::is_signed_v< std::underlying_type_t<T> >);
+        return newProp;
     }
 
     template<typename T>
@@ -1039,6 +3274,17 @@ namespace SPP
         return CreatePropertyDirect<T>(InName, calcOffset);
     }      
 
+    // pointers to classes, more constrained overloads (subsuming this concept) can pick a PointerProperty subclass
+    template<typename T>
+    concept C_ClassPointer = std::is_pointer_v<T> && std::is_class_v< std::remove_pointer_t<T> >;
+
+    template<typename T, typename ClassSet> requires (C_ClassPointer<T>)
+    std::unique_ptr< ReflectedProperty > CreateProperty(const char* InName, T ClassSet::* prop)
+    {
+        auto newProp = std::make_unique< PointerProperty >(InName, get_type<T>(), get_type< std::remove_pointer_t<T> >(), offsetOf(prop));
+        return newProp;
+    }
+
     template<typename T, typename ClassSet>
     std::unique_ptr< ReflectedProperty > CreateProperty(const char* InName, std::vector<T> ClassSet::* prop)
     {
@@ -1050,21 +3296,90 @@ namespace SPP
         };
 
         auto newProp = std::make_unique< DynamicArrayProperty >(InName, arraytype, CreateProperty("inner", &Dummy::inner), offsetOf(prop));
-        return std::move(newProp);
+        return newProp;
     }
 
-    template<typename T, typename ClassSet>
-    std::unique_ptr< ReflectedProperty > CreateProperty(const char* InName, std::unique_ptr<T> ClassSet::* prop)
+    // the value held by a wrapper, described as a property at offset 0 of it
+    template<typename T>
+    std::unique_ptr< ReflectedProperty > CreateInnerProperty()
+    {
+        if constexpr (std::is_same_v<T, std::monostate>)
+        {
+            return std::make_unique< ReflectedProperty >("inner", get_type<T>());
+        }
+        else
+        {
+            struct Dummy
+            {
+                T inner;
+            };
+            return CreateProperty("inner", &Dummy::inner);
+        }
+    }
+
+    template<typename T, typename ClassSet> requires (IsWrapper<T>)
+    std::unique_ptr< ReflectedProperty > CreateProperty(const char* InName, T ClassSet::* prop)
     {
-        auto propType = get_type< std::unique_ptr<T> >();
+        auto propType = get_type<T>();
+        using element_type = typename TWrapManipulator<T>::element_type;
 
-        struct Dummy
+        auto newProp = std::make_unique< WrapProperty >(InName, propType, propType->wrapManipulator.get(), CreateInnerProperty<element_type>(), offsetOf(prop));
+        return newProp;
+    }
+
+    // raw pointers to plain values, not owned, class pointers are PointerProperty
+    template<typename T>
+    concept C_ValuePointer = std::is_pointer_v<T> && 
+        (std::is_arithmetic_v< std::remove_pointer_t<T> > || std::is_enum_v< std::remove_pointer_t<T> >) && 
+        !std::is_const_v< std::remove_pointer_t<T> >;
+
+    template<typename T, typename ClassSet> requires (C_ValuePointer<T>)
+    std::unique_ptr< ReflectedProperty > CreateProperty(const char* InName, T ClassSet::* prop)
+    {
+        static TWrapManipulator< T, EWrapKind::Pointer > sWrap;
+        auto newProp = std::make_unique< WrapProperty >(InName, get_type<T>(), &sWrap, CreateInnerProperty< std::remove_pointer_t<T> >(), offsetOf(prop));
+        return newProp;
+    }
+
+    // raw pointer the holder deletes, added with RC_ADD_OWNED_PROP
+    template<typename T, typename ClassSet> requires (std::is_pointer_v<T>)
+    std::unique_ptr< ReflectedProperty > CreateOwnedProperty(const char* InName, T ClassSet::* prop)
+    {
+        static TWrapManipulator< T, EWrapKind::OwningPointer > sWrap;
+        auto newProp = std::make_unique< WrapProperty >(InName, get_type<T>(), &sWrap, CreateInnerProperty< std::remove_pointer_t<T> >(), offsetOf(prop));
+        return newProp;
+    }
+
+    template<typename T, typename ClassSet> requires (IsBitset<T>)
+    std::unique_ptr< ReflectedProperty > CreateProperty(const char* InName, T ClassSet::* prop)
+    {
+        return std::make_unique< BitArrayProperty >(InName, get_type<T>(), is_bitset<T>::bit_count, offsetOf(prop));
+    }
+
+    template<typename T, typename ClassSet> requires (IsSTLAssociative<T>)
+    std::unique_ptr< ReflectedProperty > CreateProperty(const char* InName, T ClassSet::* prop)
+    {
+        std::unique_ptr< ReflectedProperty > valueProp;
+        if constexpr (!std::is_same_v< typename T::key_type, typename T::value_type >)
         {
-            T inner;
-        };
+            valueProp = CreateInnerProperty< typename T::mapped_type >();
+        }
+
+        auto newProp = std::make_unique< MapProperty >(InName, get_type<T>(), CreateInnerProperty< typename T::key_type >(), std::move(valueProp), offsetOf(prop));
+        return newProp;
+    }
+
+    template<typename T, typename ClassSet> requires (IsVariant<T>)
+    std::unique_ptr< ReflectedProperty > CreateProperty(const char* InName, T ClassSet::* prop)
+    {
+        std::vector< std::unique_ptr<ReflectedProperty> > alternatives;
+        [&alternatives]<size_t ...Is>(std::index_sequence<Is...>)
+        {
+            (alternatives.push_back(CreateInnerProperty< std::variant_alternative_t<Is, T> >()), ...);
+        }(std::make_index_sequence< std::variant_size_v<T> >{});
 
-        auto newProp = std::make_unique< UniquePtrProperty >(InName, propType, CreateProperty("inner", &Dummy::inner), offsetOf(prop));
-        return std::move(newProp);
+        auto newProp = std::make_unique< VariantProperty >(InName, get_type<T>(), std::move(alternatives), offsetOf(prop));
+        return newProp;
     }
 
     template<typename T, typename ClassSet>
@@ -1083,12 +3398,14 @@ namespace SPP
         auto calcOffset = offsetOf(prop);
         auto curType = get_type<T>();
         auto newProp = std::make_unique< StructProperty >(InName, curType, calcOffset);
-        return std::move(newProp);
+        return newProp;
     }
 
     template<typename Class_Type>
     struct ClassBuilder
     {
+        // everything built here is counted against the class
+        MetadataScope _metadataScope;
         std::unique_ptr< ReflectedStruct > _class;
 
         template<typename U = Class_Type> requires HasParentClass<U>
@@ -1135,7 +3452,7 @@ namespace SPP
         template<typename U = Class_Type> requires (!HasParentClass<U>)
             void LinkParents() {}
 
-        ClassBuilder(std::string_view InName)
+        ClassBuilder(std::string_view) : _metadataScope(get_type< Class_Type >().GetTypeData())
         {
             _class = std::make_unique< ReflectedStruct >();
             _class->_type = get_type< Class_Type >();
@@ -1144,14 +3461,149 @@ namespace SPP
 
         ~ClassBuilder()
         {
+            _class->BuildPlans();
             CPPType classType = get_type< Class_Type >();
             classType.GetTypeData()->structureRef = std::move(_class);
         }
                 
         template<typename T> //requires C_CreateProperty<T, Class_Type>
-        ClassBuilder& property(const char* InName, T Class_Type::* prop)
+        ClassBuilder& property(const char* InName, T Class_Type::* prop, uint32_t InFlags = 0)
         {
             _class->_properties.push_back(CreateProperty(InName, prop));
+            _class->_properties.back()->_flags = InFlags;
+            return *this;
+        }
+
+        template<typename T>
+        ClassBuilder& owned_property(const char* InName, T Class_Type::* prop, uint32_t InFlags = 0)
+        {
+            static_assert(std::is_pointer_v<T>, "owned properties are raw pointers");
+            _class->_properties.push_back(CreateOwnedProperty(InName, prop));
+            _class->_properties.back()->_flags = InFlags;
+            return *this;
+        }
+
+        template<typename T>
+        ClassBuilder& bit_property(const char* InName, T Class_Type::* InWord, uint8_t InShift, uint8_t InWidth, uint32_t InFlags = 0)
+        {
+            static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "bit ranges are of integer members");
+            CPPType rangeType = InWidth == 1 ? get_type<bool>() : get_type<T>();
+            _class->_properties.push_back(std::make_unique< BitfieldProperty >(InName, rangeType, offsetOf(InWord), (uint8_t)sizeof(T), InShift, InWidth, false));
+            _class->_properties.back()->_flags = InFlags;
+            return *this;
+        }
+
+        // bitfields have no address, assigning all ones and then zero to the probe shows exactly which bits are the field.
+        // The probe is a value initialized object, or zeroed storage for implicit lifetime classes that can't be
+        // default constructed (the storage implicitly holds one, only the field's own bits are ever written).
+        template<typename FieldType>
+        ClassBuilder& bitfield_property(const char* InName, void(*InAssign)(Class_Type&, int64_t), uint32_t InFlags = 0)
+        {
+            static_assert(std::is_integral_v<FieldType> || std::is_enum_v<FieldType>, "bitfields are integers, bools or enums");
+
+            std::vector< uint8_t > setBytes(sizeof(Class_Type)), clearBytes(sizeof(Class_Type));
+            auto probeField = [&](Class_Type& InProbe)
+            {
+                InAssign(InProbe, -1);
+                std::memcpy(setBytes.data(), (const void*)&InProbe, sizeof(Class_Type));
+                InAssign(InProbe, 0);
+                std::memcpy(clearBytes.data(), (const void*)&InProbe, sizeof(Class_Type));
+            };
+
+            if constexpr (std::is_default_constructible_v<Class_Type>)
+            {
+                auto probeObject = std::make_unique<Class_Type>();
+                probeField(*probeObject);
+            }
+            else
+            {
+                static_assert(std::is_trivially_destructible_v<Class_Type> && (std::is_aggregate_v<Class_Type> ||
+                    std::is_trivially_copy_constructible_v<Class_Type> || std::is_trivially_move_constructible_v<Class_Type>),
+                    "bitfields are located on a default constructible or implicit lifetime class");
+
+                struct alignas(Class_Type) ProbeStorage
+                {
+                    uint8_t Bytes[sizeof(Class_Type)];
+                };
+                auto probeStorage = std::make_unique<ProbeStorage>();
+                probeField(*std::launder(reinterpret_cast<Class_Type*>(probeStorage->Bytes)));
+            }
+
+            size_t firstByte = sizeof(Class_Type), lastByte = 0;
+            for (size_t Iter = 0; Iter < sizeof(Class_Type); Iter++)
+            {
+                if (setBytes[Iter] != clearBytes[Iter])
+                {
+                    firstByte = std::min(firstByte, Iter);
+                    lastByte = Iter;
+                }
+            }
+            SE_ASSERT(firstByte < sizeof(Class_Type));
+
+            // the declared type's storage unit, widened if the compiler let the field cross it
+            size_t wordSize = sizeof(FieldType);
+            size_t wordOffset = firstByte / wordSize * wordSize;
+            while (lastByte >= wordOffset + wordSize && wordSize < sizeof(uint64_t))
+            {
+                wordSize *= 2;
+                wordOffset = firstByte / wordSize * wordSize;
+            }
+            if (wordOffset + wordSize > sizeof(Class_Type))
+            {
+                // the storage unit runs past the object (packed types), the smallest word holding the field slid back inside
+                wordSize = std::bit_ceil(lastByte - firstByte + 1);
+                wordOffset = std::min(firstByte, sizeof(Class_Type) - std::min(wordSize, sizeof(Class_Type)));
+            }
+            SE_ASSERT(wordSize == 1 || wordSize == 2 || wordSize == 4 || wordSize == 8);
+            SE_ASSERT(wordOffset <= firstByte && lastByte < wordOffset + wordSize && wordOffset + wordSize <= sizeof(Class_Type));
+
+            uint64_t setWord = 0, clearWord = 0;
+            std::memcpy(&setWord, setBytes.data() + wordOffset, wordSize);
+            std::memcpy(&clearWord, clearBytes.data() + wordOffset, wordSize);
+            const uint64_t fieldMask = setWord ^ clearWord;
+            const auto fieldShift = (uint8_t)std::countr_zero(fieldMask);
+            const auto fieldWidth = (uint8_t)std::popcount(fieldMask);
+            SE_ASSERT((fieldMask >> fieldShift) == (fieldWidth == 64 ? ~0ull : (1ull << fieldWidth) - 1));
+
+            bool bSigned = false;
+            if constexpr (std::is_enum_v<FieldType>)
+            {
+                bSigned = std::is_signed_v< std::underlying_type_t<FieldType> >;
+            }
+            else
+            {
+                bSigned = std::is_signed_v<FieldType>;
+            }
+
+            _class->_properties.push_back(std::make_unique< BitfieldProperty >(InName, get_type<FieldType>(), wordOffset, (uint8_t)wordSize, fieldShift, fieldWidth, bSigned));
+            _class->_properties.back()->_flags = InFlags;
+            return *this;
+        }
+
+        template<typename T>
+        ClassBuilder& attribute(const char* InName, const T& InValue)
+        {
+            SE_ASSERT(!_class->_properties.empty());
+
+            PropertyAttributeValue attributeValue;
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                attributeValue = InValue;
+            }
+            else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+            {
+                attributeValue = (int64_t)InValue;
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                attributeValue = (double)InValue;
+            }
+            else
+            {
+                attributeValue = InternedName(std::string_view(InValue));
+            }
+
+            _class->_properties.back()->_attributes.push_back({ InternedName(InName), attributeValue });
             return *this;
         }
 
@@ -1195,9 +3647,9 @@ namespace SPP
             };
 
             auto newMethod = std::make_unique< ReflectedMethod >();
-            newMethod->_name = InName;
+            newMethod->_name = InternedName(InName);
             newMethod->_returnType = retType;
-            newMethod->_propertyTypes = methodArgs;
+            newMethod->_propertyTypes.assign(methodArgs.begin(), methodArgs.end());
             newMethod->_type = get_type< Func >();
             newMethod->_method = callMethod;
 
@@ -1217,7 +3669,7 @@ namespace SPP
             std::vector< CPPType > methodArgs;
             (methodArgs.push_back(get_type< Args >()), ...);
 
-            auto callMethod = [](void* InClassAddr, Argument& retArg, const std::vector< Argument >& arguments) -> void
+            auto callMethod = [](void*, Argument& retArg, const std::vector< Argument >& arguments) -> void
             {
                 if (arguments.size() == ArgCount)
                 {
@@ -1226,9 +3678,9 @@ namespace SPP
             };
 
             auto newMethod = std::make_unique< ReflectedMethod >();
-            newMethod->_name = "constructor";
+            newMethod->_name = InternedName("constructor");
             newMethod->_returnType = retType;
-            newMethod->_propertyTypes = methodArgs;
+            newMethod->_propertyTypes.assign(methodArgs.begin(), methodArgs.end());
             newMethod->_type = get_type< type_list<Args...> >();
             newMethod->_method = callMethod;
 
@@ -1243,4 +3695,14 @@ namespace SPP
     {
         return ClassBuilder< Class_Type>(name);
     }    
+
+    template<typename Class_Type>
+    ClassBuilder< Class_Type>& add_static_properties(ClassBuilder< Class_Type>&& InBuilder)
+    {
+        for_each_static_property<Class_Type>([&](const auto& InProp)
+        {
+            InBuilder.property(InProp.name.data(), InProp.pointer);
+        });
+        return InBuilder;
+    }
 }
\ No newline at end of file
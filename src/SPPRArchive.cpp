@@ -0,0 +1,847 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPRArchive.h"
+#include <mutex>
+#include <unordered_map>
+#include <cmath>
+#include <bit>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SPP_ARCHIVE_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define SPP_ARCHIVE_SSE2 0
+#endif
+
+namespace SPP
+{
+    static constexpr uint8_t ArchiveMagic[4] = { 'S', 'P', 'R', 'A' };
+    // varints decoded per pass when reading a delta coded array
+    static constexpr size_t ArchiveDecodeBatch = 256;
+    // strings and arrays are grown by about this much at a time as their bytes arrive, a count from a stream is only
+    // bounded by StreamReaderSettings::MaxArchiveSize and mustn't be allocated up front
+    static constexpr size_t ArchiveGrowBytes = 1024 * 1024;
+    // most map entries reserved ahead of loading them
+    static constexpr size_t ArchiveReserveEntries = 64 * 1024;
+
+    ////////////////////////////////////////////
+    //
+    // ARCHIVE STEPS
+    //
+    ////////////////////////////////////////////
+
+    struct QuantizeRange
+    {
+        double Min = 0;
+        double Max = 0;
+        // 0 when the property has no range
+        uint32_t Bits = 0;
+    };
+
+    struct ArchiveStep
+    {
+        ReflectedProperty* Property = nullptr;
+        EPropertyKind Kind = EPropertyKind::Custom;
+        QuantizeRange Quantize;
+    };
+
+    struct ArchiveStepCache
+    {
+        std::mutex lock;
+        std::unordered_map< const ReflectedStruct*, std::unique_ptr< std::vector< ArchiveStep > > > steps;
+    };
+
+    static ArchiveStepCache& GetArchiveStepCache()
+    {
+        static ArchiveStepCache sO;
+        return sO;
+    }
+
+    static QuantizeRange GetQuantizeRange(const ReflectedProperty* InProperty)
+    {
+        QuantizeRange oRange;
+        auto rangeMin = InProperty->GetAttribute<double>("QuantizeMin");
+        auto rangeMax = InProperty->GetAttribute<double>("QuantizeMax");
+        auto rangeBits = InProperty->GetAttribute<int64_t>("QuantizeBits");
+        if (rangeMin && rangeMax && rangeBits && *rangeMax > *rangeMin && *rangeBits > 0 && *rangeBits <= 32)
+        {
+            oRange = { *rangeMin, *rangeMax, (uint32_t)*rangeBits };
+        }
+        return oRange;
+    }
+
+    // properties in write order, bitfields once per word, the attribute lookups done up front
+    static const std::vector< ArchiveStep >& GetArchiveSteps(const ReflectedStruct* InStruct)
+    {
+        auto& stepCache = GetArchiveStepCache();
+        std::unique_lock<std::mutex> lock(stepCache.lock);
+
+        auto& foundSteps = stepCache.steps[InStruct];
+        if (!foundSteps)
+        {
+            foundSteps = std::make_unique< std::vector< ArchiveStep > >();
+            InStruct->IterateProperties([&](ReflectedProperty* InProperty)
+            {
+                const auto propKind = InProperty->GetKind();
+                if (propKind == EPropertyKind::Bitfield && !static_cast<BitfieldProperty*>(InProperty)->IsWordLeader())
+                {
+                    return;
+                }
+                foundSteps->push_back({ InProperty, propKind, GetQuantizeRange(InProperty) });
+            });
+        }
+        return *foundSteps;
+    }
+
+    // integers of 2 bytes or more, enums by their underlying size
+    static inline bool IsDeltaKind(const ReflectedProperty* InProperty, EPropertyKind InKind)
+    {
+        switch (InKind)
+        {
+        case EPropertyKind::Int16: case EPropertyKind::Int32: case EPropertyKind::Int64:
+        case EPropertyKind::UInt16: case EPropertyKind::UInt32: case EPropertyKind::UInt64:
+            return true;
+        case EPropertyKind::Enum:
+            switch (InProperty->GetCPPType()->get_sizeof)
+            {
+            case 2: case 4: case 8: return true;
+            default: return false;
+            }
+        default:
+            return false;
+        }
+    }
+
+    // registered enums only take their declared values
+    static bool IsDeclaredEnumValue(EnumProperty* InProperty, void* InValue)
+    {
+        if (!InProperty->GetCPPType()->enumCollection)
+        {
+            return true;
+        }
+        int64_t enumValue = 0;
+        InProperty->VisitUnderlying(InValue, [&enumValue](auto& InUnderlying) { enumValue = (int64_t)InUnderlying; });
+        return InProperty->FindValueName(enumValue) != nullptr;
+    }
+
+    // bools and enums have byte patterns that aren't values, they can't be taken as a block and are checked one by one
+    static bool HasCheckedValues(ReflectedProperty* InProperty, EPropertyKind InKind)
+    {
+        if (InKind == EPropertyKind::Bool || InKind == EPropertyKind::Enum)
+        {
+            return true;
+        }
+        auto refStruct = InKind == EPropertyKind::Struct ? InProperty->GetCPPType()->structureRef.get() : nullptr;
+        return refStruct && std::any_of(refStruct->GetFlatLayout().begin(), refStruct->GetFlatLayout().end(), [](const auto& InStep)
+        {
+            return InStep.Kind == EPropertyKind::Bool || InStep.Kind == EPropertyKind::Enum;
+        });
+    }
+
+    // NaN goes to the bottom of the range, everything else is clamped into it before rounding
+    static inline uint64_t QuantizeValue(double InValue, const QuantizeRange& InRange)
+    {
+        const double maxStep = (double)((1ull << InRange.Bits) - 1);
+        const double clampedValue = std::isnan(InValue) ? InRange.Min : std::clamp(InValue, InRange.Min, InRange.Max);
+        const double scaledValue = std::clamp((clampedValue - InRange.Min) / (InRange.Max - InRange.Min) * maxStep, 0.0, maxStep);
+        return (uint64_t)std::llround(std::isnan(scaledValue) ? 0.0 : scaledValue);
+    }
+
+    static inline double DequantizeValue(uint64_t InValue, const QuantizeRange& InRange)
+    {
+        const double maxStep = (double)((1ull << InRange.Bits) - 1);
+        return InRange.Min + (double)std::min< uint64_t >(InValue, (1ull << InRange.Bits) - 1) * (InRange.Max - InRange.Min) / maxStep;
+    }
+
+    ////////////////////////////////////////////
+    //
+    // WRITE
+    //
+    ////////////////////////////////////////////
+
+    struct ArchiveSaver
+    {
+        BinaryArchiveWriter& Writer;
+        const bool bCompact;
+        std::vector< uint8_t > keyBytes{};
+
+        template<typename T>
+        void SaveInteger(const void* InValue)
+        {
+            T curValue;
+            std::memcpy(&curValue, InValue, sizeof(T));
+            if (!bCompact || sizeof(T) == 1)
+            {
+                Writer.Write(curValue);
+            }
+            else if constexpr (std::is_signed_v<T>)
+            {
+                Writer.WriteZigZag(curValue);
+            }
+            else
+            {
+                Writer.WriteVarint(curValue);
+            }
+        }
+
+        template<typename T>
+        void SaveFloat(const void* InValue, const QuantizeRange& InRange)
+        {
+            if (bCompact && InRange.Bits)
+            {
+                Writer.WriteVarint(QuantizeValue(*(const T*)InValue, InRange));
+            }
+            else
+            {
+                Writer.Write(InValue, sizeof(T));
+            }
+        }
+
+        // differences in the unsigned type wrap, read back as the signed type of the same width for zigzag
+        template<typename T>
+        void SaveDeltas(const uint8_t* InValues, size_t InCount)
+        {
+            using unsigned_type = std::make_unsigned_t<T>;
+            using signed_type = std::make_signed_t<T>;
+            unsigned_type prevValue = 0;
+            for (size_t Iter = 0; Iter < InCount; Iter++)
+            {
+                unsigned_type curValue;
+                std::memcpy(&curValue, InValues + Iter * sizeof(T), sizeof(T));
+                Writer.WriteZigZag((signed_type)(unsigned_type)(curValue - prevValue));
+                prevValue = curValue;
+            }
+        }
+
+        void SaveStruct(const ReflectedStruct* InStruct, const void* InObject)
+        {
+            for (const auto& curStep : GetArchiveSteps(InStruct))
+            {
+                SaveValue(curStep.Property, curStep.Kind, curStep.Property->AccessValueAddress((void*)InObject), curStep.Quantize);
+            }
+        }
+
+        void SaveArray(ReflectedProperty* InProperty, void* InValue, const QuantizeRange& InRange)
+        {
+            auto arrayManipulator = InProperty->GetCPPType()->arrayManipulator.get();
+            const size_t arraySize = arrayManipulator->Size(InValue);
+            Writer.WriteVarint(arraySize);
+            if (!arraySize)
+            {
+                return;
+            }
+
+            auto innerProp = InProperty->GetInner();
+            const auto innerKind = innerProp->GetKind();
+            auto firstElement = (const uint8_t*)arrayManipulator->Element(InValue, 0);
+            const size_t elementSize = innerProp->GetCPPType()->get_sizeof;
+
+            if (bCompact && IsDeltaKind(innerProp, innerKind))
+            {
+                switch (elementSize)
+                {
+                case 2: SaveDeltas<int16_t>(firstElement, arraySize); return;
+                case 4: SaveDeltas<int32_t>(firstElement, arraySize); return;
+                case 8: SaveDeltas<int64_t>(firstElement, arraySize); return;
+                default: break;
+                }
+            }
+
+            const bool bQuantized = bCompact && InRange.Bits && (innerKind == EPropertyKind::Float || innerKind == EPropertyKind::Double);
+            if (innerProp->IsBlockCopyable() && !bQuantized && (!bCompact || elementSize == 1))
+            {
+                Writer.Write(firstElement, arraySize * elementSize);
+                return;
+            }
+
+            for (size_t Iter = 0; Iter < arraySize; Iter++)
+            {
+                SaveValue(innerProp, innerKind, innerProp->AccessValueAddress((void*)(firstElement + Iter * elementSize)), InRange);
+            }
+        }
+
+        // InValue is the value's address, InRange comes from the outermost property (arrays pass it to their elements)
+        void SaveValue(ReflectedProperty* InProperty, EPropertyKind InKind, void* InValue, const QuantizeRange& InRange)
+        {
+            switch (InKind)
+            {
+            case EPropertyKind::Int8: SaveInteger<int8_t>(InValue); break;
+            case EPropertyKind::Int16: SaveInteger<int16_t>(InValue); break;
+            case EPropertyKind::Int32: SaveInteger<int32_t>(InValue); break;
+            case EPropertyKind::Int64: SaveInteger<int64_t>(InValue); break;
+            case EPropertyKind::UInt8: SaveInteger<uint8_t>(InValue); break;
+            case EPropertyKind::UInt16: SaveInteger<uint16_t>(InValue); break;
+            case EPropertyKind::UInt32: SaveInteger<uint32_t>(InValue); break;
+            case EPropertyKind::UInt64: SaveInteger<uint64_t>(InValue); break;
+            case EPropertyKind::Enum:
+                static_cast<EnumProperty*>(InProperty)->VisitUnderlying(InValue, [&](auto& InUnderlying)
+                {
+                    SaveInteger< std::remove_cvref_t<decltype(InUnderlying)> >(&InUnderlying);
+                });
+                break;
+            case EPropertyKind::Bool: Writer.Write((uint8_t)(*(const bool*)InValue ? 1 : 0)); break;
+            case EPropertyKind::Float: SaveFloat<float>(InValue, InRange); break;
+            case EPropertyKind::Double: SaveFloat<double>(InValue, InRange); break;
+            case EPropertyKind::String:
+            {
+                auto& stringValue = *(const std::string*)InValue;
+                Writer.WriteVarint(stringValue.size());
+                Writer.Write(stringValue.data(), stringValue.size());
+                break;
+            }
+            case EPropertyKind::Strumber:
+            {
+                auto& strumberValue = *(const Strumber*)InValue;
+                Writer.Write(strumberValue._id);
+                Writer.Write(strumberValue._number);
+                break;
+            }
+            case EPropertyKind::GUID:
+                Writer.Write(*(const GUID*)InValue);
+                break;
+            case EPropertyKind::Struct:
+                if (auto refStruct = InProperty->GetCPPType()->structureRef.get())
+                {
+                    SaveStruct(refStruct, InValue);
+                }
+                break;
+            case EPropertyKind::DynamicArray:
+                SaveArray(InProperty, InValue, InRange);
+                break;
+            case EPropertyKind::UniquePtr:
+            case EPropertyKind::Wrapped:
+            {
+                auto wrapManipulator = static_cast<WrapProperty*>(InProperty)->GetWrap();
+                if (!wrapManipulator->IsOwning())
+                {
+                    break;
+                }
+
+                auto wrappedValue = wrapManipulator->Get(InValue);
+                Writer.Write((uint8_t)(wrappedValue ? 1 : 0));
+                if (wrappedValue)
+                {
+                    auto innerProp = InProperty->GetInner();
+                    SaveValue(innerProp, innerProp->GetKind(), innerProp->AccessValueAddress(wrappedValue), InRange);
+                }
+                break;
+            }
+            case EPropertyKind::Variant:
+            {
+                // 0 is valueless
+                void* activeValue = nullptr;
+                size_t activeIndex = 0;
+                auto activeProp = static_cast<VariantProperty*>(InProperty)->GetActive(InValue, activeValue, &activeIndex);
+                Writer.WriteVarint(activeProp ? activeIndex + 1 : 0);
+                if (activeProp)
+                {
+                    SaveValue(activeProp, activeProp->GetKind(), activeProp->AccessValueAddress(activeValue), InRange);
+                }
+                break;
+            }
+            case EPropertyKind::Map:
+            {
+                auto mapProp = static_cast<MapProperty*>(InProperty);
+                auto mapManipulator = mapProp->GetMap();
+                auto valueProp = mapProp->GetValue();
+
+                std::vector< MapEntry > mapEntries;
+                mapProp->GetEntries(InValue, mapEntries, mapProp->IsDeterministic());
+                // keys that can't be encoded aren't written (see MapProperty::Diff)
+                std::erase_if(mapEntries, [&](const MapEntry& InEntry) { return !mapManipulator->EncodeKey(InEntry.Key, keyBytes); });
+
+                Writer.WriteVarint(mapEntries.size());
+                for (const auto& curEntry : mapEntries)
+                {
+                    mapManipulator->EncodeKey(curEntry.Key, keyBytes);
+                    Writer.WriteVarint(keyBytes.size());
+                    Writer.Write(keyBytes.data(), keyBytes.size());
+                    if (valueProp)
+                    {
+                        SaveValue(valueProp, valueProp->GetKind(), valueProp->AccessValueAddress(curEntry.Value), InRange);
+                    }
+                }
+                break;
+            }
+            case EPropertyKind::Bitfield:
+            {
+                // the leader, every reflected bit of the word
+                auto bitProp = static_cast<BitfieldProperty*>(InProperty);
+                const uint64_t wordMask = bitProp->GetWordMask();
+                const uint64_t maskedWord = bitProp->ReadWord(InValue) & wordMask;
+                if (bCompact)
+                {
+                    Writer.WriteVarint(maskedWord >> std::countr_zero(wordMask));
+                }
+                else
+                {
+                    Writer.Write(&maskedWord, bitProp->GetWordSize());
+                }
+                break;
+            }
+            case EPropertyKind::BitArray:
+            {
+                auto bitArrayProp = static_cast<BitArrayProperty*>(InProperty);
+                Writer.Write(InValue, (bitArrayProp->GetBitCount() + 7) / 8);
+                break;
+            }
+            default:
+                // pointers and custom values aren't written
+                break;
+            }
+        }
+    };
+
+    void BinaryArchiveWriter::Save(const ReflectedStruct* InStruct, const void* InObject)
+    {
+        SE_ASSERT(InStruct);
+        Write(ArchiveMagic, sizeof(ArchiveMagic));
+        Write((uint8_t)_encoding);
+
+        ArchiveSaver archiveSaver{ *this, _encoding == EArchiveEncoding::Compact };
+        archiveSaver.SaveStruct(InStruct, InObject);
+    }
+
+    ////////////////////////////////////////////
+    //
+    // READ
+    //
+    ////////////////////////////////////////////
+
+    bool BinaryArchiveReader::ReadSlow(void* OutData, size_t InSize)
+    {
+        auto outBytes = (uint8_t*)OutData;
+        while (InSize && !_bFailed)
+        {
+            const size_t copySize = std::min(InSize, (size_t)(_end - _cur));
+            std::memcpy(outBytes, _cur, copySize);
+            _cur += copySize;
+            outBytes += copySize;
+            InSize -= copySize;
+
+            if (InSize && !Fetch(1))
+            {
+                return Fail();
+            }
+        }
+        return !InSize;
+    }
+
+    bool BinaryArchiveReader::ReadVarints(uint64_t* OutValues, size_t InCount)
+    {
+        size_t readCount = 0;
+        while (readCount < InCount)
+        {
+            // the leading bytes without a continuation bit are whole values
+            size_t singleBytes = 0;
+#if SPP_ARCHIVE_SSE2
+            if (_end - _cur >= 16)
+            {
+                const uint32_t continueMask = (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)_cur));
+                singleBytes = continueMask ? std::countr_zero(continueMask) : 16;
+            }
+#else
+            if (_end - _cur >= 8)
+            {
+                uint64_t curWord;
+                std::memcpy(&curWord, _cur, sizeof(curWord));
+                const uint64_t continueMask = curWord & 0x8080808080808080ull;
+                singleBytes = continueMask ? std::countr_zero(continueMask) / 8 : 8;
+            }
+#endif
+            singleBytes = std::min(singleBytes, InCount - readCount);
+            if (singleBytes)
+            {
+                for (size_t Iter = 0; Iter < singleBytes; Iter++)
+                {
+                    OutValues[readCount + Iter] = _cur[Iter];
+                }
+                _cur += singleBytes;
+                readCount += singleBytes;
+                continue;
+            }
+
+            if (!ReadVarint(OutValues[readCount++]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct ArchiveLoader
+    {
+        BinaryArchiveReader& Reader;
+        const bool bCompact;
+        std::vector< uint8_t > keyBytes{};
+        std::vector< uint64_t > decodeBatch{};
+
+        template<typename T>
+        bool LoadInteger(void* InValue)
+        {
+            T curValue;
+            if (!bCompact || sizeof(T) == 1)
+            {
+                if (!Reader.Read(curValue)) return false;
+            }
+            else if constexpr (std::is_signed_v<T>)
+            {
+                int64_t decodedValue;
+                if (!Reader.ReadZigZag(decodedValue) || decodedValue < std::numeric_limits<T>::min() || decodedValue > std::numeric_limits<T>::max()) return false;
+                curValue = (T)decodedValue;
+            }
+            else
+            {
+                uint64_t decodedValue;
+                if (!Reader.ReadVarint(decodedValue) || decodedValue > std::numeric_limits<T>::max()) return false;
+                curValue = (T)decodedValue;
+            }
+            std::memcpy(InValue, &curValue, sizeof(T));
+            return true;
+        }
+
+        template<typename T>
+        bool LoadFloat(void* InValue, const QuantizeRange& InRange)
+        {
+            if (bCompact && InRange.Bits)
+            {
+                uint64_t quantizedValue;
+                if (!Reader.ReadVarint(quantizedValue)) return false;
+                *(T*)InValue = (T)DequantizeValue(quantizedValue, InRange);
+                return true;
+            }
+            return Reader.Read(InValue, sizeof(T));
+        }
+
+        // batches of varints, then the zigzag and running sum in a plain loop the compiler can unroll
+        // InOutPrev carries the running value from one run of the array to the next
+        template<typename T>
+        bool LoadDeltas(uint8_t* OutValues, size_t InCount, uint64_t& InOutPrev)
+        {
+            using unsigned_type = std::make_unsigned_t<T>;
+            using signed_type = std::make_signed_t<T>;
+            unsigned_type prevValue = (unsigned_type)InOutPrev;
+            decodeBatch.resize(std::min(InCount, ArchiveDecodeBatch));
+
+            for (size_t batchStart = 0; batchStart < InCount; batchStart += ArchiveDecodeBatch)
+            {
+                const size_t batchCount = std::min(ArchiveDecodeBatch, InCount - batchStart);
+                if (!Reader.ReadVarints(decodeBatch.data(), batchCount))
+                {
+                    return false;
+                }
+
+                // deltas were written as the signed type, anything wider is a bad archive
+                auto batchOut = OutValues + batchStart * sizeof(T);
+                bool bInRange = true;
+                for (size_t Iter = 0; Iter < batchCount; Iter++)
+                {
+                    const int64_t curDelta = ZigZagDecode(decodeBatch[Iter]);
+                    bInRange &= curDelta == (int64_t)(signed_type)curDelta;
+                    prevValue = (unsigned_type)(prevValue + (unsigned_type)curDelta);
+                    std::memcpy(batchOut + Iter * sizeof(T), &prevValue, sizeof(T));
+                }
+                if (!bInRange)
+                {
+                    return false;
+                }
+            }
+            InOutPrev = prevValue;
+            return true;
+        }
+
+        bool LoadStruct(const ReflectedStruct* InStruct, void* InObject)
+        {
+            for (const auto& curStep : GetArchiveSteps(InStruct))
+            {
+                if (!LoadValue(curStep.Property, curStep.Kind, curStep.Property->AccessValueAddress(InObject), curStep.Quantize))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool LoadArray(ReflectedProperty* InProperty, void* InValue, const QuantizeRange& InRange)
+        {
+            uint64_t arraySize = 0;
+            if (!Reader.ReadVarint(arraySize))
+            {
+                return false;
+            }
+
+            auto arrayManipulator = InProperty->GetCPPType()->arrayManipulator.get();
+            auto innerProp = InProperty->GetInner();
+            const auto innerKind = innerProp->GetKind();
+            const size_t elementSize = innerProp->GetCPPType()->get_sizeof;
+
+            // a size past what's left is a bad archive not an allocation, an element that writes nothing (empty struct,
+            // pointer) still counts as a byte
+            if (arraySize > Reader.GetRemaining())
+            {
+                return false;
+            }
+
+            // existing elements are loaded over, new ones are added a step at a time as their bytes arrive
+            const size_t growElements = std::max< size_t >(ArchiveGrowBytes / std::max< size_t >(elementSize, 1), 1);
+            arrayManipulator->Resize(InValue, (size_t)std::min< uint64_t >(arraySize, std::max(arrayManipulator->Size(InValue), growElements)));
+
+            uint64_t deltaPrev = 0;
+            for (size_t loadedCount = 0; loadedCount < arraySize; )
+            {
+                size_t readyCount = arrayManipulator->Size(InValue);
+                if (loadedCount == readyCount)
+                {
+                    readyCount = (size_t)std::min< uint64_t >(arraySize, readyCount + growElements);
+                    arrayManipulator->Resize(InValue, readyCount);
+                }
+
+                auto firstElement = (uint8_t*)arrayManipulator->Element(InValue, 0) + loadedCount * elementSize;
+                if (!LoadElements(innerProp, innerKind, firstElement, readyCount - loadedCount, InRange, deltaPrev))
+                {
+                    return false;
+                }
+                loadedCount = readyCount;
+            }
+            return true;
+        }
+
+        // InCount contiguous elements of an array
+        bool LoadElements(ReflectedProperty* InInner, EPropertyKind InInnerKind, uint8_t* InFirst, size_t InCount, const QuantizeRange& InRange, uint64_t& InOutDeltaPrev)
+        {
+            const size_t elementSize = InInner->GetCPPType()->get_sizeof;
+            if (bCompact && IsDeltaKind(InInner, InInnerKind))
+            {
+                bool bLoaded = false;
+                switch (elementSize)
+                {
+                case 2: bLoaded = LoadDeltas<int16_t>(InFirst, InCount, InOutDeltaPrev); break;
+                case 4: bLoaded = LoadDeltas<int32_t>(InFirst, InCount, InOutDeltaPrev); break;
+                default: bLoaded = LoadDeltas<int64_t>(InFirst, InCount, InOutDeltaPrev); break;
+                }
+                if (bLoaded && InInnerKind == EPropertyKind::Enum)
+                {
+                    for (size_t Iter = 0; Iter < InCount && bLoaded; Iter++)
+                    {
+                        bLoaded = IsDeclaredEnumValue(static_cast<EnumProperty*>(InInner), InFirst + Iter * elementSize);
+                    }
+                }
+                return bLoaded;
+            }
+
+            const bool bQuantized = bCompact && InRange.Bits && (InInnerKind == EPropertyKind::Float || InInnerKind == EPropertyKind::Double);
+            if (InInner->IsBlockCopyable() && !bQuantized && (!bCompact || elementSize == 1) && !HasCheckedValues(InInner, InInnerKind))
+            {
+                return Reader.Read(InFirst, InCount * elementSize);
+            }
+
+            for (size_t Iter = 0; Iter < InCount; Iter++)
+            {
+                if (!LoadValue(InInner, InInnerKind, InInner->AccessValueAddress(InFirst + Iter * elementSize), InRange))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool LoadValue(ReflectedProperty* InProperty, EPropertyKind InKind, void* InValue, const QuantizeRange& InRange)
+        {
+            switch (InKind)
+            {
+            case EPropertyKind::Int8: return LoadInteger<int8_t>(InValue);
+            case EPropertyKind::Int16: return LoadInteger<int16_t>(InValue);
+            case EPropertyKind::Int32: return LoadInteger<int32_t>(InValue);
+            case EPropertyKind::Int64: return LoadInteger<int64_t>(InValue);
+            case EPropertyKind::UInt8: return LoadInteger<uint8_t>(InValue);
+            case EPropertyKind::UInt16: return LoadInteger<uint16_t>(InValue);
+            case EPropertyKind::UInt32: return LoadInteger<uint32_t>(InValue);
+            case EPropertyKind::UInt64: return LoadInteger<uint64_t>(InValue);
+            case EPropertyKind::Enum:
+            {
+                bool bLoaded = false;
+                static_cast<EnumProperty*>(InProperty)->VisitUnderlying(InValue, [&](auto& InUnderlying)
+                {
+                    bLoaded = LoadInteger< std::remove_cvref_t<decltype(InUnderlying)> >(&InUnderlying);
+                });
+                return bLoaded && IsDeclaredEnumValue(static_cast<EnumProperty*>(InProperty), InValue);
+            }
+            case EPropertyKind::Bool:
+            {
+                uint8_t boolValue = 0;
+                if (!Reader.Read(boolValue) || boolValue > 1) return false;
+                *(bool*)InValue = boolValue != 0;
+                return true;
+            }
+            case EPropertyKind::Float: return LoadFloat<float>(InValue, InRange);
+            case EPropertyKind::Double: return LoadFloat<double>(InValue, InRange);
+            case EPropertyKind::String:
+            {
+                uint64_t stringSize = 0;
+                if (!Reader.ReadVarint(stringSize) || stringSize > Reader.GetRemaining()) return false;
+                // grown as the bytes arrive like arrays
+                auto& stringValue = *(std::string*)InValue;
+                stringValue.clear();
+                while (stringValue.size() < stringSize)
+                {
+                    const size_t loadedSize = stringValue.size();
+                    const size_t stepSize = (size_t)std::min< uint64_t >(stringSize - loadedSize, ArchiveGrowBytes);
+                    stringValue.resize(loadedSize + stepSize);
+                    if (!Reader.Read(stringValue.data() + loadedSize, stepSize)) return false;
+                }
+                return true;
+            }
+            case EPropertyKind::Strumber:
+            {
+                auto& strumberValue = *(Strumber*)InValue;
+                return Reader.Read(strumberValue._id) && Reader.Read(strumberValue._number);
+            }
+            case EPropertyKind::GUID:
+                return Reader.Read(*(GUID*)InValue);
+            case EPropertyKind::Struct:
+                if (auto refStruct = InProperty->GetCPPType()->structureRef.get())
+                {
+                    return LoadStruct(refStruct, InValue);
+                }
+                return true;
+            case EPropertyKind::DynamicArray:
+                return LoadArray(InProperty, InValue, InRange);
+            case EPropertyKind::UniquePtr:
+            case EPropertyKind::Wrapped:
+            {
+                auto wrapManipulator = static_cast<WrapProperty*>(InProperty)->GetWrap();
+                if (!wrapManipulator->IsOwning())
+                {
+                    return true;
+                }
+
+                uint8_t bHasValue = 0;
+                if (!Reader.Read(bHasValue)) return false;
+                if (!bHasValue)
+                {
+                    wrapManipulator->Clear(InValue);
+                    return true;
+                }
+
+                auto wrappedValue = wrapManipulator->Get(InValue);
+                if (!wrappedValue && !(wrappedValue = wrapManipulator->Construct(InValue)))
+                {
+                    return false;
+                }
+                auto innerProp = InProperty->GetInner();
+                return LoadValue(innerProp, innerProp->GetKind(), innerProp->AccessValueAddress(wrappedValue), InRange);
+            }
+            case EPropertyKind::Variant:
+            {
+                uint64_t storedIndex = 0;
+                if (!Reader.ReadVarint(storedIndex)) return false;
+                // a valueless variant can't be made on purpose, leave it
+                if (!storedIndex)
+                {
+                    return true;
+                }
+
+                auto variantProp = static_cast<VariantProperty*>(InProperty);
+                if (storedIndex > variantProp->GetAlternativeCount())
+                {
+                    return false;
+                }
+
+                auto activeValue = InProperty->GetCPPType()->variantManipulator->Emplace(InValue, storedIndex - 1);
+                if (!activeValue)
+                {
+                    return false;
+                }
+                auto activeProp = variantProp->GetAlternative(storedIndex - 1);
+                return LoadValue(activeProp, activeProp->GetKind(), activeProp->AccessValueAddress(activeValue), InRange);
+            }
+            case EPropertyKind::Map:
+            {
+                auto mapProp = static_cast<MapProperty*>(InProperty);
+                auto mapManipulator = mapProp->GetMap();
+                auto valueProp = mapProp->GetValue();
+
+                uint64_t entryCount = 0;
+                if (!Reader.ReadVarint(entryCount) || entryCount > Reader.GetRemaining()) return false;
+
+                mapManipulator->Clear(InValue);
+                mapManipulator->Reserve(InValue, (size_t)std::min< uint64_t >(entryCount, ArchiveReserveEntries));
+                for (uint64_t Iter = 0; Iter < entryCount; Iter++)
+                {
+                    uint64_t keySize = 0;
+                    if (!Reader.ReadVarint(keySize) || keySize > Reader.GetRemaining()) return false;
+                    keyBytes.resize(keySize);
+                    if (!Reader.Read(keyBytes.data(), keySize)) return false;
+
+                    bool bEntryLoaded = false;
+                    mapManipulator->DecodeKey(keyBytes.data(), keyBytes.size(), [&](const void* InKey)
+                    {
+                        auto entryValue = mapManipulator->FindOrAdd(InValue, InKey);
+                        bEntryLoaded = entryValue &&
+                            (!valueProp || LoadValue(valueProp, valueProp->GetKind(), valueProp->AccessValueAddress(entryValue), InRange));
+                    });
+                    if (!bEntryLoaded)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case EPropertyKind::Bitfield:
+            {
+                auto bitProp = static_cast<BitfieldProperty*>(InProperty);
+                const uint64_t wordMask = bitProp->GetWordMask();
+                uint64_t maskedWord = 0;
+                if (bCompact)
+                {
+                    if (!Reader.ReadVarint(maskedWord)) return false;
+                    maskedWord <<= std::countr_zero(wordMask);
+                }
+                else if (!Reader.Read(&maskedWord, bitProp->GetWordSize()))
+                {
+                    return false;
+                }
+                bitProp->WriteWord(InValue, (bitProp->ReadWord(InValue) & ~wordMask) | (maskedWord & wordMask));
+                return true;
+            }
+            case EPropertyKind::BitArray:
+            {
+                auto bitArrayProp = static_cast<BitArrayProperty*>(InProperty);
+                const size_t bitCount = bitArrayProp->GetBitCount();
+                if (!Reader.Read(InValue, (bitCount + 7) / 8))
+                {
+                    return false;
+                }
+                // bits past the count stay clear
+                if (bitCount & 7)
+                {
+                    ((uint8_t*)InValue)[bitCount / 8] &= (uint8_t)((1u << (bitCount & 7)) - 1);
+                }
+                return true;
+            }
+            default:
+                return true;
+            }
+        }
+    };
+
+    bool BinaryArchiveReader::Load(const ReflectedStruct* InStruct, void* InObject)
+    {
+        SE_ASSERT(InStruct);
+
+        uint8_t archiveMagic[sizeof(ArchiveMagic)];
+        uint8_t archiveEncoding = 0;
+        if (!Read(archiveMagic, sizeof(archiveMagic)) || std::memcmp(archiveMagic, ArchiveMagic, sizeof(ArchiveMagic)) != 0 ||
+            !Read(archiveEncoding) || archiveEncoding > (uint8_t)EArchiveEncoding::Compact)
+        {
+            return Fail();
+        }
+        _encoding = (EArchiveEncoding)archiveEncoding;
+
+        ArchiveLoader archiveLoader{ *this, _encoding == EArchiveEncoding::Compact };
+        return archiveLoader.LoadStruct(InStruct, InObject) || Fail();
+    }
+}
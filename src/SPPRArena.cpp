@@ -0,0 +1,148 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPReflection.h"
+#include <mutex>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace SPP
+{
+    static constexpr size_t MetadataBlockSize = 64 * 1024;
+
+    struct MetadataArena
+    {
+        std::mutex lock;
+        std::vector< std::unique_ptr<uint8_t[]> > blocks;
+        uint8_t* current = nullptr;
+        size_t remaining = 0;
+
+        size_t bytesUsed = 0;
+        size_t bytesReserved = 0;
+
+        std::unordered_set< std::string_view > names;
+        std::unordered_map< const type_data*, size_t > typeBytes;
+
+        // lock held
+        void* Allocate(size_t InSize, size_t InAlignment, const type_data* InOwner)
+        {
+            size_t padding = (InAlignment - ((uintptr_t)current % InAlignment)) % InAlignment;
+
+            if (!current || padding + InSize > remaining)
+            {
+                // oversized requests get a block of their own
+                const size_t blockSize = std::max(MetadataBlockSize, InSize + InAlignment);
+                blocks.push_back(std::make_unique<uint8_t[]>(blockSize));
+                current = blocks.back().get();
+                remaining = blockSize;
+                bytesReserved += blockSize;
+                padding = (InAlignment - ((uintptr_t)current % InAlignment)) % InAlignment;
+            }
+
+            auto oMemory = current + padding;
+            current += padding + InSize;
+            remaining -= padding + InSize;
+            bytesUsed += InSize;
+
+            if (InOwner)
+            {
+                typeBytes[InOwner] += InSize;
+            }
+            return oMemory;
+        }
+    };
+
+    // never destroyed, metadata is referenced until the very end of the process
+    static MetadataArena& GetMetadataArena()
+    {
+        static MetadataArena* arena = new MetadataArena();
+        return *arena;
+    }
+
+    static thread_local const type_data* tlsMetadataOwner = nullptr;
+
+    void* MetadataAllocate(size_t InSize, size_t InAlignment)
+    {
+        auto& arena = GetMetadataArena();
+        std::unique_lock<std::mutex> lock(arena.lock);
+        return arena.Allocate(InSize, InAlignment, tlsMetadataOwner);
+    }
+
+    InternedName::InternedName(std::string_view InValue)
+    {
+        if (InValue.empty())
+        {
+            return;
+        }
+
+        auto& arena = GetMetadataArena();
+        std::unique_lock<std::mutex> lock(arena.lock);
+
+        auto foundName = arena.names.find(InValue);
+        if (foundName == arena.names.end())
+        {
+            auto nameMemory = (char*)arena.Allocate(InValue.size() + 1, 1, tlsMetadataOwner);
+            std::memcpy(nameMemory, InValue.data(), InValue.size());
+            nameMemory[InValue.size()] = 0;
+            foundName = arena.names.insert(std::string_view(nameMemory, InValue.size())).first;
+        }
+
+        _str = foundName->data();
+        _size = (uint32_t)foundName->size();
+    }
+
+    MetadataScope::MetadataScope(const type_data* InType) : _previous(tlsMetadataOwner)
+    {
+        tlsMetadataOwner = InType;
+    }
+
+    MetadataScope::~MetadataScope()
+    {
+        tlsMetadataOwner = _previous;
+    }
+
+    MetadataArenaStats GetMetadataArenaStats()
+    {
+        auto& arena = GetMetadataArena();
+        std::unique_lock<std::mutex> lock(arena.lock);
+
+        MetadataArenaStats oStats;
+        oStats.BytesUsed = arena.bytesUsed;
+        oStats.BytesReserved = arena.bytesReserved;
+        oStats.BlockCount = arena.blocks.size();
+        oStats.InternedNames = arena.names.size();
+        return oStats;
+    }
+
+    size_t GetMetadataBytes(const type_data* InType)
+    {
+        auto& arena = GetMetadataArena();
+        std::unique_lock<std::mutex> lock(arena.lock);
+
+        auto foundType = arena.typeBytes.find(InType);
+        return foundType != arena.typeBytes.end() ? foundType->second : 0;
+    }
+
+    void AddMetadataBytes(const type_data* InType, size_t InBytes)
+    {
+        auto& arena = GetMetadataArena();
+        std::unique_lock<std::mutex> lock(arena.lock);
+        arena.typeBytes[InType] += InBytes;
+    }
+
+    void LogMetadataReport()
+    {
+        size_t typeCount = 0;
+        GetTypeCollection().IterateTypes([&typeCount](const type_data* InType)
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "METADATA: %s %zd bytes", InType->GetName().c_str(), GetMetadataBytes(InType));
+            typeCount++;
+        });
+
+        auto arenaStats = GetMetadataArenaStats();
+        SPP_LOG(LOG_REFLECTION, LOG_INFO, "METADATA: %zd types, %zd bytes used, %zd reserved in %zd blocks, %zd interned names",
+            typeCount, arenaStats.BytesUsed, arenaStats.BytesReserved, arenaStats.BlockCount, arenaStats.InternedNames);
+    }
+}
@@ -0,0 +1,761 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPRCollector.h"
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <limits>
+
+namespace SPP
+{
+    static constexpr size_t CollectorBlockSize = 64 * 1024;
+    static constexpr size_t CollectorMinSlotSize = 16;
+    static constexpr size_t CollectorMaxSlots = CollectorBlockSize / CollectorMinSlotSize;
+    static constexpr size_t CollectorBitWords = CollectorMaxSlots / 64;
+
+    // lives at the start of its block, so a pointer finds it with a mask
+    struct CollectorBlock
+    {
+        ReflectedCollector::Pool* Pool = nullptr;
+        uint8_t* FirstSlot = nullptr;
+        uint32_t Index = 0;
+        uint32_t SlotCount = 0;
+        // next never used slot
+        uint32_t BumpSlot = 0;
+        uint32_t SlotSize = 0;
+        // ceil(2^32 / SlotSize), exact division for any offset inside a block
+        uint64_t SlotReciprocal = 0;
+        // bytes rather than bits so marking is a plain store, no locked read-modify-write per object
+        std::atomic<uint8_t> MarkBytes[CollectorMaxSlots];
+        uint64_t AllocBits[CollectorBitWords];
+    };
+
+    struct ReflectedCollector::Pool
+    {
+        CPPType Type;
+        const ReflectedStruct* Struct = nullptr;
+        size_t SlotSize = 0;
+        void(*Destroy)(void*) = nullptr;
+
+        // plain pointer fields read directly, everything else through its property
+        std::vector< uint32_t > PointerOffsets;
+        std::vector< ReferenceSlot > ComplexSlots;
+
+        // position in Impl::pools, the sweep order
+        size_t Index = 0;
+
+        std::vector< CollectorBlock* > Blocks;
+        // freed slots, linked through their first bytes
+        void* FreeList = nullptr;
+        size_t LiveCount = 0;
+
+        // sweep position, block then bit word
+        size_t SweepBlock = 0;
+        size_t SweepWord = 0;
+    };
+
+    struct MarkItem
+    {
+        void* Object = nullptr;
+        ReflectedCollector::Pool* Pool = nullptr;
+    };
+
+    struct MarkStack
+    {
+        std::vector< MarkItem > Items;
+        // neighbours tend to share a block, skips the block table
+        CollectorBlock* LastBlock = nullptr;
+        // shared_ptr values already scanned for the current object, they can be reached twice or form cycles
+        std::vector< void* > SharedSeen;
+    };
+
+    struct ReflectedCollector::Impl
+    {
+        CollectorSettings settings;
+
+        std::vector< std::unique_ptr<Pool> > pools;
+        std::unordered_map< const type_data*, Pool* > poolsByType;
+
+        // block addresses, open addressed, only changes outside Mark
+        std::vector< CollectorBlock* > blockTable;
+        size_t blockCount = 0;
+
+        std::vector< std::pair< void*, const ReflectedStruct* > > roots;
+
+        bool bSweeping = false;
+        size_t sweepPool = 0;
+
+        // incremental mark, the objects reached but not scanned yet
+        bool bMarking = false;
+        MarkStack incrementalStack;
+
+        double lastMarkMilliseconds = 0;
+        double lastMarkStepMilliseconds = 0;
+        size_t lastMarkSteps = 0;
+        std::atomic<size_t> lastMarked = 0;
+        size_t lastFreed = 0;
+
+        size_t HashBlock(const void* InBlock) const
+        {
+            return (size_t)(((uint64_t)(uintptr_t)InBlock >> 16) * 0x9E3779B97F4A7C15ull) & (blockTable.size() - 1);
+        }
+
+        void InsertBlock(CollectorBlock* InBlock)
+        {
+            if ((blockCount + 1) * 2 > blockTable.size())
+            {
+                std::vector< CollectorBlock* > oldTable(std::max< size_t >(64, blockTable.size() * 2), nullptr);
+                oldTable.swap(blockTable);
+                blockCount = 0;
+                for (auto curBlock : oldTable)
+                {
+                    if (curBlock)
+                    {
+                        InsertBlock(curBlock);
+                    }
+                }
+            }
+
+            size_t curSlot = HashBlock(InBlock);
+            while (blockTable[curSlot])
+            {
+                curSlot = (curSlot + 1) & (blockTable.size() - 1);
+            }
+            blockTable[curSlot] = InBlock;
+            blockCount++;
+        }
+
+        CollectorBlock* FindBlock(const void* InObject) const
+        {
+            if (blockTable.empty())
+            {
+                return nullptr;
+            }
+
+            auto blockAddr = (CollectorBlock*)((uintptr_t)InObject & ~(uintptr_t)(CollectorBlockSize - 1));
+            size_t curSlot = HashBlock(blockAddr);
+            while (blockTable[curSlot])
+            {
+                if (blockTable[curSlot] == blockAddr)
+                {
+                    return blockAddr;
+                }
+                curSlot = (curSlot + 1) & (blockTable.size() - 1);
+            }
+            return nullptr;
+        }
+
+        // slot of the live managed object InAddress points into (its start or a member), -1 for the block header
+        // and free slots
+        static int64_t FindSlot(const CollectorBlock* InBlock, const void* InAddress)
+        {
+            if ((const uint8_t*)InAddress < InBlock->FirstSlot)
+            {
+                return -1;
+            }
+            const auto slotOffset = (uint64_t)((const uint8_t*)InAddress - InBlock->FirstSlot);
+            const size_t slotIdx = (size_t)((slotOffset * InBlock->SlotReciprocal) >> 32);
+            if (slotIdx >= InBlock->BumpSlot || !(InBlock->AllocBits[slotIdx / 64] & (1ull << (slotIdx % 64))))
+            {
+                return -1;
+            }
+            return (int64_t)slotIdx;
+        }
+
+        // true the first time the object InObject points into is reached
+        bool TryMark(void* InObject, CollectorBlock*& InOutLastBlock, MarkItem& OutItem) const
+        {
+            auto foundBlock = (CollectorBlock*)((uintptr_t)InObject & ~(uintptr_t)(CollectorBlockSize - 1));
+            if (foundBlock != InOutLastBlock)
+            {
+                foundBlock = FindBlock(InObject);
+                if (!foundBlock)
+                {
+                    return false;
+                }
+                InOutLastBlock = foundBlock;
+            }
+
+            const auto slotIdx = FindSlot(foundBlock, InObject);
+            if (slotIdx < 0)
+            {
+                return false;
+            }
+
+            // two workers can both see it unmarked, it just gets scanned twice
+            auto& markByte = foundBlock->MarkBytes[slotIdx];
+            if (markByte.load(std::memory_order_relaxed))
+            {
+                return false;
+            }
+            markByte.store(1, std::memory_order_relaxed);
+
+            // interior pointers scan the whole object
+            OutItem = { foundBlock->FirstSlot + (size_t)slotIdx * foundBlock->SlotSize, foundBlock->Pool };
+            return true;
+        }
+
+        void MarkPointer(void* InPointer, MarkStack& InOutStack) const
+        {
+            MarkItem newItem;
+            if (InPointer && TryMark(InPointer, InOutStack.LastBlock, newItem))
+            {
+                InOutStack.Items.push_back(newItem);
+            }
+        }
+
+        void ScanSlots(void* InObject, const std::vector< ReferenceSlot >& InSlots, MarkStack& InOutStack) const
+        {
+            for (const auto& curSlot : InSlots)
+            {
+                ScanValue((uint8_t*)InObject + curSlot.Offset, curSlot.Property, curSlot.Kind, InOutStack);
+            }
+        }
+
+        // owned values, only shared_ptr ones can be reached twice so only they are checked
+        void ScanValue(void* InValue, ReflectedProperty* InProperty, EPropertyKind InKind, MarkStack& InOutStack) const
+        {
+            switch (InKind)
+            {
+            case EPropertyKind::Pointer:
+                MarkPointer(*(void**)InValue, InOutStack);
+                break;
+            case EPropertyKind::UniquePtr:
+            case EPropertyKind::Wrapped:
+            {
+                auto wrapManipulator = static_cast<WrapProperty*>(InProperty)->GetWrap();
+                auto wrappedValue = wrapManipulator->Get(InValue);
+                if (!wrappedValue)
+                {
+                    break;
+                }
+                if (!wrapManipulator->IsExclusive())
+                {
+                    auto& sharedSeen = InOutStack.SharedSeen;
+                    if (std::find(sharedSeen.begin(), sharedSeen.end(), wrappedValue) != sharedSeen.end())
+                    {
+                        break;
+                    }
+                    sharedSeen.push_back(wrappedValue);
+                }
+
+                auto innerProp = InProperty->GetInner();
+                ScanValue(innerProp->AccessValueAddress(wrappedValue), innerProp, innerProp->GetKind(), InOutStack);
+                break;
+            }
+            case EPropertyKind::Variant:
+            {
+                void* activeValue = nullptr;
+                if (auto activeProp = static_cast<VariantProperty*>(InProperty)->GetActive(InValue, activeValue))
+                {
+                    ScanValue(activeProp->AccessValueAddress(activeValue), activeProp, activeProp->GetKind(), InOutStack);
+                }
+                break;
+            }
+            case EPropertyKind::Map:
+            {
+                auto mapProp = static_cast<MapProperty*>(InProperty);
+                auto keyProp = mapProp->GetKey();
+                auto valueProp = mapProp->GetValue();
+
+                std::vector< MapEntry > mapEntries;
+                mapProp->GetMap()->GetEntries(InValue, mapEntries);
+                for (const auto& curEntry : mapEntries)
+                {
+                    ScanValue(keyProp->AccessValueAddress((void*)curEntry.Key), keyProp, keyProp->GetKind(), InOutStack);
+                    if (valueProp)
+                    {
+                        ScanValue(valueProp->AccessValueAddress(curEntry.Value), valueProp, valueProp->GetKind(), InOutStack);
+                    }
+                }
+                break;
+            }
+            case EPropertyKind::DynamicArray:
+            {
+                auto arrayManipulator = InProperty->GetCPPType()->arrayManipulator.get();
+                const size_t totalSize = arrayManipulator->Size(InValue);
+                if (!totalSize)
+                {
+                    break;
+                }
+
+                auto innerProp = InProperty->GetInner();
+                const auto innerKind = innerProp->GetKind();
+                auto firstElement = (uint8_t*)arrayManipulator->Element(InValue, 0);
+                const size_t elementSize = innerProp->GetCPPType()->get_sizeof;
+
+                if (innerKind == EPropertyKind::Pointer)
+                {
+                    for (size_t Iter = 0; Iter < totalSize; Iter++)
+                    {
+                        MarkPointer(*(void**)(firstElement + Iter * elementSize), InOutStack);
+                    }
+                    break;
+                }
+
+                for (size_t Iter = 0; Iter < totalSize; Iter++)
+                {
+                    ScanValue(innerProp->AccessValueAddress(firstElement + Iter * elementSize), innerProp, innerKind, InOutStack);
+                }
+                break;
+            }
+            case EPropertyKind::Struct:
+                if (auto innerStruct = InProperty->GetCPPType()->structureRef.get())
+                {
+                    ScanSlots(InValue, GetReferenceSlots(innerStruct), InOutStack);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        void ScanObject(const MarkItem& InItem, MarkStack& InOutStack) const
+        {
+            auto objectAddr = (uint8_t*)InItem.Object;
+            for (auto curOffset : InItem.Pool->PointerOffsets)
+            {
+                MarkPointer(*(void**)(objectAddr + curOffset), InOutStack);
+            }
+            if (!InItem.Pool->ComplexSlots.empty())
+            {
+                InOutStack.SharedSeen.clear();
+                ScanSlots(InItem.Object, InItem.Pool->ComplexSlots, InOutStack);
+            }
+        }
+
+        void MarkTask(WorkStealingPool& InWorkPool, WorkStealingPool::TaskGroup& InGroup, uint32_t InWorker, std::vector< MarkItem >&& InItems)
+        {
+            MarkStack markStack;
+            markStack.Items = std::move(InItems);
+            auto& markItems = markStack.Items;
+            size_t markedCount = 0;
+
+            while (!markItems.empty())
+            {
+                auto curItem = markItems.back();
+                markItems.pop_back();
+                ScanObject(curItem, markStack);
+                markedCount++;
+
+                // give half away, whoever is idle steals it
+                if (markItems.size() >= settings.MarkSplitSize)
+                {
+                    std::vector< MarkItem > splitStack(markItems.begin(), markItems.begin() + markItems.size() / 2);
+                    markItems.erase(markItems.begin(), markItems.begin() + markItems.size() / 2);
+                    InWorkPool.Push(InWorker, InGroup, [this, &InWorkPool, &InGroup, splitStack = std::move(splitStack)](uint32_t InTaskWorker) mutable
+                    {
+                        MarkTask(InWorkPool, InGroup, InTaskWorker, std::move(splitStack));
+                    });
+                }
+            }
+
+            lastMarked.fetch_add(markedCount, std::memory_order_relaxed);
+        }
+
+        // roots that are managed objects get marked, the rest are only scanned
+        void ScanRoots(MarkStack& InOutStack) const
+        {
+            for (const auto& [rootObject, rootStruct] : roots)
+            {
+                MarkItem rootItem;
+                if (TryMark(rootObject, InOutStack.LastBlock, rootItem))
+                {
+                    InOutStack.Items.push_back(rootItem);
+                }
+                else if (rootStruct && !FindManaged(rootObject))
+                {
+                    ScanSlots(rootObject, GetReferenceSlots(rootStruct), InOutStack);
+                }
+            }
+        }
+
+        bool FindManaged(const void* InObject) const
+        {
+            auto foundBlock = FindBlock(InObject);
+            return foundBlock && FindSlot(foundBlock, InObject) >= 0;
+        }
+
+        // sweep from the start of everything
+        void StartSweep()
+        {
+            bSweeping = true;
+            sweepPool = 0;
+            lastFreed = 0;
+            for (auto& curPool : pools)
+            {
+                curPool->SweepBlock = 0;
+                curPool->SweepWord = 0;
+            }
+        }
+
+        void FreeSlot(Pool& InPool, CollectorBlock& InBlock, size_t InSlotIdx)
+        {
+            auto slotAddr = InBlock.FirstSlot + InSlotIdx * InPool.SlotSize;
+            InPool.Destroy(slotAddr);
+            InBlock.AllocBits[InSlotIdx / 64] &= ~(1ull << (InSlotIdx % 64));
+            *(void**)slotAddr = InPool.FreeList;
+            InPool.FreeList = slotAddr;
+            InPool.LiveCount--;
+        }
+    };
+
+    ReflectedCollector::ReflectedCollector(const CollectorSettings& InSettings) : _impl(new Impl())
+    {
+        _impl->settings = InSettings;
+        _impl->settings.MarkSplitSize = std::max< size_t >(_impl->settings.MarkSplitSize, 2);
+    }
+
+    ReflectedCollector::~ReflectedCollector()
+    {
+        for (auto& curPool : _impl->pools)
+        {
+            for (auto curBlock : curPool->Blocks)
+            {
+                for (size_t Iter = 0; Iter < curBlock->BumpSlot; Iter++)
+                {
+                    if (curBlock->AllocBits[Iter / 64] & (1ull << (Iter % 64)))
+                    {
+                        curPool->Destroy(curBlock->FirstSlot + Iter * curPool->SlotSize);
+                    }
+                }
+                curBlock->~CollectorBlock();
+                ::operator delete((void*)curBlock, std::align_val_t(CollectorBlockSize));
+            }
+        }
+    }
+
+    ReflectedCollector::Pool* ReflectedCollector::GetPool(CPPType InType, size_t InSize, size_t InAlignment, void(*InDestroy)(void*))
+    {
+        auto& poolEntry = _impl->poolsByType[InType.GetTypeData()];
+        if (poolEntry)
+        {
+            return poolEntry;
+        }
+
+        auto newPool = std::make_unique<Pool>();
+        newPool->Type = InType;
+        newPool->Struct = InType->structureRef.get();
+        newPool->SlotSize = (std::max(InSize, CollectorMinSlotSize) + InAlignment - 1) / InAlignment * InAlignment;
+        newPool->Destroy = InDestroy;
+        newPool->Index = _impl->pools.size();
+
+        if (newPool->Struct)
+        {
+            for (const auto& curSlot : GetReferenceSlots(newPool->Struct))
+            {
+                if (curSlot.Kind == EPropertyKind::Pointer)
+                {
+                    newPool->PointerOffsets.push_back((uint32_t)curSlot.Offset);
+                }
+                else
+                {
+                    newPool->ComplexSlots.push_back(curSlot);
+                }
+            }
+        }
+
+        poolEntry = newPool.get();
+        _impl->pools.push_back(std::move(newPool));
+        return poolEntry;
+    }
+
+    void* ReflectedCollector::Allocate(Pool* InPool)
+    {
+        auto& impl = *_impl;
+
+        void* oSlot = nullptr;
+        if (InPool->FreeList)
+        {
+            oSlot = InPool->FreeList;
+            InPool->FreeList = *(void**)oSlot;
+        }
+        else
+        {
+            if (InPool->Blocks.empty() || InPool->Blocks.back()->BumpSlot == InPool->Blocks.back()->SlotCount)
+            {
+                auto newBlock = new (::operator new(CollectorBlockSize, std::align_val_t(CollectorBlockSize))) CollectorBlock();
+                for (auto& curMark : newBlock->MarkBytes)
+                {
+                    curMark.store(0, std::memory_order_relaxed);
+                }
+                std::fill(std::begin(newBlock->AllocBits), std::end(newBlock->AllocBits), 0);
+
+                const size_t slotAlignment = std::min< size_t >(InPool->SlotSize & ~(InPool->SlotSize - 1), 64);
+                const size_t headerSize = (sizeof(CollectorBlock) + slotAlignment - 1) / slotAlignment * slotAlignment;
+                newBlock->Pool = InPool;
+                newBlock->FirstSlot = (uint8_t*)newBlock + headerSize;
+                newBlock->Index = (uint32_t)InPool->Blocks.size();
+                newBlock->SlotCount = (uint32_t)std::min((CollectorBlockSize - headerSize) / InPool->SlotSize, CollectorMaxSlots);
+                newBlock->SlotSize = (uint32_t)InPool->SlotSize;
+                newBlock->SlotReciprocal = ((1ull << 32) + InPool->SlotSize - 1) / InPool->SlotSize;
+
+                InPool->Blocks.push_back(newBlock);
+                impl.InsertBlock(newBlock);
+            }
+
+            auto curBlock = InPool->Blocks.back();
+            oSlot = curBlock->FirstSlot + (size_t)curBlock->BumpSlot * InPool->SlotSize;
+            curBlock->BumpSlot++;
+        }
+
+        auto slotBlock = (CollectorBlock*)((uintptr_t)oSlot & ~(uintptr_t)(CollectorBlockSize - 1));
+        const size_t slotIdx = (size_t)((uint8_t*)oSlot - slotBlock->FirstSlot) / InPool->SlotSize;
+        const uint64_t slotBit = 1ull << (slotIdx % 64);
+        slotBlock->AllocBits[slotIdx / 64] |= slotBit;
+
+        // the sweep hasn't reached it yet, make sure it doesn't take it
+        if (impl.bSweeping)
+        {
+            if (InPool->Index > impl.sweepPool ||
+                (InPool->Index == impl.sweepPool && (slotBlock->Index > InPool->SweepBlock ||
+                    (slotBlock->Index == InPool->SweepBlock && slotIdx / 64 >= InPool->SweepWord))))
+            {
+                slotBlock->MarkBytes[slotIdx].store(1, std::memory_order_relaxed);
+            }
+        }
+        // nothing points at it yet, it's reachable once stored somewhere and that store goes through WriteBarrier
+        else if (impl.bMarking)
+        {
+            slotBlock->MarkBytes[slotIdx].store(1, std::memory_order_relaxed);
+        }
+
+        InPool->LiveCount++;
+        return oSlot;
+    }
+
+    void ReflectedCollector::Release(Pool* InPool, void* InSlot)
+    {
+        auto slotBlock = (CollectorBlock*)((uintptr_t)InSlot & ~(uintptr_t)(CollectorBlockSize - 1));
+        const size_t slotIdx = (size_t)((uint8_t*)InSlot - slotBlock->FirstSlot) / InPool->SlotSize;
+        slotBlock->AllocBits[slotIdx / 64] &= ~(1ull << (slotIdx % 64));
+        slotBlock->MarkBytes[slotIdx].store(0, std::memory_order_relaxed);
+        *(void**)InSlot = InPool->FreeList;
+        InPool->FreeList = InSlot;
+        InPool->LiveCount--;
+    }
+
+    void ReflectedCollector::AddRoot(void* InObject, const ReflectedStruct* InStruct)
+    {
+        _impl->roots.push_back({ InObject, InStruct });
+    }
+
+    void ReflectedCollector::RemoveRoot(void* InObject)
+    {
+        auto& roots = _impl->roots;
+        roots.erase(std::remove_if(roots.begin(), roots.end(), [InObject](const auto& InValue) { return InValue.first == InObject; }), roots.end());
+    }
+
+    bool ReflectedCollector::IsManaged(const void* InObject) const
+    {
+        return _impl->FindManaged(InObject);
+    }
+
+    void ReflectedCollector::Mark()
+    {
+        auto& impl = *_impl;
+        SE_ASSERT(!impl.bSweeping && !impl.bMarking);
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        impl.lastMarked = 0;
+
+        MarkStack rootStack;
+        impl.ScanRoots(rootStack);
+        auto& rootItems = rootStack.Items;
+
+        auto& workPool = impl.settings.Pool ? *impl.settings.Pool : WorkStealingPool::Get();
+        const uint32_t workerCount = workPool.GetWorkerCount();
+        WorkStealingPool::TaskGroup markGroup;
+        const size_t chunkSize = std::max< size_t >(1, (rootItems.size() + workerCount - 1) / workerCount);
+        for (size_t Iter = 0, WorkerIter = 0; Iter < rootItems.size(); Iter += chunkSize, WorkerIter++)
+        {
+            std::vector< MarkItem > chunkItems(rootItems.begin() + Iter, rootItems.begin() + std::min(rootItems.size(), Iter + chunkSize));
+            workPool.Push((uint32_t)(WorkerIter % workerCount), markGroup, [&impl, &workPool, &markGroup, chunkItems = std::move(chunkItems)](uint32_t InWorker) mutable
+            {
+                impl.MarkTask(workPool, markGroup, InWorker, std::move(chunkItems));
+            });
+        }
+        workPool.RunAndWait(markGroup);
+
+        impl.lastMarkMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        impl.lastMarkStepMilliseconds = impl.lastMarkMilliseconds;
+        impl.lastMarkSteps = 1;
+
+        impl.StartSweep();
+    }
+
+    void ReflectedCollector::BeginMark()
+    {
+        auto& impl = *_impl;
+        SE_ASSERT(!impl.bSweeping && !impl.bMarking);
+
+        impl.bMarking = true;
+        impl.lastMarked = 0;
+        impl.lastMarkMilliseconds = 0;
+        impl.lastMarkStepMilliseconds = 0;
+        impl.lastMarkSteps = 0;
+        impl.incrementalStack.Items.clear();
+        impl.incrementalStack.LastBlock = nullptr;
+        impl.ScanRoots(impl.incrementalStack);
+    }
+
+    bool ReflectedCollector::MarkStep(double InMaxMilliseconds)
+    {
+        auto& impl = *_impl;
+        if (!impl.bMarking)
+        {
+            return true;
+        }
+
+        // the clock is checked every so many objects, reading it costs more than scanning one
+        constexpr size_t CheckInterval = 256;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        auto& markItems = impl.incrementalStack.Items;
+        size_t markedCount = 0;
+        bool bDone = false;
+        double stepMilliseconds = 0;
+        for (;;)
+        {
+            for (size_t Iter = 0; Iter < CheckInterval && !markItems.empty(); Iter++)
+            {
+                auto curItem = markItems.back();
+                markItems.pop_back();
+                impl.ScanObject(curItem, impl.incrementalStack);
+                markedCount++;
+            }
+
+            // roots aren't behind the barrier, whatever they hold by now is live too
+            if (markItems.empty())
+            {
+                impl.ScanRoots(impl.incrementalStack);
+                bDone = markItems.empty();
+            }
+
+            stepMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+            if (bDone || stepMilliseconds >= InMaxMilliseconds)
+            {
+                break;
+            }
+        }
+
+        impl.lastMarked.fetch_add(markedCount, std::memory_order_relaxed);
+        impl.lastMarkMilliseconds += stepMilliseconds;
+        impl.lastMarkStepMilliseconds = std::max(impl.lastMarkStepMilliseconds, stepMilliseconds);
+        impl.lastMarkSteps++;
+
+        if (bDone)
+        {
+            impl.bMarking = false;
+            impl.incrementalStack.Items.shrink_to_fit();
+            impl.StartSweep();
+        }
+        return bDone;
+    }
+
+    bool ReflectedCollector::IsMarking() const
+    {
+        return _impl->bMarking;
+    }
+
+    void ReflectedCollector::WriteBarrier(void* InPointee)
+    {
+        auto& impl = *_impl;
+        if (impl.bMarking)
+        {
+            impl.MarkPointer(InPointee, impl.incrementalStack);
+        }
+    }
+
+    bool ReflectedCollector::SweepStep(size_t InMaxObjects)
+    {
+        auto& impl = *_impl;
+        if (!impl.bSweeping)
+        {
+            return true;
+        }
+
+        size_t slotBudget = std::max< size_t >(InMaxObjects, 64);
+        while (impl.sweepPool < impl.pools.size())
+        {
+            auto& curPool = *impl.pools[impl.sweepPool];
+
+            while (curPool.SweepBlock < curPool.Blocks.size())
+            {
+                auto& curBlock = *curPool.Blocks[curPool.SweepBlock];
+                const size_t wordCount = (curBlock.BumpSlot + 63) / 64;
+
+                while (curPool.SweepWord < wordCount)
+                {
+                    if (slotBudget < 64)
+                    {
+                        return false;
+                    }
+                    slotBudget -= 64;
+
+                    const size_t wordIdx = curPool.SweepWord++;
+                    uint64_t deadBits = curBlock.AllocBits[wordIdx];
+                    // cleared first, a destructor can't allocate into this word while it's being swept
+                    for (size_t Iter = wordIdx * 64; Iter < std::min< size_t >(wordIdx * 64 + 64, curBlock.BumpSlot); Iter++)
+                    {
+                        if (curBlock.MarkBytes[Iter].load(std::memory_order_relaxed))
+                        {
+                            deadBits &= ~(1ull << (Iter % 64));
+                            curBlock.MarkBytes[Iter].store(0, std::memory_order_relaxed);
+                        }
+                    }
+
+                    while (deadBits)
+                    {
+                        const auto bitIdx = (size_t)std::countr_zero(deadBits);
+                        deadBits &= deadBits - 1;
+                        impl.FreeSlot(curPool, curBlock, wordIdx * 64 + bitIdx);
+                        impl.lastFreed++;
+                    }
+                }
+
+                curPool.SweepBlock++;
+                curPool.SweepWord = 0;
+            }
+
+            impl.sweepPool++;
+        }
+
+        impl.bSweeping = false;
+        return true;
+    }
+
+    bool ReflectedCollector::IsSweeping() const
+    {
+        return _impl->bSweeping;
+    }
+
+    void ReflectedCollector::Collect()
+    {
+        // finish a mark or sweep in flight, Mark needs clear mark bits
+        while (!MarkStep(std::numeric_limits<double>::max())) {}
+        while (!SweepStep()) {}
+        Mark();
+        while (!SweepStep()) {}
+    }
+
+    CollectorStats ReflectedCollector::GetStats() const
+    {
+        CollectorStats oStats;
+        oStats.PoolCount = _impl->pools.size();
+        for (const auto& curPool : _impl->pools)
+        {
+            oStats.LiveObjects += curPool->LiveCount;
+            oStats.BlockCount += curPool->Blocks.size();
+        }
+        oStats.BlockBytes = oStats.BlockCount * CollectorBlockSize;
+        oStats.LastMarkMilliseconds = _impl->lastMarkMilliseconds;
+        oStats.LastMarkStepMilliseconds = _impl->lastMarkStepMilliseconds;
+        oStats.LastMarkSteps = _impl->lastMarkSteps;
+        oStats.LastMarked = _impl->lastMarked.load();
+        oStats.LastFreed = _impl->lastFreed;
+        return oStats;
+    }
+}
@@ -0,0 +1,531 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPRGraph.h"
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <bit>
+
+namespace SPP
+{
+    ////////////////////////////////////////////
+    //
+    // REFERENCE SLOTS
+    //
+    ////////////////////////////////////////////
+
+    struct ReferenceSlotCache
+    {
+        // recursive, building a struct's slots asks for the slots of its array element structs
+        std::recursive_mutex lock;
+        std::unordered_map< const ReflectedStruct*, std::unique_ptr< std::vector< ReferenceSlot > > > slots;
+        std::unordered_set< const ReflectedStruct* > building;
+    };
+
+    static ReferenceSlotCache& GetReferenceSlotCache()
+    {
+        static ReferenceSlotCache sO;
+        return sO;
+    }
+
+    static bool HoldsReferences(ReflectedProperty* InProperty);
+
+    static bool StructHoldsReferences(const ReflectedStruct* InStruct)
+    {
+        if (!InStruct)
+        {
+            return false;
+        }
+        // a struct reached again while its own slots are being built (vector of itself), assume it does
+        if (GetReferenceSlotCache().building.count(InStruct))
+        {
+            return true;
+        }
+        return !GetReferenceSlots(InStruct).empty();
+    }
+
+    static bool HoldsReferences(ReflectedProperty* InProperty)
+    {
+        switch (InProperty->GetKind())
+        {
+        case EPropertyKind::Pointer:
+            return true;
+        case EPropertyKind::UniquePtr:
+        case EPropertyKind::Wrapped:
+            // an owned struct is an object of its own
+            return InProperty->GetInner()->GetKind() == EPropertyKind::Struct || HoldsReferences(InProperty->GetInner());
+        case EPropertyKind::Variant:
+        {
+            auto variantProp = static_cast<VariantProperty*>(InProperty);
+            for (size_t Iter = 0; Iter < variantProp->GetAlternativeCount(); Iter++)
+            {
+                if (HoldsReferences(variantProp->GetAlternative(Iter)))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+        case EPropertyKind::DynamicArray:
+            return HoldsReferences(InProperty->GetInner());
+        case EPropertyKind::Map:
+        {
+            auto mapProp = static_cast<MapProperty*>(InProperty);
+            return HoldsReferences(mapProp->GetKey()) || (mapProp->GetValue() && HoldsReferences(mapProp->GetValue()));
+        }
+        case EPropertyKind::Struct:
+            return StructHoldsReferences(InProperty->GetCPPType()->structureRef.get());
+        default:
+            return false;
+        }
+    }
+
+    static void BuildReferenceSlots(const ReflectedStruct* InStruct, size_t InBaseOffset, std::vector< ReferenceSlot >& OutSlots)
+    {
+        InStruct->IterateProperties([&](ReflectedProperty* InProperty)
+        {
+            // accessors point at plain data
+            if (InProperty->IsAccessorBased())
+            {
+                return;
+            }
+
+            const auto propKind = InProperty->GetKind();
+            const size_t propOffset = InBaseOffset + InProperty->GetPropOffset();
+
+            if (propKind == EPropertyKind::Struct)
+            {
+                if (auto nestedStruct = InProperty->GetCPPType()->structureRef.get())
+                {
+                    BuildReferenceSlots(nestedStruct, propOffset, OutSlots);
+                }
+            }
+            else if (HoldsReferences(InProperty))
+            {
+                OutSlots.push_back({ propOffset, InProperty, propKind });
+            }
+        });
+    }
+
+    const std::vector< ReferenceSlot >& GetReferenceSlots(const ReflectedStruct* InStruct)
+    {
+        auto& slotCache = GetReferenceSlotCache();
+        std::unique_lock<std::recursive_mutex> lock(slotCache.lock);
+
+        auto foundSlots = slotCache.slots.find(InStruct);
+        if (foundSlots != slotCache.slots.end())
+        {
+            return *foundSlots->second;
+        }
+
+        auto newSlots = std::make_unique< std::vector< ReferenceSlot > >();
+        slotCache.building.insert(InStruct);
+        BuildReferenceSlots(InStruct, 0, *newSlots);
+        slotCache.building.erase(InStruct);
+
+        return *(slotCache.slots[InStruct] = std::move(newSlots));
+    }
+
+    ////////////////////////////////////////////
+    //
+    // WALKER
+    //
+    ////////////////////////////////////////////
+
+    struct ReflectedGraphWalker::Impl
+    {
+        GraphWalkSettings settings;
+
+        std::vector< GraphNode > nodes;
+        // next node to hand out, and next to expand (everything before it had its references followed)
+        size_t head = 0;
+        size_t expanded = 0;
+        size_t revisits = 0;
+
+        std::vector< std::pair<uint32_t, uint32_t> > edges;
+
+        // visited set, address -> node index, linear probing at under half load
+        std::vector< void* > visitedKeys;
+        std::vector< uint32_t > visitedValues;
+        uint32_t visitedShift = 64;
+
+        // graphs are mostly a handful of types, skip the shared cache lock per node
+        const ReflectedStruct* lastStruct = nullptr;
+        const std::vector< ReferenceSlot >* lastSlots = nullptr;
+        std::unordered_map< const ReflectedStruct*, const std::vector< ReferenceSlot >* > slotsByStruct;
+
+        size_t HashSlot(void* InObject) const
+        {
+            return (size_t)(((uint64_t)(uintptr_t)InObject * 0x9E3779B97F4A7C15ull) >> visitedShift);
+        }
+
+        void GrowVisited()
+        {
+            const size_t newCapacity = visitedKeys.empty() ? 1024 : visitedKeys.size() * 2;
+
+            std::vector< void* > oldKeys(newCapacity, nullptr);
+            std::vector< uint32_t > oldValues(newCapacity, 0);
+            oldKeys.swap(visitedKeys);
+            oldValues.swap(visitedValues);
+            visitedShift = 64 - (uint32_t)std::countr_zero(newCapacity);
+
+            const size_t slotMask = newCapacity - 1;
+            for (size_t Iter = 0; Iter < oldKeys.size(); Iter++)
+            {
+                if (oldKeys[Iter])
+                {
+                    size_t curSlot = HashSlot(oldKeys[Iter]);
+                    while (visitedKeys[curSlot])
+                    {
+                        curSlot = (curSlot + 1) & slotMask;
+                    }
+                    visitedKeys[curSlot] = oldKeys[Iter];
+                    visitedValues[curSlot] = oldValues[Iter];
+                }
+            }
+        }
+
+        const std::vector< ReferenceSlot >& GetSlots(const ReflectedStruct* InStruct)
+        {
+            if (InStruct != lastStruct)
+            {
+                auto& cachedSlots = slotsByStruct[InStruct];
+                if (!cachedSlots)
+                {
+                    cachedSlots = &GetReferenceSlots(InStruct);
+                }
+                lastStruct = InStruct;
+                lastSlots = cachedSlots;
+            }
+            return *lastSlots;
+        }
+
+        // true if new
+        bool Discover(void* InObject, const ReflectedStruct* InStruct, uint32_t InParent)
+        {
+            if ((nodes.size() + 1) * 2 > visitedKeys.size())
+            {
+                GrowVisited();
+            }
+
+            const size_t slotMask = visitedKeys.size() - 1;
+            size_t curSlot = HashSlot(InObject);
+            while (visitedKeys[curSlot])
+            {
+                if (visitedKeys[curSlot] == InObject)
+                {
+                    revisits++;
+                    if (settings.bRecordEdges && InParent != GraphNoParent)
+                    {
+                        edges.push_back({ InParent, visitedValues[curSlot] });
+                    }
+                    return false;
+                }
+                curSlot = (curSlot + 1) & slotMask;
+            }
+
+            const auto newIdx = (uint32_t)nodes.size();
+            visitedKeys[curSlot] = InObject;
+            visitedValues[curSlot] = newIdx;
+            nodes.push_back({ InObject, InStruct, InParent == GraphNoParent ? 0 : nodes[InParent].Depth + 1, InParent });
+
+            if (settings.bRecordEdges && InParent != GraphNoParent)
+            {
+                edges.push_back({ InParent, newIdx });
+            }
+            return true;
+        }
+
+        void ExpandStruct(void* InObject, const ReflectedStruct* InStruct, uint32_t InParent)
+        {
+            for (const auto& curSlot : GetSlots(InStruct))
+            {
+                ExpandValue((uint8_t*)InObject + curSlot.Offset, curSlot.Property, curSlot.Kind, InParent);
+            }
+        }
+
+        // InValue is the address of the property's value
+        void ExpandValue(void* InValue, ReflectedProperty* InProperty, EPropertyKind InKind, uint32_t InParent)
+        {
+            switch (InKind)
+            {
+            case EPropertyKind::Pointer:
+            {
+                auto pointee = *(void**)InValue;
+                if (pointee)
+                {
+                    auto pointeeType = static_cast<PointerProperty*>(InProperty)->ResolvePointeeType(pointee);
+                    if (pointeeType.GetTypeData() && pointeeType->structureRef)
+                    {
+                        Discover(pointee, pointeeType->structureRef.get(), InParent);
+                    }
+                }
+                break;
+            }
+            case EPropertyKind::UniquePtr:
+            case EPropertyKind::Wrapped:
+            {
+                auto wrapManipulator = static_cast<WrapProperty*>(InProperty)->GetWrap();
+                auto target = wrapManipulator->Get(InValue);
+                if (!target)
+                {
+                    break;
+                }
+
+                // an optional's struct is inline, part of the object that holds it
+                auto innerProp = InProperty->GetInner();
+                if (innerProp->GetKind() == EPropertyKind::Struct && wrapManipulator->Kind != EWrapKind::Optional)
+                {
+                    Discover(target, innerProp->GetCPPType()->structureRef.get(), InParent);
+                }
+                else
+                {
+                    ExpandValue(innerProp->AccessValueAddress(target), innerProp, innerProp->GetKind(), InParent);
+                }
+                break;
+            }
+            case EPropertyKind::Variant:
+            {
+                void* activeValue = nullptr;
+                if (auto activeProp = static_cast<VariantProperty*>(InProperty)->GetActive(InValue, activeValue))
+                {
+                    ExpandValue(activeProp->AccessValueAddress(activeValue), activeProp, activeProp->GetKind(), InParent);
+                }
+                break;
+            }
+            case EPropertyKind::Map:
+            {
+                // walked in key order when the property asks for it, so node order repeats across runs
+                auto mapProp = static_cast<MapProperty*>(InProperty);
+                auto keyProp = mapProp->GetKey();
+                auto valueProp = mapProp->GetValue();
+
+                std::vector< MapEntry > mapEntries;
+                mapProp->GetEntries(InValue, mapEntries, mapProp->IsDeterministic());
+                for (const auto& curEntry : mapEntries)
+                {
+                    ExpandValue(keyProp->AccessValueAddress((void*)curEntry.Key), keyProp, keyProp->GetKind(), InParent);
+                    if (valueProp)
+                    {
+                        ExpandValue(valueProp->AccessValueAddress(curEntry.Value), valueProp, valueProp->GetKind(), InParent);
+                    }
+                }
+                break;
+            }
+            case EPropertyKind::DynamicArray:
+            {
+                auto arrayManipulator = InProperty->GetCPPType()->arrayManipulator.get();
+                const size_t totalSize = arrayManipulator->Size(InValue);
+                if (!totalSize)
+                {
+                    break;
+                }
+
+                auto innerProp = InProperty->GetInner();
+                const auto innerKind = innerProp->GetKind();
+                auto firstElement = (uint8_t*)arrayManipulator->Element(InValue, 0);
+                const size_t elementSize = innerProp->GetCPPType()->get_sizeof;
+
+                for (size_t Iter = 0; Iter < totalSize; Iter++)
+                {
+                    ExpandValue(innerProp->AccessValueAddress(firstElement + Iter * elementSize), innerProp, innerKind, InParent);
+                }
+                break;
+            }
+            case EPropertyKind::Struct:
+                // inline in an array element, optional or variant, part of the object that holds it
+                ExpandStruct(InValue, InProperty->GetCPPType()->structureRef.get(), InParent);
+                break;
+            default:
+                break;
+            }
+        }
+    };
+
+    ReflectedGraphWalker::ReflectedGraphWalker(const GraphWalkSettings& InSettings) : _impl(new Impl())
+    {
+        _impl->settings = InSettings;
+        _impl->settings.MaxBatchSize = std::max< size_t >(_impl->settings.MaxBatchSize, 1);
+        _impl->nodes.reserve(InSettings.ReserveNodes);
+    }
+
+    ReflectedGraphWalker::~ReflectedGraphWalker()
+    {
+    }
+
+    bool ReflectedGraphWalker::AddRoot(void* InObject, const ReflectedStruct* InStruct)
+    {
+        SE_ASSERT(InObject && InStruct);
+        return _impl->Discover(InObject, InStruct, GraphNoParent);
+    }
+
+    std::span< const GraphNode > ReflectedGraphWalker::NextBatch()
+    {
+        auto& impl = *_impl;
+
+        // follow everything already handed out
+        for (; impl.expanded < impl.head; impl.expanded++)
+        {
+            const auto curNode = impl.nodes[impl.expanded];
+            impl.ExpandStruct(curNode.Object, curNode.Struct, (uint32_t)impl.expanded);
+        }
+
+        const size_t batchStart = impl.head;
+        if (batchStart >= impl.nodes.size())
+        {
+            return {};
+        }
+
+        const uint32_t batchDepth = impl.nodes[batchStart].Depth;
+        const size_t batchLimit = std::min(impl.nodes.size(), batchStart + impl.settings.MaxBatchSize);
+
+        size_t batchEnd = batchStart + 1;
+        while (batchEnd < batchLimit && impl.nodes[batchEnd].Depth == batchDepth)
+        {
+            batchEnd++;
+        }
+
+        impl.head = batchEnd;
+        return std::span< const GraphNode >(impl.nodes.data() + batchStart, batchEnd - batchStart);
+    }
+
+    void ReflectedGraphWalker::Walk(const std::function< void(std::span< const GraphNode >) >& InFunc)
+    {
+        for (auto curBatch = NextBatch(); !curBatch.empty(); curBatch = NextBatch())
+        {
+            InFunc(curBatch);
+        }
+    }
+
+    std::span< const GraphNode > ReflectedGraphWalker::GetNodes() const
+    {
+        return std::span< const GraphNode >(_impl->nodes.data(), _impl->nodes.size());
+    }
+
+    size_t ReflectedGraphWalker::GetVisitedCount() const
+    {
+        return _impl->nodes.size();
+    }
+
+    size_t ReflectedGraphWalker::GetRevisitCount() const
+    {
+        return _impl->revisits;
+    }
+
+    // Tarjan's strongly connected components, iterative so deep chains don't overflow the stack
+    std::vector< std::vector< uint32_t > > ReflectedGraphWalker::FindCycles() const
+    {
+        std::vector< std::vector< uint32_t > > oCycles;
+
+        const auto& impl = *_impl;
+        SE_ASSERT(impl.settings.bRecordEdges);
+        const uint32_t nodeCount = (uint32_t)impl.nodes.size();
+
+        // edges as compressed rows
+        std::vector< uint32_t > edgeStart(nodeCount + 1, 0);
+        for (const auto& curEdge : impl.edges)
+        {
+            edgeStart[curEdge.first + 1]++;
+        }
+        for (uint32_t Iter = 0; Iter < nodeCount; Iter++)
+        {
+            edgeStart[Iter + 1] += edgeStart[Iter];
+        }
+        std::vector< uint32_t > edgeTargets(impl.edges.size());
+        {
+            std::vector< uint32_t > edgeCursor(edgeStart.begin(), edgeStart.end() - 1);
+            for (const auto& curEdge : impl.edges)
+            {
+                edgeTargets[edgeCursor[curEdge.first]++] = curEdge.second;
+            }
+        }
+
+        constexpr uint32_t Unvisited = ~0u;
+        std::vector< uint32_t > nodeIndex(nodeCount, Unvisited);
+        std::vector< uint32_t > nodeLow(nodeCount, 0);
+        std::vector< uint8_t > onStack(nodeCount, 0);
+        std::vector< uint32_t > componentStack;
+        // node, next edge to look at
+        std::vector< std::pair<uint32_t, uint32_t> > callStack;
+        uint32_t nextIndex = 0;
+
+        auto pushNode = [&](uint32_t InNode)
+        {
+            nodeIndex[InNode] = nodeLow[InNode] = nextIndex++;
+            componentStack.push_back(InNode);
+            onStack[InNode] = 1;
+            callStack.push_back({ InNode, edgeStart[InNode] });
+        };
+
+        for (uint32_t StartNode = 0; StartNode < nodeCount; StartNode++)
+        {
+            if (nodeIndex[StartNode] != Unvisited)
+            {
+                continue;
+            }
+
+            pushNode(StartNode);
+            while (!callStack.empty())
+            {
+                const uint32_t curNode = callStack.back().first;
+                const uint32_t curEdge = callStack.back().second;
+
+                if (curEdge < edgeStart[curNode + 1])
+                {
+                    callStack.back().second++;
+                    const uint32_t targetNode = edgeTargets[curEdge];
+                    if (nodeIndex[targetNode] == Unvisited)
+                    {
+                        pushNode(targetNode);
+                    }
+                    else if (onStack[targetNode])
+                    {
+                        nodeLow[curNode] = std::min(nodeLow[curNode], nodeIndex[targetNode]);
+                    }
+                    continue;
+                }
+
+                if (nodeLow[curNode] == nodeIndex[curNode])
+                {
+                    std::vector< uint32_t > component;
+                    uint32_t poppedNode;
+                    do
+                    {
+                        poppedNode = componentStack.back();
+                        componentStack.pop_back();
+                        onStack[poppedNode] = 0;
+                        component.push_back(poppedNode);
+                    } while (poppedNode != curNode);
+
+                    bool bIsCycle = component.size() > 1;
+                    for (uint32_t EdgeIter = edgeStart[curNode]; !bIsCycle && EdgeIter < edgeStart[curNode + 1]; EdgeIter++)
+                    {
+                        bIsCycle = edgeTargets[EdgeIter] == curNode;
+                    }
+                    if (bIsCycle)
+                    {
+                        oCycles.push_back(std::move(component));
+                    }
+                }
+
+                callStack.pop_back();
+                if (!callStack.empty())
+                {
+                    const uint32_t callerNode = callStack.back().first;
+                    nodeLow[callerNode] = std::min(nodeLow[callerNode], nodeLow[curNode]);
+                }
+            }
+        }
+
+        return oCycles;
+    }
+
+    void ReflectedGraphWalker::Reset()
+    {
+        auto settings = _impl->settings;
+        _impl = std::make_unique<Impl>();
+        _impl->settings = settings;
+    }
+}
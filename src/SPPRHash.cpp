@@ -0,0 +1,235 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPReflection.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SPP_HASH_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define SPP_HASH_SSE2 0
+#endif
+
+namespace SPP
+{
+    namespace HashConsts
+    {
+        static constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+        static constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+        static constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+        static constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+        static constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+        static constexpr uint32_t PRIME32_1 = 0x9E3779B1U;
+
+        static constexpr size_t StripeSize = 64;
+        static constexpr size_t StripeLanes = 8;
+        static constexpr size_t StripesPerScramble = 16;
+
+        alignas(16) static constexpr uint64_t StripeKey[StripeLanes] = {
+            0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+            0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL, 0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL
+        };
+        alignas(16) static constexpr uint64_t ScrambleKey[StripeLanes] = {
+            0xcb00c391bb52283cULL, 0xa32e531b8b65d088ULL, 0x4ef90da297486471ULL, 0xd8acdea946ef1938ULL,
+            0x3f349ce33f76faa8ULL, 0x1d4f0bc7c7bbdcf9ULL, 0x3159b4cd4be0518aULL, 0x647378d9c97e9fc8ULL
+        };
+    }
+
+    using namespace HashConsts;
+
+    static inline uint64_t Read64(const uint8_t* InData)
+    {
+        uint64_t oValue;
+        std::memcpy(&oValue, InData, sizeof(oValue));
+        return oValue;
+    }
+
+    static inline uint32_t Read32(const uint8_t* InData)
+    {
+        uint32_t oValue;
+        std::memcpy(&oValue, InData, sizeof(oValue));
+        return oValue;
+    }
+
+    static inline uint64_t RotL64(uint64_t InValue, int32_t InBits)
+    {
+        return (InValue << InBits) | (InValue >> (64 - InBits));
+    }
+
+    static inline uint64_t Avalanche(uint64_t InHash)
+    {
+        InHash ^= InHash >> 33;
+        InHash *= PRIME64_2;
+        InHash ^= InHash >> 29;
+        InHash *= PRIME64_3;
+        InHash ^= InHash >> 32;
+        return InHash;
+    }
+
+    static inline uint64_t Round(uint64_t InAcc, uint64_t InInput)
+    {
+        InAcc += InInput * PRIME64_2;
+        InAcc = RotL64(InAcc, 31);
+        return InAcc * PRIME64_1;
+    }
+
+    // acc[i] += lo32(data ^ key) * hi32(data ^ key) + data[i ^ 1]
+    static inline void AccumulateStripe_Scalar(uint64_t* InOutAcc, const uint8_t* InData)
+    {
+        for (size_t Iter = 0; Iter < StripeLanes; Iter++)
+        {
+            const uint64_t dataVal = Read64(InData + Iter * 8);
+            const uint64_t dataKey = dataVal ^ StripeKey[Iter];
+            InOutAcc[Iter ^ 1] += dataVal;
+            InOutAcc[Iter] += (dataKey & 0xFFFFFFFFULL) * (dataKey >> 32);
+        }
+    }
+
+    static inline void ScrambleAcc_Scalar(uint64_t* InOutAcc)
+    {
+        for (size_t Iter = 0; Iter < StripeLanes; Iter++)
+        {
+            uint64_t curAcc = InOutAcc[Iter];
+            curAcc ^= curAcc >> 47;
+            curAcc ^= ScrambleKey[Iter];
+            InOutAcc[Iter] = curAcc * PRIME32_1;
+        }
+    }
+
+#if SPP_HASH_SSE2
+    static inline void AccumulateStripe_SSE2(__m128i* InOutAcc, const uint8_t* InData)
+    {
+        for (size_t Iter = 0; Iter < StripeLanes / 2; Iter++)
+        {
+            const __m128i dataVal = _mm_loadu_si128((const __m128i*)(InData + Iter * 16));
+            const __m128i keyVal = _mm_load_si128((const __m128i*)(StripeKey + Iter * 2));
+            const __m128i dataKey = _mm_xor_si128(dataVal, keyVal);
+            const __m128i dataKeyHi = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(3, 3, 1, 1));
+            const __m128i product = _mm_mul_epu32(dataKey, dataKeyHi);
+            const __m128i dataSwap = _mm_shuffle_epi32(dataVal, _MM_SHUFFLE(1, 0, 3, 2));
+            InOutAcc[Iter] = _mm_add_epi64(InOutAcc[Iter], _mm_add_epi64(product, dataSwap));
+        }
+    }
+
+    static inline void ScrambleAcc_SSE2(__m128i* InOutAcc)
+    {
+        const __m128i prime = _mm_set1_epi32((int)PRIME32_1);
+        for (size_t Iter = 0; Iter < StripeLanes / 2; Iter++)
+        {
+            __m128i curAcc = InOutAcc[Iter];
+            curAcc = _mm_xor_si128(curAcc, _mm_srli_epi64(curAcc, 47));
+            curAcc = _mm_xor_si128(curAcc, _mm_load_si128((const __m128i*)(ScrambleKey + Iter * 2)));
+            const __m128i productLo = _mm_mul_epu32(curAcc, prime);
+            const __m128i productHi = _mm_mul_epu32(_mm_srli_epi64(curAcc, 32), prime);
+            InOutAcc[Iter] = _mm_add_epi64(productLo, _mm_slli_epi64(productHi, 32));
+        }
+    }
+#endif
+
+    // returns the bytes consumed (whole stripes only)
+    static size_t HashStripes(const uint8_t* InData, size_t InSize, uint64_t InSeed, uint64_t* OutAcc)
+    {
+        const size_t stripeCount = InSize / StripeSize;
+
+        alignas(16) uint64_t accs[StripeLanes] = {
+            InSeed + PRIME64_1 + PRIME64_2, InSeed + PRIME64_2, InSeed, InSeed - PRIME64_1,
+            InSeed ^ PRIME64_3, InSeed + PRIME64_4, InSeed ^ PRIME64_5, InSeed - PRIME64_4
+        };
+
+#if SPP_HASH_SSE2
+        __m128i simdAcc[StripeLanes / 2];
+        for (size_t Iter = 0; Iter < StripeLanes / 2; Iter++)
+        {
+            simdAcc[Iter] = _mm_load_si128((const __m128i*)(accs + Iter * 2));
+        }
+        for (size_t Iter = 0; Iter < stripeCount; Iter++)
+        {
+            AccumulateStripe_SSE2(simdAcc, InData + Iter * StripeSize);
+            if ((Iter + 1) % StripesPerScramble == 0)
+            {
+                ScrambleAcc_SSE2(simdAcc);
+            }
+        }
+        for (size_t Iter = 0; Iter < StripeLanes / 2; Iter++)
+        {
+            _mm_store_si128((__m128i*)(accs + Iter * 2), simdAcc[Iter]);
+        }
+#else
+        for (size_t Iter = 0; Iter < stripeCount; Iter++)
+        {
+            AccumulateStripe_Scalar(accs, InData + Iter * StripeSize);
+            if ((Iter + 1) % StripesPerScramble == 0)
+            {
+                ScrambleAcc_Scalar(accs);
+            }
+        }
+#endif
+        std::memcpy(OutAcc, accs, sizeof(accs));
+        return stripeCount * StripeSize;
+    }
+
+    uint64_t HashBytes(const void* InData, size_t InSize, uint64_t InSeed)
+    {
+        auto curData = (const uint8_t*)InData;
+        auto endData = curData + InSize;
+        uint64_t oHash = InSeed + PRIME64_5;
+
+        if (InSize >= StripeSize)
+        {
+            uint64_t accs[StripeLanes];
+            curData += HashStripes(curData, InSize, InSeed, accs);
+
+            oHash = 0;
+            for (size_t Iter = 0; Iter < StripeLanes; Iter++)
+            {
+                oHash = Round(oHash, accs[Iter]) ^ RotL64(oHash, 27);
+            }
+        }
+
+        oHash += (uint64_t)InSize;
+
+        // tail, same as xxh64
+        while (curData + 8 <= endData)
+        {
+            oHash ^= Round(0, Read64(curData));
+            oHash = RotL64(oHash, 27) * PRIME64_1 + PRIME64_4;
+            curData += 8;
+        }
+        if (curData + 4 <= endData)
+        {
+            oHash ^= (uint64_t)Read32(curData) * PRIME64_1;
+            oHash = RotL64(oHash, 23) * PRIME64_2 + PRIME64_3;
+            curData += 4;
+        }
+        while (curData < endData)
+        {
+            oHash ^= (*curData) * PRIME64_5;
+            oHash = RotL64(oHash, 11) * PRIME64_1;
+            curData++;
+        }
+
+        return Avalanche(oHash);
+    }
+
+    bool BytesEqual(const void* InA, const void* InB, size_t InSize)
+    {
+        auto curA = (const uint8_t*)InA;
+        auto curB = (const uint8_t*)InB;
+        size_t Iter = 0;
+
+#if SPP_HASH_SSE2
+        for (; Iter + 16 <= InSize; Iter += 16)
+        {
+            const __m128i valA = _mm_loadu_si128((const __m128i*)(curA + Iter));
+            const __m128i valB = _mm_loadu_si128((const __m128i*)(curB + Iter));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(valA, valB)) != 0xFFFF)
+            {
+                return false;
+            }
+        }
+#endif
+        return std::memcmp(curA + Iter, curB + Iter, InSize - Iter) == 0;
+    }
+}
@@ -0,0 +1,579 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPReflection.h"
+#include <mutex>
+#include <fstream>
+#include <unordered_map>
+
+namespace SPP
+{
+    std::atomic<uint32_t> GReflectionInstrumentMode{ InstrumentMode::Off };
+
+    // per thread cap on kept trace events, counters keep going once it's hit
+    static constexpr size_t MaxTraceEventsPerThread = 1 << 18;
+
+    static std::array< const char*, (size_t)EReflectionCounter::COUNT > constexpr CONST_CounterNames = {
+        "Invoke",
+        "Visit",
+        "TypeRegistration",
+        "NameLookup",
+        "OverloadMatchFail"
+    };
+
+    const char* GetReflectionCounterName(EReflectionCounter InCounter)
+    {
+        return InCounter < EReflectionCounter::COUNT ? CONST_CounterNames[(size_t)InCounter] : "";
+    }
+
+    void SetReflectionInstrumentMode(uint32_t InMode)
+    {
+        // trace implies counters
+        if (InMode & InstrumentMode::Trace)
+        {
+            InMode |= InstrumentMode::Counters;
+        }
+        GReflectionInstrumentMode.store(InMode, std::memory_order_relaxed);
+    }
+
+    struct StatKey
+    {
+        EReflectionCounter Counter;
+        const void* Key;
+
+        bool operator==(const StatKey& InValue) const
+        {
+            return Counter == InValue.Counter && Key == InValue.Key;
+        }
+    };
+
+    struct StatKeyHash
+    {
+        size_t operator()(const StatKey& InValue) const
+        {
+            return std::hash<const void*>()(InValue.Key) ^ ((size_t)InValue.Counter * 0x9E3779B97F4A7C15ull);
+        }
+    };
+
+    // Single writer, lock free readers: the owning thread fills the next item and then publishes it with a 
+    // release store of the count, readers only look at the published ones. Items never move or get freed until
+    // the log goes away.
+    template<typename T, size_t ChunkItems>
+    class PublishedLog
+    {
+    private:
+        struct Chunk
+        {
+            std::array< T, ChunkItems > Items;
+            // set before the first item in the next chunk is published
+            Chunk* Next = nullptr;
+        };
+
+        Chunk* _head = nullptr;
+        Chunk* _tail = nullptr;
+        std::atomic<size_t> _count{ 0 };
+
+    public:
+        PublishedLog() = default;
+        PublishedLog(const PublishedLog&) = delete;
+        PublishedLog& operator=(const PublishedLog&) = delete;
+
+        ~PublishedLog()
+        {
+            while (_head)
+            {
+                auto nextChunk = _head->Next;
+                delete _head;
+                _head = nextChunk;
+            }
+        }
+
+        size_t GetCount() const
+        {
+            return _count.load(std::memory_order_acquire);
+        }
+
+        // writer only, fill it in and Publish before asking for another
+        T& Next()
+        {
+            const size_t curCount = _count.load(std::memory_order_relaxed);
+            if (curCount % ChunkItems == 0)
+            {
+                auto newChunk = new Chunk();
+                if (_tail)
+                {
+                    _tail->Next = newChunk;
+                }
+                else
+                {
+                    _head = newChunk;
+                }
+                _tail = newChunk;
+            }
+            return _tail->Items[curCount % ChunkItems];
+        }
+
+        void Publish()
+        {
+            _count.store(_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // published items from InStart on
+        template<typename FuncT>
+        void ForEach(size_t InStart, FuncT&& InFunc) const
+        {
+            const size_t curCount = GetCount();
+            auto curChunk = _head;
+            for (size_t Iter = 0; curChunk && Iter + ChunkItems <= InStart; Iter += ChunkItems)
+            {
+                curChunk = curChunk->Next;
+            }
+            for (size_t Iter = InStart; Iter < curCount; Iter++)
+            {
+                if (Iter != InStart && Iter % ChunkItems == 0)
+                {
+                    curChunk = curChunk->Next;
+                }
+                InFunc(curChunk->Items[Iter % ChunkItems]);
+            }
+        }
+    };
+
+    // the name is written once before the slot is published, the numbers only by the owning thread
+    struct StatSlot
+    {
+        EReflectionCounter Counter = EReflectionCounter::COUNT;
+        const void* Key = nullptr;
+        std::string Name;
+        std::atomic<uint64_t> Count{ 0 };
+        std::atomic<uint64_t> TotalNs{ 0 };
+        std::atomic<uint64_t> MaxNs{ 0 };
+    };
+
+    struct TraceEvent
+    {
+        const StatSlot* Stat = nullptr;
+        uint64_t StartNs = 0;
+        uint64_t DurationNs = 0;
+    };
+
+    // events of threads that have exited, the name points into InstrumentRegistry::retiredStats
+    struct RetiredTraceEvent
+    {
+        uint32_t ThreadIndex = 0;
+        EReflectionCounter Counter = EReflectionCounter::COUNT;
+        const std::string* Name = nullptr;
+        uint64_t StartNs = 0;
+        uint64_t DurationNs = 0;
+    };
+
+    // bumped by ResetReflectionStats, each thread clears its own records when it sees a new one
+    static std::atomic<uint32_t> GInstrumentResetGeneration{ 0 };
+
+    // only its own thread writes, readers never block it
+    struct ThreadInstrument
+    {
+        uint32_t ThreadIndex = 0;
+
+        // owning thread only
+        std::unordered_map< StatKey, StatSlot*, StatKeyHash > slotLookup;
+
+        PublishedLog< StatSlot, 64 > slots;
+        PublishedLog< TraceEvent, 1024 > events;
+        // events before it were recorded before the last reset
+        std::atomic<size_t> eventsStart{ 0 };
+        std::atomic<uint64_t> droppedEvents{ 0 };
+        // the reset generation the published numbers belong to, readers skip the thread until it catches up
+        std::atomic<uint32_t> resetGeneration{ 0 };
+
+        bool IsCurrent() const
+        {
+            return resetGeneration.load(std::memory_order_acquire) == GInstrumentResetGeneration.load(std::memory_order_acquire);
+        }
+    };
+
+    // live threads, and the merged records of the ones that have exited
+    struct InstrumentRegistry
+    {
+        std::mutex lock;
+        std::vector< ThreadInstrument* > threads;
+        uint32_t nextThreadIndex = 1;
+
+        std::unordered_map< StatKey, ReflectionStat, StatKeyHash > retiredStats;
+        std::vector< RetiredTraceEvent > retiredEvents;
+        uint64_t retiredDroppedEvents = 0;
+    };
+
+    static InstrumentRegistry& GetInstrumentRegistry()
+    {
+        // leaked, threads may still record during static destruction
+        static InstrumentRegistry* sO = new InstrumentRegistry();
+        return *sO;
+    }
+
+    static void AddStat(std::unordered_map< StatKey, ReflectionStat, StatKeyHash >& InOutStats, const StatKey& InKey, 
+        const std::string& InName, uint64_t InCount, uint64_t InTotalNs, uint64_t InMaxNs)
+    {
+        auto [foundStat, bInserted] = InOutStats.try_emplace(InKey);
+        auto& curStat = foundStat->second;
+        if (bInserted)
+        {
+            curStat.Counter = InKey.Counter;
+            curStat.Key = InKey.Key;
+            curStat.Name = InName;
+        }
+        curStat.Count += InCount;
+        curStat.TotalNs += InTotalNs;
+        curStat.MaxNs = std::max(curStat.MaxNs, InMaxNs);
+    }
+
+    // called on the exiting thread, folds its records into the registry so it can be freed
+    static void RetireThreadInstrument(ThreadInstrument* InThread)
+    {
+        auto& registry = GetInstrumentRegistry();
+        std::unique_lock<std::mutex> registryLock(registry.lock);
+
+        registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), InThread));
+
+        if (InThread->IsCurrent())
+        {
+            InThread->slots.ForEach(0, [&](const StatSlot& InSlot)
+            {
+                if (const auto slotCount = InSlot.Count.load(std::memory_order_relaxed))
+                {
+                    AddStat(registry.retiredStats, StatKey{ InSlot.Counter, InSlot.Key }, InSlot.Name, slotCount,
+                        InSlot.TotalNs.load(std::memory_order_relaxed), InSlot.MaxNs.load(std::memory_order_relaxed));
+                }
+            });
+
+            InThread->events.ForEach(InThread->eventsStart.load(std::memory_order_relaxed), [&](const TraceEvent& InEvent)
+            {
+                if (registry.retiredEvents.size() >= MaxTraceEventsPerThread)
+                {
+                    registry.retiredDroppedEvents++;
+                    return;
+                }
+                auto& retiredStat = registry.retiredStats[StatKey{ InEvent.Stat->Counter, InEvent.Stat->Key }];
+                registry.retiredEvents.push_back(RetiredTraceEvent{ InThread->ThreadIndex, InEvent.Stat->Counter, 
+                    &retiredStat.Name, InEvent.StartNs, InEvent.DurationNs });
+            });
+            registry.retiredDroppedEvents += InThread->droppedEvents.load(std::memory_order_relaxed);
+        }
+
+        delete InThread;
+    }
+
+    // the instrument is created on the thread's first record and retired by this when the thread exits
+    struct ThreadInstrumentOwner
+    {
+        ThreadInstrument* Instrument = nullptr;
+        ~ThreadInstrumentOwner();
+    };
+
+    static thread_local ThreadInstrumentOwner tInstrumentOwner;
+    // trivially destructible, so still readable by thread_local destructors running after the owner's
+    static thread_local bool tInstrumentRetired = false;
+
+    ThreadInstrumentOwner::~ThreadInstrumentOwner()
+    {
+        tInstrumentRetired = true;
+        if (Instrument)
+        {
+            RetireThreadInstrument(Instrument);
+            Instrument = nullptr;
+        }
+    }
+
+    // null once the thread is exiting
+    static ThreadInstrument* GetThreadInstrument()
+    {
+        if (tInstrumentRetired)
+        {
+            return nullptr;
+        }
+        if (!tInstrumentOwner.Instrument)
+        {
+            auto newThread = new ThreadInstrument();
+            newThread->resetGeneration.store(GInstrumentResetGeneration.load(std::memory_order_acquire), std::memory_order_relaxed);
+
+            auto& registry = GetInstrumentRegistry();
+            std::unique_lock<std::mutex> lock(registry.lock);
+            newThread->ThreadIndex = registry.nextThreadIndex++;
+            registry.threads.push_back(newThread);
+            tInstrumentOwner.Instrument = newThread;
+        }
+        return tInstrumentOwner.Instrument;
+    }
+
+    void RecordReflectionEvent(EReflectionCounter InCounter, const void* InKey,
+        const char* InOwner, const char* InName, uint64_t InStartNs, uint64_t InEndNs)
+    {
+        auto curThread = GetThreadInstrument();
+        if (!curThread)
+        {
+            return;
+        }
+        const uint64_t durationNs = InEndNs > InStartNs ? InEndNs - InStartNs : 0;
+
+        // a reset happened, clear in place (readers may be looking) and then let readers see this thread again
+        const uint32_t resetGeneration = GInstrumentResetGeneration.load(std::memory_order_acquire);
+        if (curThread->resetGeneration.load(std::memory_order_relaxed) != resetGeneration)
+        {
+            curThread->slots.ForEach(0, [](StatSlot& InSlot)
+            {
+                InSlot.Count.store(0, std::memory_order_relaxed);
+                InSlot.TotalNs.store(0, std::memory_order_relaxed);
+                InSlot.MaxNs.store(0, std::memory_order_relaxed);
+            });
+            curThread->eventsStart.store(curThread->events.GetCount(), std::memory_order_relaxed);
+            curThread->droppedEvents.store(0, std::memory_order_relaxed);
+            curThread->resetGeneration.store(resetGeneration, std::memory_order_release);
+        }
+
+        auto [foundSlot, bInserted] = curThread->slotLookup.try_emplace(StatKey{ InCounter, InKey }, nullptr);
+        if (bInserted)
+        {
+            auto& newSlot = curThread->slots.Next();
+            newSlot.Counter = InCounter;
+            newSlot.Key = InKey;
+            if (InOwner && *InOwner)
+            {
+                newSlot.Name = InOwner;
+                newSlot.Name += "::";
+            }
+            newSlot.Name += InName ? InName : "";
+            curThread->slots.Publish();
+            foundSlot->second = &newSlot;
+        }
+
+        // single writer, plain load and store are enough
+        auto& curStat = *foundSlot->second;
+        curStat.Count.store(curStat.Count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        curStat.TotalNs.store(curStat.TotalNs.load(std::memory_order_relaxed) + durationNs, std::memory_order_relaxed);
+        if (durationNs > curStat.MaxNs.load(std::memory_order_relaxed))
+        {
+            curStat.MaxNs.store(durationNs, std::memory_order_relaxed);
+        }
+
+        if (GetReflectionInstrumentMode() & InstrumentMode::Trace)
+        {
+            if (curThread->events.GetCount() - curThread->eventsStart.load(std::memory_order_relaxed) < MaxTraceEventsPerThread)
+            {
+                curThread->events.Next() = TraceEvent{ &curStat, InStartNs, durationNs };
+                curThread->events.Publish();
+            }
+            else
+            {
+                curThread->droppedEvents.store(curThread->droppedEvents.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static void SortStats(std::vector< ReflectionStat >& InOutStats)
+    {
+        std::sort(InOutStats.begin(), InOutStats.end(), [](const ReflectionStat& InA, const ReflectionStat& InB)
+        {
+            if (InA.TotalNs != InB.TotalNs)
+            {
+                return InA.TotalNs > InB.TotalNs;
+            }
+            return InA.Count > InB.Count;
+        });
+    }
+
+    static std::vector< ReflectionStat > GatherStats(const EReflectionCounter* InCounter)
+    {
+        std::unordered_map< StatKey, ReflectionStat, StatKeyHash > merged;
+
+        auto& registry = GetInstrumentRegistry();
+        std::unique_lock<std::mutex> registryLock(registry.lock);
+        for (const auto& [curKey, curStat] : registry.retiredStats)
+        {
+            if ((!InCounter || curKey.Counter == *InCounter) && curStat.Count)
+            {
+                AddStat(merged, curKey, curStat.Name, curStat.Count, curStat.TotalNs, curStat.MaxNs);
+            }
+        }
+
+        for (const auto& curThread : registry.threads)
+        {
+            if (!curThread->IsCurrent())
+            {
+                continue;
+            }
+
+            curThread->slots.ForEach(0, [&](const StatSlot& InSlot)
+            {
+                const auto slotCount = InSlot.Count.load(std::memory_order_relaxed);
+                if ((InCounter && InSlot.Counter != *InCounter) || !slotCount)
+                {
+                    return;
+                }
+                AddStat(merged, StatKey{ InSlot.Counter, InSlot.Key }, InSlot.Name, slotCount,
+                    InSlot.TotalNs.load(std::memory_order_relaxed), InSlot.MaxNs.load(std::memory_order_relaxed));
+            });
+        }
+
+        std::vector< ReflectionStat > oStats;
+        oStats.reserve(merged.size());
+        for (auto& [curKey, curStat] : merged)
+        {
+            oStats.push_back(std::move(curStat));
+        }
+        SortStats(oStats);
+        return oStats;
+    }
+
+    std::vector< ReflectionStat > GetReflectionStats()
+    {
+        return GatherStats(nullptr);
+    }
+
+    std::vector< ReflectionStat > GetReflectionStats(EReflectionCounter InCounter)
+    {
+        return GatherStats(&InCounter);
+    }
+
+    void ResetReflectionStats()
+    {
+        auto& registry = GetInstrumentRegistry();
+        std::unique_lock<std::mutex> registryLock(registry.lock);
+        // live threads clear their own on their next record and are skipped until then
+        GInstrumentResetGeneration.fetch_add(1, std::memory_order_acq_rel);
+        registry.retiredEvents.clear();
+        registry.retiredStats.clear();
+        registry.retiredDroppedEvents = 0;
+    }
+
+    void LogReflectionStats(size_t InMaxEntries)
+    {
+        auto allStats = GetReflectionStats();
+        SPP_LOG(LOG_REFLECTION, LOG_INFO, "INSTRUMENT: %zd entries", allStats.size());
+        for (size_t Iter = 0; Iter < std::min(InMaxEntries, allStats.size()); Iter++)
+        {
+            const auto& curStat = allStats[Iter];
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "INSTRUMENT: %-18s %-40s count %8llu total %10.3f ms max %8.3f us",
+                GetReflectionCounterName(curStat.Counter), curStat.Name.c_str(), (unsigned long long)curStat.Count,
+                (double)curStat.TotalNs / 1.0e6, (double)curStat.MaxNs / 1.0e3);
+        }
+    }
+
+    static void WriteJsonString(std::ostream& InOut, const std::string& InValue)
+    {
+        InOut << '"';
+        for (auto curChar : InValue)
+        {
+            switch (curChar)
+            {
+            case '"': InOut << "\\\""; break;
+            case '\\': InOut << "\\\\"; break;
+            case '\n': InOut << "\\n"; break;
+            case '\t': InOut << "\\t"; break;
+            default:
+                if ((uint8_t)curChar < 0x20)
+                {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", (uint32_t)(uint8_t)curChar);
+                    InOut << escaped;
+                }
+                else
+                {
+                    InOut << curChar;
+                }
+                break;
+            }
+        }
+        InOut << '"';
+    }
+
+    bool ExportReflectionTrace(const char* InPath)
+    {
+        std::ofstream outFile(InPath);
+        if (!outFile)
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "INSTRUMENT: failed to open %s", InPath);
+            return false;
+        }
+
+        // stats first, they take the registry lock on their own
+        auto allStats = GetReflectionStats();
+
+        outFile.setf(std::ios::fixed);
+        outFile.precision(3);
+        outFile << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        outFile << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"SPPReflection\"}}";
+
+        uint64_t droppedEvents = 0;
+        {
+            auto& registry = GetInstrumentRegistry();
+            std::unique_lock<std::mutex> registryLock(registry.lock);
+
+            // chrome wants microseconds, relative to the earliest event keeps the numbers small
+            uint64_t baseNs = std::numeric_limits<uint64_t>::max();
+            for (const auto& curEvent : registry.retiredEvents)
+            {
+                baseNs = std::min(baseNs, curEvent.StartNs);
+            }
+            for (const auto& curThread : registry.threads)
+            {
+                if (curThread->IsCurrent())
+                {
+                    curThread->events.ForEach(curThread->eventsStart.load(std::memory_order_acquire), [&](const TraceEvent& InEvent)
+                    {
+                        baseNs = std::min(baseNs, InEvent.StartNs);
+                    });
+                }
+            }
+
+            auto writeEvent = [&](uint32_t InThreadIndex, EReflectionCounter InCounter, const std::string& InName, uint64_t InStartNs, uint64_t InDurationNs)
+            {
+                outFile << ",\n{\"name\":";
+                WriteJsonString(outFile, InName);
+                outFile << ",\"cat\":\"" << GetReflectionCounterName(InCounter) << "\""
+                    << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << InThreadIndex
+                    << ",\"ts\":" << (double)(InStartNs - baseNs) / 1.0e3
+                    << ",\"dur\":" << (double)InDurationNs / 1.0e3 << "}";
+            };
+
+            for (const auto& curEvent : registry.retiredEvents)
+            {
+                writeEvent(curEvent.ThreadIndex, curEvent.Counter, *curEvent.Name, curEvent.StartNs, curEvent.DurationNs);
+            }
+            droppedEvents += registry.retiredDroppedEvents;
+
+            for (const auto& curThread : registry.threads)
+            {
+                if (!curThread->IsCurrent())
+                {
+                    continue;
+                }
+
+                outFile << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << curThread->ThreadIndex
+                    << ",\"args\":{\"name\":\"thread " << curThread->ThreadIndex << "\"}}";
+
+                // a second pass may see a few more events than the first, they're newer than baseNs anyway
+                curThread->events.ForEach(curThread->eventsStart.load(std::memory_order_acquire), [&](const TraceEvent& InEvent)
+                {
+                    writeEvent(curThread->ThreadIndex, InEvent.Stat->Counter, InEvent.Stat->Name, InEvent.StartNs, InEvent.DurationNs);
+                });
+
+                droppedEvents += curThread->droppedEvents.load(std::memory_order_relaxed);
+            }
+        }
+
+        outFile << "\n],\n\"droppedEvents\":" << droppedEvents << ",\n\"reflectionStats\":[";
+        for (size_t Iter = 0; Iter < allStats.size(); Iter++)
+        {
+            const auto& curStat = allStats[Iter];
+            outFile << (Iter ? ",\n" : "\n") << "{\"counter\":\"" << GetReflectionCounterName(curStat.Counter) << "\",\"name\":";
+            WriteJsonString(outFile, curStat.Name);
+            outFile << ",\"count\":" << curStat.Count
+                << ",\"total_us\":" << (double)curStat.TotalNs / 1.0e3
+                << ",\"max_us\":" << (double)curStat.MaxNs / 1.0e3 << "}";
+        }
+        outFile << "\n]}\n";
+
+        return (bool)outFile;
+    }
+}
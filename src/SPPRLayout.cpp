@@ -0,0 +1,324 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPReflection.h"
+#include <algorithm>
+#include <fstream>
+
+namespace SPP
+{
+    static const char* CONST_UnreflectedName = "<unreflected>";
+
+    static size_t AlignUp(size_t InValue, size_t InAlignment)
+    {
+        return (InValue + InAlignment - 1) / InAlignment * InAlignment;
+    }
+
+    static const char* GetFieldName(const LayoutField& InField)
+    {
+        return InField.Property ? InField.Property->GetName().c_str() : CONST_UnreflectedName;
+    }
+
+    // size of the fields packed in the given order, rounded to the largest alignment among them
+    static size_t PackedSize(const std::vector< LayoutField >& InFields, const std::vector< size_t >& InOrder)
+    {
+        size_t cursor = 0;
+        size_t maxAlignment = 1;
+        for (auto fieldIdx : InOrder)
+        {
+            const auto& curField = InFields[fieldIdx];
+            cursor = AlignUp(cursor, curField.Alignment) + curField.Size;
+            maxAlignment = std::max(maxAlignment, curField.Alignment);
+        }
+        return AlignUp(cursor, maxAlignment);
+    }
+
+    // largest alignment first then largest size, which never leaves a hole between fields whose sizes are
+    // multiples of their alignment (all of them in C++)
+    static void SortForPacking(const std::vector< LayoutField >& InFields, std::vector< size_t >& InOutOrder)
+    {
+        std::stable_sort(InOutOrder.begin(), InOutOrder.end(), [&InFields](size_t InA, size_t InB)
+        {
+            const auto& fieldA = InFields[InA];
+            const auto& fieldB = InFields[InB];
+            if (fieldA.Alignment != fieldB.Alignment)
+            {
+                return fieldA.Alignment > fieldB.Alignment;
+            }
+            return fieldA.Size > fieldB.Size;
+        });
+    }
+
+    LayoutReport AnalyzeLayout(const ReflectedStruct* InStruct, const LayoutSettings& InSettings)
+    {
+        SE_ASSERT(InStruct);
+
+        LayoutReport oReport;
+        oReport.Struct = InStruct;
+        oReport.Size = InStruct->GetCPPType()->get_sizeof;
+        oReport.Alignment = std::max< size_t >(InStruct->GetCPPType()->get_alignof, 1);
+        oReport.CacheLineSize = InSettings.CacheLineSize;
+        oReport.CacheLines = (oReport.Size + InSettings.CacheLineSize - 1) / InSettings.CacheLineSize;
+
+        std::vector< LayoutField > placedFields;
+        InStruct->IterateProperties([&](ReflectedProperty* InProperty)
+        {
+            if (InProperty->IsAccessorBased())
+            {
+                oReport.Unplaced.push_back(InProperty);
+                return;
+            }
+
+            // bitfields take the bytes of their word that hold reflected bits once
+            if (InProperty->GetKind() == EPropertyKind::Bitfield)
+            {
+                auto bitProp = static_cast<BitfieldProperty*>(InProperty);
+                if (bitProp->IsWordLeader())
+                {
+                    const size_t usedOffset = bitProp->GetUsedOffset();
+                    placedFields.push_back({ InProperty, usedOffset, bitProp->GetUsedSize(),
+                        usedOffset == InProperty->GetPropOffset() ? bitProp->GetWordSize() : (size_t)1 });
+                }
+                return;
+            }
+
+            auto propType = InProperty->GetCPPType();
+            if (propType->get_sizeof)
+            {
+                placedFields.push_back({ InProperty, InProperty->GetPropOffset(), propType->get_sizeof, std::max< size_t >(propType->get_alignof, 1) });
+            }
+        });
+
+        std::stable_sort(placedFields.begin(), placedFields.end(), [](const LayoutField& InA, const LayoutField& InB)
+        {
+            return InA.Offset < InB.Offset;
+        });
+
+        // a gap is padding when aligning the cursor for what follows explains it exactly, anything else
+        // is something we can't see and is kept as an opaque block
+        auto addGap = [&oReport](size_t InStart, size_t InEnd, size_t InNextAlignment)
+        {
+            if (InEnd <= InStart)
+            {
+                return;
+            }
+
+            if (AlignUp(InStart, InNextAlignment) == InEnd)
+            {
+                oReport.Holes.push_back({ InStart, InEnd - InStart });
+                oReport.PaddingBytes += InEnd - InStart;
+                return;
+            }
+
+            const size_t gapSize = InEnd - InStart;
+            const size_t lowBit = (InStart | gapSize) & ~((InStart | gapSize) - 1);
+            oReport.Fields.push_back({ nullptr, InStart, gapSize, std::min(lowBit, oReport.Alignment) });
+        };
+
+        size_t cursor = 0;
+        for (const auto& curField : placedFields)
+        {
+            addGap(cursor, curField.Offset, curField.Alignment);
+            oReport.Fields.push_back(curField);
+            cursor = std::max(cursor, curField.Offset + curField.Size);
+        }
+        addGap(cursor, oReport.Size, oReport.Alignment);
+
+        std::stable_sort(oReport.Fields.begin(), oReport.Fields.end(), [](const LayoutField& InA, const LayoutField& InB)
+        {
+            return InA.Offset < InB.Offset;
+        });
+
+        const size_t lineSize = InSettings.CacheLineSize;
+        for (auto& curField : oReport.Fields)
+        {
+            curField.bStraddlesCacheLine = curField.Size <= lineSize &&
+                (curField.Offset / lineSize) != ((curField.Offset + curField.Size - 1) / lineSize);
+        }
+
+        std::vector< size_t > allFields(oReport.Fields.size());
+        for (size_t Iter = 0; Iter < allFields.size(); Iter++)
+        {
+            allFields[Iter] = Iter;
+        }
+        oReport.OptimalOrder = allFields;
+        SortForPacking(oReport.Fields, oReport.OptimalOrder);
+        oReport.OptimalSize = std::max(AlignUp(PackedSize(oReport.Fields, oReport.OptimalOrder), oReport.Alignment), oReport.Alignment);
+        // never suggest a change that doesn't help
+        if (oReport.OptimalSize >= oReport.Size)
+        {
+            oReport.OptimalOrder = allFields;
+            oReport.OptimalSize = oReport.Size;
+        }
+
+        if (InSettings.AccessCounts)
+        {
+            uint64_t maxCount = 0;
+            for (auto& curField : oReport.Fields)
+            {
+                if (curField.Property)
+                {
+                    auto foundCount = InSettings.AccessCounts->find(curField.Property);
+                    curField.AccessCount = foundCount != InSettings.AccessCounts->end() ? foundCount->second : 0;
+                    maxCount = std::max(maxCount, curField.AccessCount);
+                }
+            }
+
+            if (maxCount)
+            {
+                const double hotCount = (double)maxCount * InSettings.HotFraction;
+                for (auto fieldIdx : oReport.OptimalOrder)
+                {
+                    const auto& curField = oReport.Fields[fieldIdx];
+                    // opaque blocks can't be moved out, they stay with the hot part
+                    if (!curField.Property || (curField.AccessCount && (double)curField.AccessCount >= hotCount))
+                    {
+                        oReport.HotFields.push_back(fieldIdx);
+                    }
+                    else
+                    {
+                        oReport.ColdFields.push_back(fieldIdx);
+                    }
+                }
+
+                SortForPacking(oReport.Fields, oReport.HotFields);
+                SortForPacking(oReport.Fields, oReport.ColdFields);
+                oReport.HotSize = PackedSize(oReport.Fields, oReport.HotFields);
+                oReport.ColdSize = PackedSize(oReport.Fields, oReport.ColdFields);
+            }
+        }
+
+        return oReport;
+    }
+
+    std::vector< LayoutReport > AnalyzeAllLayouts(const LayoutSettings& InSettings)
+    {
+        std::vector< LayoutReport > oReports;
+        GetTypeCollection().IterateTypes([&](const type_data* InType)
+        {
+            if (InType->structureRef)
+            {
+                oReports.push_back(AnalyzeLayout(InType->structureRef.get(), InSettings));
+            }
+        });
+        return oReports;
+    }
+
+    void LogLayoutReport(const LayoutReport& InReport)
+    {
+        SPP_LOG(LOG_REFLECTION, LOG_INFO, "LAYOUT: %s size %zd align %zd, %zd cache lines, padding %zd, optimal %zd",
+            InReport.Struct->GetCPPType()->GetName().c_str(), InReport.Size, InReport.Alignment, InReport.CacheLines,
+            InReport.PaddingBytes, InReport.OptimalSize);
+
+        for (const auto& curField : InReport.Fields)
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "LAYOUT:   %4zd %-24s size %4zd align %2zd%s",
+                curField.Offset, GetFieldName(curField), curField.Size, curField.Alignment,
+                curField.bStraddlesCacheLine ? " [STRADDLES CACHE LINE]" : "");
+        }
+        for (const auto& curHole : InReport.Holes)
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "LAYOUT:   hole at %zd, %zd bytes", curHole.Offset, curHole.Size);
+        }
+        for (auto curProperty : InReport.Unplaced)
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "LAYOUT:   %s is accessor based, not placed", curProperty->GetName().c_str());
+        }
+
+        if (InReport.CanShrink())
+        {
+            std::string orderNames;
+            for (auto fieldIdx : InReport.OptimalOrder)
+            {
+                orderNames += std::string(GetFieldName(InReport.Fields[fieldIdx])) + " ";
+            }
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "LAYOUT:   reorder to save %zd bytes: %s", InReport.Size - InReport.OptimalSize, orderNames.c_str());
+        }
+
+        if (InReport.HasHotColdSplit())
+        {
+            std::string coldNames;
+            for (auto fieldIdx : InReport.ColdFields)
+            {
+                coldNames += std::string(GetFieldName(InReport.Fields[fieldIdx])) + " ";
+            }
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "LAYOUT:   split hot %zd bytes / cold %zd bytes, move out: %s", InReport.HotSize, InReport.ColdSize, coldNames.c_str());
+        }
+    }
+
+    static void WriteNameList(std::ostream& InOut, const LayoutReport& InReport, const std::vector< size_t >& InFields)
+    {
+        InOut << "[";
+        for (size_t Iter = 0; Iter < InFields.size(); Iter++)
+        {
+            InOut << (Iter ? "," : "") << "\"" << GetFieldName(InReport.Fields[InFields[Iter]]) << "\"";
+        }
+        InOut << "]";
+    }
+
+    bool ExportLayoutReport(const char* InPath, const std::vector< LayoutReport >& InReports)
+    {
+        std::ofstream outFile(InPath);
+        if (!outFile)
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "LAYOUT: failed to open %s", InPath);
+            return false;
+        }
+
+        // names are C++ identifiers and type names, nothing needs escaping
+        outFile << "{\"types\":[";
+        for (size_t Iter = 0; Iter < InReports.size(); Iter++)
+        {
+            const auto& curReport = InReports[Iter];
+            outFile << (Iter ? ",\n" : "\n")
+                << "{\"type\":\"" << curReport.Struct->GetCPPType()->GetName().c_str() << "\""
+                << ",\"size\":" << curReport.Size
+                << ",\"alignment\":" << curReport.Alignment
+                << ",\"cache_line_size\":" << curReport.CacheLineSize
+                << ",\"cache_lines\":" << curReport.CacheLines
+                << ",\"padding\":" << curReport.PaddingBytes
+                << ",\"optimal_size\":" << curReport.OptimalSize;
+
+            outFile << ",\"fields\":[";
+            for (size_t FieldIter = 0; FieldIter < curReport.Fields.size(); FieldIter++)
+            {
+                const auto& curField = curReport.Fields[FieldIter];
+                outFile << (FieldIter ? "," : "")
+                    << "{\"name\":\"" << GetFieldName(curField) << "\""
+                    << ",\"reflected\":" << (curField.Property ? "true" : "false")
+                    << ",\"offset\":" << curField.Offset
+                    << ",\"size\":" << curField.Size
+                    << ",\"alignment\":" << curField.Alignment
+                    << ",\"straddles_cache_line\":" << (curField.bStraddlesCacheLine ? "true" : "false")
+                    << ",\"access_count\":" << curField.AccessCount << "}";
+            }
+            outFile << "]";
+
+            outFile << ",\"holes\":[";
+            for (size_t HoleIter = 0; HoleIter < curReport.Holes.size(); HoleIter++)
+            {
+                outFile << (HoleIter ? "," : "") << "{\"offset\":" << curReport.Holes[HoleIter].Offset << ",\"size\":" << curReport.Holes[HoleIter].Size << "}";
+            }
+            outFile << "]";
+
+            outFile << ",\"unplaced\":[";
+            for (size_t PropIter = 0; PropIter < curReport.Unplaced.size(); PropIter++)
+            {
+                outFile << (PropIter ? "," : "") << "\"" << curReport.Unplaced[PropIter]->GetName().c_str() << "\"";
+            }
+            outFile << "]";
+
+            outFile << ",\"optimal_order\":";
+            WriteNameList(outFile, curReport, curReport.OptimalOrder);
+            outFile << ",\"hot\":";
+            WriteNameList(outFile, curReport, curReport.HotFields);
+            outFile << ",\"cold\":";
+            WriteNameList(outFile, curReport, curReport.ColdFields);
+            outFile << ",\"hot_size\":" << curReport.HotSize << ",\"cold_size\":" << curReport.ColdSize << "}";
+        }
+        outFile << "\n]}\n";
+
+        return (bool)outFile;
+    }
+}
@@ -0,0 +1,171 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPReflection.h"
+#include <algorithm>
+
+namespace SPP
+{
+    // vectors with more than this fraction of their buffer unused get called out in the report
+    static constexpr double WastedCapacityWarnRatio = 0.25;
+
+    size_t ReflectedStruct::GetPaddingBytes(void* InStruct) const
+    {
+        const size_t structSize = _type->get_sizeof;
+
+        std::vector< std::pair<size_t, size_t> > coveredRanges;
+        IterateProperties([&](ReflectedProperty* InProperty)
+        {
+            // through the address so accessor based properties land where they really are
+            auto propOffset = (size_t)((uint8_t*)InProperty->AccessValueAddress(InStruct) - (uint8_t*)InStruct);
+            size_t propSize = InProperty->GetCPPType()->get_sizeof;
+            if (InProperty->GetKind() == EPropertyKind::Bitfield)
+            {
+                auto bitProp = static_cast<BitfieldProperty*>(InProperty);
+                propOffset += bitProp->GetUsedOffset() - bitProp->GetPropOffset();
+                propSize = bitProp->GetUsedSize();
+            }
+            if (propOffset < structSize)
+            {
+                coveredRanges.push_back({ propOffset, std::min(structSize, propOffset + propSize) });
+            }
+        });
+
+        std::sort(coveredRanges.begin(), coveredRanges.end());
+
+        size_t coveredBytes = 0;
+        size_t coveredEnd = 0;
+        for (const auto& [rangeStart, rangeEnd] : coveredRanges)
+        {
+            if (rangeEnd > coveredEnd)
+            {
+                coveredBytes += rangeEnd - std::max(rangeStart, coveredEnd);
+                coveredEnd = rangeEnd;
+            }
+        }
+
+        return structSize - coveredBytes;
+    }
+
+    void ReflectedStruct::MeasureContents(void* InStruct, MemoryUsage& InOutUsage) const
+    {
+        InOutUsage.PaddingBytes += GetPaddingBytes(InStruct);
+        IterateProperties([&](ReflectedProperty* InProperty)
+        {
+            InProperty->MeasureMemory(InStruct, InOutUsage);
+        });
+    }
+
+    MemoryUsage ReflectedStruct::MeasureMemory(void* InStruct) const
+    {
+        MemoryUsage oUsage;
+        oUsage.InlineBytes = _type->get_sizeof;
+        MeasureContents(InStruct, oUsage);
+        return oUsage;
+    }
+
+    template<typename ObjectFunc>
+    static TypeMemoryReport MeasureInstances(const ReflectedStruct* InStruct, size_t InCount, const ObjectFunc& InGetObject)
+    {
+        TypeMemoryReport oReport;
+        oReport.Struct = InStruct;
+        oReport.InstanceCount = InCount;
+
+        InStruct->IterateProperties([&oReport](ReflectedProperty* InProperty)
+        {
+            oReport.Properties.push_back({ InProperty, MemoryUsage{} });
+        });
+
+        const size_t structSize = InStruct->GetCPPType()->get_sizeof;
+        for (size_t Iter = 0; Iter < InCount; Iter++)
+        {
+            auto curObject = InGetObject(Iter);
+
+            oReport.Total.InlineBytes += structSize;
+            oReport.Total.PaddingBytes += InStruct->GetPaddingBytes(curObject);
+
+            for (auto& curProperty : oReport.Properties)
+            {
+                MemoryUsage propUsage;
+                curProperty.Property->MeasureMemory(curObject, propUsage);
+
+                oReport.Total += propUsage;
+                propUsage.InlineBytes = curProperty.Property->GetCPPType()->get_sizeof;
+                curProperty.Usage += propUsage;
+            }
+        }
+
+        std::stable_sort(oReport.Properties.begin(), oReport.Properties.end(), [](const PropertyMemoryUsage& InA, const PropertyMemoryUsage& InB)
+        {
+            return InA.Usage.TotalBytes() > InB.Usage.TotalBytes();
+        });
+
+        return oReport;
+    }
+
+    TypeMemoryReport MeasureTypeMemory(const ReflectedStruct* InStruct, void* InObjects, size_t InCount, size_t InStride)
+    {
+        SE_ASSERT(InStruct);
+        const size_t objectStride = InStride ? InStride : InStruct->GetCPPType()->get_sizeof;
+        return MeasureInstances(InStruct, InCount, [&](size_t InIdx)
+        {
+            return (void*)((uint8_t*)InObjects + InIdx * objectStride);
+        });
+    }
+
+    TypeMemoryReport MeasureTypeMemory(const ReflectedStruct* InStruct, std::span< void* const > InObjects)
+    {
+        SE_ASSERT(InStruct);
+        return MeasureInstances(InStruct, InObjects.size(), [&](size_t InIdx)
+        {
+            return InObjects[InIdx];
+        });
+    }
+
+    void LogMemoryReport(const TypeMemoryReport& InReport)
+    {
+        if (!InReport.Struct)
+        {
+            return;
+        }
+
+        const auto& total = InReport.Total;
+        const auto typeName = InReport.Struct->GetCPPType()->GetName().c_str();
+
+        SPP_LOG(LOG_REFLECTION, LOG_INFO, "MEMORY: %s x %zd: %zd bytes, inline %zd heap %zd in %zd allocations, wasted capacity %zd, padding %zd",
+            typeName, InReport.InstanceCount, total.TotalBytes(), total.InlineBytes, total.HeapBytes, total.Allocations,
+            total.WastedCapacityBytes, total.PaddingBytes);
+
+        // what's left after the properties own share is the type's own holes
+        size_t ownPadding = total.PaddingBytes;
+        for (const auto& curProperty : InReport.Properties)
+        {
+            ownPadding -= curProperty.Usage.PaddingBytes;
+        }
+        if (InReport.InstanceCount && ownPadding)
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "MEMORY:   [PADDING %zd of %zd bytes per instance]",
+                ownPadding / InReport.InstanceCount, InReport.Struct->GetCPPType()->get_sizeof);
+        }
+
+        for (const auto& curProperty : InReport.Properties)
+        {
+            const auto& propUsage = curProperty.Usage;
+
+            std::string warnings;
+            if (propUsage.WastedCapacityBytes &&
+                (double)propUsage.WastedCapacityBytes >= (double)propUsage.HeapBytes * WastedCapacityWarnRatio)
+            {
+                warnings += " [WASTED CAPACITY " + std::to_string(propUsage.WastedCapacityBytes) + "]";
+            }
+            if (propUsage.PaddingBytes)
+            {
+                warnings += " [PADDING " + std::to_string(propUsage.PaddingBytes) + "]";
+            }
+
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "MEMORY:   %-24s inline %8zd heap %10zd allocations %6zd%s",
+                curProperty.Property->GetName().c_str(), propUsage.InlineBytes, propUsage.HeapBytes, propUsage.Allocations, warnings.c_str());
+        }
+    }
+}
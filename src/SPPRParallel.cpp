@@ -0,0 +1,355 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPRParallel.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace SPP
+{
+    ////////////////////////////////////////////
+    //
+    // POOL
+    // 
+    ////////////////////////////////////////////
+
+    struct QueuedTask
+    {
+        WorkStealingPool::Task Function;
+        WorkStealingPool::TaskGroup* Group = nullptr;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex Lock;
+        std::deque< QueuedTask > Tasks;
+    };
+
+    struct WorkStealingPool::Impl
+    {
+        std::vector< std::unique_ptr<WorkerQueue> > queues;
+        std::vector< std::thread > threads;
+
+        // sitting in a queue
+        std::atomic<int64_t> queued = 0;
+        std::atomic<bool> stopping = false;
+
+        // workers sleep on it until something is queued, RunAndWait until something is queued or its group is done
+        std::mutex sleepLock;
+        std::condition_variable sleepSignal;
+
+        bool PopTask(uint32_t InWorker, QueuedTask& OutTask)
+        {
+            {
+                auto& ownQueue = *queues[InWorker];
+                std::unique_lock<std::mutex> lock(ownQueue.Lock);
+                if (!ownQueue.Tasks.empty())
+                {
+                    OutTask = std::move(ownQueue.Tasks.back());
+                    ownQueue.Tasks.pop_back();
+                    queued--;
+                    return true;
+                }
+            }
+
+            for (size_t Iter = 1; Iter < queues.size(); Iter++)
+            {
+                auto& otherQueue = *queues[(InWorker + Iter) % queues.size()];
+                std::unique_lock<std::mutex> lock(otherQueue.Lock);
+                if (!otherQueue.Tasks.empty())
+                {
+                    OutTask = std::move(otherQueue.Tasks.front());
+                    otherQueue.Tasks.pop_front();
+                    queued--;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void RunTask(uint32_t InWorker, QueuedTask& InTask)
+        {
+            InTask.Function(InWorker);
+            InTask.Function = nullptr;
+
+            if (--InTask.Group->Pending == 0)
+            {
+                // under the lock so a RunAndWait between its check and its wait can't miss it
+                {
+                    std::unique_lock<std::mutex> lock(sleepLock);
+                }
+                sleepSignal.notify_all();
+            }
+        }
+
+        void WorkerLoop(uint32_t InWorker)
+        {
+            QueuedTask curTask;
+            while (!stopping)
+            {
+                if (PopTask(InWorker, curTask))
+                {
+                    RunTask(InWorker, curTask);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(sleepLock);
+                sleepSignal.wait(lock, [&]() { return stopping || queued > 0; });
+            }
+        }
+    };
+
+    WorkStealingPool::WorkStealingPool(uint32_t InThreadCount) : _impl(new Impl())
+    {
+        if (InThreadCount == DefaultThreadCount)
+        {
+            InThreadCount = std::max< uint32_t >(std::thread::hardware_concurrency(), 2) - 1;
+        }
+
+        // one queue per helper plus the caller
+        for (uint32_t Iter = 0; Iter <= InThreadCount; Iter++)
+        {
+            _impl->queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (uint32_t Iter = 0; Iter < InThreadCount; Iter++)
+        {
+            _impl->threads.emplace_back([this, Iter]() { _impl->WorkerLoop(Iter); });
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(_impl->sleepLock);
+            _impl->stopping = true;
+        }
+        _impl->sleepSignal.notify_all();
+
+        for (auto& curThread : _impl->threads)
+        {
+            curThread.join();
+        }
+    }
+
+    uint32_t WorkStealingPool::GetWorkerCount() const
+    {
+        return (uint32_t)_impl->queues.size();
+    }
+
+    void WorkStealingPool::Push(uint32_t InWorker, TaskGroup& InGroup, Task&& InTask)
+    {
+        SE_ASSERT(InWorker < _impl->queues.size());
+
+        InGroup.Pending++;
+        {
+            auto& curQueue = *_impl->queues[InWorker];
+            std::unique_lock<std::mutex> lock(curQueue.Lock);
+            curQueue.Tasks.push_back({ std::move(InTask), &InGroup });
+        }
+        {
+            std::unique_lock<std::mutex> lock(_impl->sleepLock);
+            _impl->queued++;
+        }
+        // whoever wakes takes it, a waiting RunAndWait works on any group's tasks
+        _impl->sleepSignal.notify_one();
+    }
+
+    void WorkStealingPool::RunAndWait(TaskGroup& InGroup)
+    {
+        const uint32_t callerWorker = GetWorkerCount() - 1;
+        QueuedTask curTask;
+        while (InGroup.Pending > 0)
+        {
+            // helps with any group's tasks, ours may be waiting behind them
+            if (_impl->PopTask(callerWorker, curTask))
+            {
+                _impl->RunTask(callerWorker, curTask);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_impl->sleepLock);
+            _impl->sleepSignal.wait(lock, [&]() { return InGroup.Pending == 0 || _impl->queued > 0; });
+        }
+    }
+
+    WorkStealingPool& WorkStealingPool::Get()
+    {
+        // never destroyed, joining threads while a dll unloads can hang
+        static WorkStealingPool* sharedPool = new WorkStealingPool();
+        return *sharedPool;
+    }
+
+    ////////////////////////////////////////////
+    //
+    // PARALLEL VISIT
+    // 
+    ////////////////////////////////////////////
+
+    struct VisitWorkItem
+    {
+        std::unique_ptr<IParallelVisitor> Visitor;
+        // split array ranges, in element order, only touched by the thread running this item
+        std::vector< std::unique_ptr<VisitWorkItem> > Children;
+    };
+
+    struct ParallelVisitWalker
+    {
+        const ParallelVisitorFactory& Factory;
+        const ParallelVisitSettings& Settings;
+        WorkStealingPool* Pool = nullptr;
+        WorkStealingPool::TaskGroup* Group = nullptr;
+
+        void VisitStruct(ReflectedStruct* InStruct, void* InObject, VisitWorkItem& InItem, uint32_t InWorker)
+        {
+            auto curVisitor = InItem.Visitor.get();
+            if (!curVisitor->EnterStructure(*InStruct))
+            {
+                return;
+            }
+
+            InStruct->IterateProperties([&](ReflectedProperty* curProp)
+            {
+                if (curVisitor->EnterProprety(*curProp))
+                {
+                    VisitProperty(curProp, InObject, InItem, InWorker);
+                    curVisitor->ExitProprety(*curProp);
+                }
+            });
+
+            curVisitor->ExitStructure(*InStruct);
+        }
+
+        void VisitElements(ReflectedProperty* InArray, void* InArrayAddr, size_t InStart, size_t InEnd, VisitWorkItem& InItem, uint32_t InWorker)
+        {
+            auto arrayManipulator = InArray->GetCPPType().GetTypeData()->arrayManipulator.get();
+            auto innerProp = InArray->GetInner();
+
+            for (size_t Iter = InStart; Iter < InEnd; Iter++)
+            {
+                InItem.Visitor->BeginArrayItem(Iter);
+                VisitProperty(innerProp, arrayManipulator->Element(InArrayAddr, (int32_t)Iter), InItem, InWorker);
+                InItem.Visitor->EndArrayItem(Iter);
+            }
+        }
+
+        void VisitProperty(ReflectedProperty* InProperty, void* InObject, VisitWorkItem& InItem, uint32_t InWorker)
+        {
+            auto typeData = InProperty->GetCPPType().GetTypeData();
+
+            if (typeData->structureRef && !InProperty->IsAccessorBased())
+            {
+                VisitStruct(typeData->structureRef.get(), InProperty->AccessValueAddress(InObject), InItem, InWorker);
+                return;
+            }
+
+            if (!typeData->arrayManipulator || !InProperty->GetInner())
+            {
+                InProperty->Visit(InObject, InItem.Visitor.get());
+                return;
+            }
+
+            auto arrayAddr = InProperty->AccessValueAddress(InObject);
+            const size_t totalSize = typeData->arrayManipulator->Size(arrayAddr);
+
+            InItem.Visitor->BeginArray(*InProperty);
+
+            if (!Pool || totalSize <= Settings.ArraySplitSize)
+            {
+                VisitElements(InProperty, arrayAddr, 0, totalSize, InItem, InWorker);
+            }
+            else
+            {
+                for (size_t rangeStart = 0; rangeStart < totalSize; rangeStart += Settings.ArraySplitSize)
+                {
+                    const size_t rangeEnd = std::min(totalSize, rangeStart + Settings.ArraySplitSize);
+
+                    InItem.Children.push_back(std::make_unique<VisitWorkItem>());
+                    auto childItem = InItem.Children.back().get();
+
+                    Pool->Push(InWorker, *Group, [this, childItem, InProperty, arrayAddr, rangeStart, rangeEnd](uint32_t InChildWorker)
+                    {
+                        childItem->Visitor = Factory();
+                        childItem->Visitor->BeginArrayRange(*InProperty, rangeStart, rangeEnd);
+                        VisitElements(InProperty, arrayAddr, rangeStart, rangeEnd, *childItem, InChildWorker);
+                    });
+                }
+            }
+
+            InItem.Visitor->EndArray(*InProperty);
+        }
+    };
+
+    static void MergeWorkItem(IParallelVisitor& InOutResult, VisitWorkItem& InItem)
+    {
+        InOutResult.Merge(*InItem.Visitor);
+        for (auto& curChild : InItem.Children)
+        {
+            MergeWorkItem(InOutResult, *curChild);
+        }
+    }
+
+    std::unique_ptr<IParallelVisitor> ParallelVisit(ReflectedStruct* InStruct, void* InObjects, size_t InCount, size_t InStride,
+        const ParallelVisitorFactory& InFactory, const ParallelVisitSettings& InSettings)
+    {
+        SE_ASSERT(InStruct);
+
+        auto oResult = InFactory();
+        InStride = InStride ? InStride : InStruct->GetCPPType()->get_sizeof;
+
+        // one instance, one thread, no splitting
+        if (!oResult->IsThreadSafe())
+        {
+            ParallelVisitWalker walker{ InFactory, InSettings };
+            VisitWorkItem serialItem;
+            serialItem.Visitor = std::move(oResult);
+
+            for (size_t Iter = 0; Iter < InCount; Iter++)
+            {
+                walker.VisitStruct(InStruct, (uint8_t*)InObjects + Iter * InStride, serialItem, 0);
+            }
+            return std::move(serialItem.Visitor);
+        }
+
+        auto& pool = InSettings.Pool ? *InSettings.Pool : WorkStealingPool::Get();
+        WorkStealingPool::TaskGroup visitGroup;
+        ParallelVisitWalker walker{ InFactory, InSettings, &pool, &visitGroup };
+
+        const size_t objectsPerItem = std::max< size_t >(InSettings.ObjectsPerItem, 1);
+        std::vector< std::unique_ptr<VisitWorkItem> > topItems;
+        topItems.reserve((InCount + objectsPerItem - 1) / objectsPerItem);
+
+        // spread the top level items over the queues, stealing evens out the rest. Each item has its slot
+        // (the chunk index) up front, whichever thread runs it and whenever it finishes.
+        for (size_t rangeStart = 0; rangeStart < InCount; rangeStart += objectsPerItem)
+        {
+            const size_t rangeEnd = std::min(InCount, rangeStart + objectsPerItem);
+
+            topItems.push_back(std::make_unique<VisitWorkItem>());
+            auto curItem = topItems.back().get();
+
+            pool.Push((uint32_t)(topItems.size() % pool.GetWorkerCount()), visitGroup, [&walker, &InFactory, curItem, InStruct, InObjects, InStride, rangeStart, rangeEnd](uint32_t InWorker)
+            {
+                curItem->Visitor = InFactory();
+                for (size_t Iter = rangeStart; Iter < rangeEnd; Iter++)
+                {
+                    walker.VisitStruct(InStruct, (uint8_t*)InObjects + Iter * InStride, *curItem, InWorker);
+                }
+            });
+        }
+
+        pool.RunAndWait(visitGroup);
+
+        // by chunk index, then split ranges by range index, never in finishing order
+        for (auto& curItem : topItems)
+        {
+            MergeWorkItem(*oResult, *curItem);
+        }
+
+        return oResult;
+    }
+}
@@ -0,0 +1,138 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPReflection.h"
+
+namespace SPP
+{
+    static const char* CONST_PatchOpNames[] = { "SetValue", "SetElements", "Resize", "Construct", "Clear", "Erase", "SetBits" };
+
+    PatchEntry& ReflectedPatch::AddEntry(ReflectedProperty* InProperty, EPatchOp InOp, int32_t InIndex)
+    {
+        PatchEntry newEntry;
+        newEntry.PathStart = (uint32_t)_steps.size();
+        newEntry.PathCount = (uint32_t)_curPath.size() + 1;
+        newEntry.Op = InOp;
+        newEntry.Index = InIndex;
+        newEntry.ValueStart = (uint32_t)_values.size();
+
+        _steps.insert(_steps.end(), _curPath.begin(), _curPath.end());
+        _steps.push_back({ InProperty, InIndex });
+        _entries.push_back(newEntry);
+        return _entries.back();
+    }
+
+    void ReflectedPatch::AddValue(ReflectedProperty* InProperty, const void* InData, size_t InSize)
+    {
+        auto& newEntry = AddEntry(InProperty, EPatchOp::SetValue);
+        newEntry.ValueSize = (uint32_t)InSize;
+        _values.insert(_values.end(), (const uint8_t*)InData, (const uint8_t*)InData + InSize);
+    }
+
+    void ReflectedPatch::AddElements(ReflectedProperty* InProperty, int32_t InStart, size_t InCount, const void* InData, size_t InSize)
+    {
+        auto& newEntry = AddEntry(InProperty, EPatchOp::SetElements, InStart);
+        newEntry.Count = InCount;
+        newEntry.ValueSize = (uint32_t)InSize;
+        _values.insert(_values.end(), (const uint8_t*)InData, (const uint8_t*)InData + InSize);
+    }
+
+    void ReflectedPatch::AddResize(ReflectedProperty* InProperty, size_t InNewSize)
+    {
+        AddEntry(InProperty, EPatchOp::Resize).Count = InNewSize;
+    }
+
+    void ReflectedPatch::AddConstruct(ReflectedProperty* InProperty, int32_t InIndex)
+    {
+        AddEntry(InProperty, EPatchOp::Construct, InIndex);
+    }
+
+    void ReflectedPatch::AddClear(ReflectedProperty* InProperty)
+    {
+        AddEntry(InProperty, EPatchOp::Clear);
+    }
+
+    void ReflectedPatch::AddConstructKey(ReflectedProperty* InProperty, const void* InKey, size_t InKeySize)
+    {
+        auto& newEntry = AddEntry(InProperty, EPatchOp::Construct);
+        newEntry.ValueSize = (uint32_t)InKeySize;
+        _values.insert(_values.end(), (const uint8_t*)InKey, (const uint8_t*)InKey + InKeySize);
+    }
+
+    void ReflectedPatch::AddErase(ReflectedProperty* InProperty, const void* InKey, size_t InKeySize)
+    {
+        auto& newEntry = AddEntry(InProperty, EPatchOp::Erase);
+        newEntry.ValueSize = (uint32_t)InKeySize;
+        _values.insert(_values.end(), (const uint8_t*)InKey, (const uint8_t*)InKey + InKeySize);
+    }
+
+    void ReflectedPatch::AddBits(ReflectedProperty* InProperty, uint64_t InBits, uint64_t InMask, size_t InWordSize)
+    {
+        SE_ASSERT(InWordSize <= sizeof(uint64_t));
+        auto& newEntry = AddEntry(InProperty, EPatchOp::SetBits);
+        newEntry.Count = (size_t)InMask;
+        newEntry.ValueSize = (uint32_t)InWordSize;
+        // the low bytes, words are little endian in memory
+        _values.insert(_values.end(), (const uint8_t*)&InBits, (const uint8_t*)&InBits + InWordSize);
+    }
+
+    size_t ReflectedPatch::GetMemorySize() const
+    {
+        return _steps.capacity() * sizeof(PatchStep) +
+            _entries.capacity() * sizeof(PatchEntry) +
+            _values.capacity() +
+            _curPath.capacity() * sizeof(PatchStep);
+    }
+
+    std::string ReflectedPatch::GetPathString(const PatchEntry& InEntry) const
+    {
+        std::string oPath;
+        auto curPath = GetPath(InEntry);
+
+        for (uint32_t Iter = 0; Iter < InEntry.PathCount; Iter++)
+        {
+            const auto& curStep = curPath[Iter];
+
+            // container inner properties are the unnamed value itself
+            if (curStep.Property->GetName() != "inner")
+            {
+                if (!oPath.empty())
+                {
+                    oPath += ".";
+                }
+                oPath += curStep.Property->GetName().c_str();
+            }
+
+            if (curStep.Index >= 0 && Iter + 1 < InEntry.PathCount)
+            {
+                oPath += "[";
+                oPath += std::to_string(curStep.Index);
+                oPath += "]";
+            }
+            else if (curStep.KeySize)
+            {
+                oPath += "[";
+                oPath += curStep.Property->GetCPPType()->mapManipulator->KeyToString(GetKeyData(curStep), curStep.KeySize);
+                oPath += "]";
+            }
+        }
+
+        return oPath;
+    }
+
+    void ReflectedPatch::LogOut() const
+    {
+        SPP_LOG(LOG_REFLECTION, LOG_INFO, "PATCH: entries %zd bytes %zd", _entries.size(), GetMemorySize());
+        for (const auto& curEntry : _entries)
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "%s%s %s index %d count %zd value bytes %u",
+                GetIndent(1),
+                CONST_PatchOpNames[(uint8_t)curEntry.Op],
+                GetPathString(curEntry).c_str(),
+                curEntry.Index,
+                curEntry.Count,
+                curEntry.ValueSize);
+        }
+    }
+}
@@ -0,0 +1,156 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPRPropertyPath.h"
+
+namespace SPP
+{
+    bool PropertyPath::Compile(const ReflectedStruct* InRoot, std::string_view InPath)
+    {
+        _root = InRoot;
+        _leaf = nullptr;
+        _steps.clear();
+        _bOffsetOnly = false;
+        _offsetOnly = 0;
+
+        if (!InRoot || InPath.empty())
+        {
+            return false;
+        }
+
+        // we are always at the address of the struct owning curProp, its own offset not yet applied
+        const ReflectedStruct* curStruct = InRoot;
+        ReflectedProperty* curProp = nullptr;
+        size_t pendingOffset = 0;
+
+        auto FlushOffset = [&]()
+        {
+            if (pendingOffset)
+            {
+                _steps.push_back({ EPathStep::Offset, -1, pendingOffset, nullptr });
+                pendingOffset = 0;
+            }
+        };
+
+        auto DerefWraps = [&]()
+        {
+            while ((curProp->GetKind() == EPropertyKind::UniquePtr || curProp->GetKind() == EPropertyKind::Wrapped) && curProp->GetInner())
+            {
+                FlushOffset();
+                _steps.push_back({ EPathStep::Navigate, -1, 0, curProp });
+                curProp = curProp->GetInner();
+            }
+        };
+
+        auto Fail = [&](const char* InReason)
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_WARNING, "PROPERTYPATH: %s (%.*s)", InReason, (int)InPath.size(), InPath.data());
+            _steps.clear();
+            return false;
+        };
+
+        size_t curPos = 0;
+        while (curPos <= InPath.size())
+        {
+            auto segmentEnd = InPath.find('.', curPos);
+            if (segmentEnd == std::string_view::npos)
+            {
+                segmentEnd = InPath.size();
+            }
+            auto segment = InPath.substr(curPos, segmentEnd - curPos);
+            curPos = segmentEnd + 1;
+
+            auto nameEnd = segment.find('[');
+            auto propName = segment.substr(0, nameEnd);
+            if (propName.empty())
+            {
+                return Fail("empty name");
+            }
+
+            // step into the previous property as a struct
+            if (curProp)
+            {
+                DerefWraps();
+                auto refStruct = curProp->GetCPPType()->structureRef.get();
+                if (!refStruct || curProp->IsAccessorBased())
+                {
+                    return Fail("not a struct");
+                }
+                pendingOffset += curProp->GetPropOffset();
+                curStruct = refStruct;
+            }
+
+            curProp = curStruct->FindProperty(propName);
+            if (!curProp)
+            {
+                return Fail("unknown property");
+            }
+
+            // any number of [idx]
+            while (nameEnd != std::string_view::npos)
+            {
+                auto indexEnd = segment.find(']', nameEnd);
+                if (indexEnd == std::string_view::npos || indexEnd == nameEnd + 1)
+                {
+                    return Fail("bad index");
+                }
+
+                int32_t arrayIndex = 0;
+                for (auto Iter = nameEnd + 1; Iter < indexEnd; Iter++)
+                {
+                    if (segment[Iter] < '0' || segment[Iter] > '9')
+                    {
+                        return Fail("bad index");
+                    }
+                    const int32_t digitValue = segment[Iter] - '0';
+                    if (arrayIndex > (INT32_MAX - digitValue) / 10)
+                    {
+                        return Fail("index out of range");
+                    }
+                    arrayIndex = arrayIndex * 10 + digitValue;
+                }
+
+                DerefWraps();
+                if (!curProp->GetCPPType()->arrayManipulator || !curProp->GetInner())
+                {
+                    return Fail("not an array");
+                }
+
+                FlushOffset();
+                _steps.push_back({ EPathStep::Navigate, arrayIndex, 0, curProp });
+                curProp = curProp->GetInner();
+
+                nameEnd = (indexEnd + 1 < segment.size()) ? indexEnd + 1 : std::string_view::npos;
+                if (nameEnd != std::string_view::npos && segment[nameEnd] != '[')
+                {
+                    return Fail("bad index");
+                }
+            }
+        }
+
+        if (curProp->GetKind() == EPropertyKind::Bitfield)
+        {
+            return Fail("bit range, no address");
+        }
+
+        if (curProp->IsAccessorBased())
+        {
+            FlushOffset();
+            _steps.push_back({ EPathStep::Accessor, -1, 0, curProp });
+        }
+        else
+        {
+            pendingOffset += curProp->GetPropOffset();
+            if (_steps.empty())
+            {
+                _bOffsetOnly = true;
+                _offsetOnly = pendingOffset;
+            }
+            FlushOffset();
+        }
+
+        _leaf = curProp;
+        return true;
+    }
+}
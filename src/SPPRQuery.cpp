@@ -0,0 +1,799 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPRQuery.h"
+#include <cmath>
+#include <limits>
+
+namespace SPP
+{
+    // objects evaluated per pass, masks and the gathered column stay in L1
+    static constexpr size_t QueryChunkSize = 1024;
+
+    static bool GetQueryValueKind(const ReflectedProperty* InLeaf, EQueryValue& OutKind)
+    {
+        const CPPType leafType = InLeaf ? InLeaf->GetCPPType() : CPPType();
+        if (!leafType.GetTypeData())
+        {
+            return false;
+        }
+
+        // enums compare as their underlying integer, signed or not as EnumProperty reads them
+        if (leafType->is_enum)
+        {
+            const bool bSigned = InLeaf->GetKind() != EPropertyKind::Enum || static_cast<const EnumProperty*>(InLeaf)->IsSigned();
+            switch (leafType->get_sizeof)
+            {
+            case 1: OutKind = bSigned ? EQueryValue::Int8 : EQueryValue::UInt8; return true;
+            case 2: OutKind = bSigned ? EQueryValue::Int16 : EQueryValue::UInt16; return true;
+            case 4: OutKind = bSigned ? EQueryValue::Int32 : EQueryValue::UInt32; return true;
+            case 8: OutKind = bSigned ? EQueryValue::Int64 : EQueryValue::UInt64; return true;
+            default: return false;
+            }
+        }
+
+        static const std::pair< CPPType, EQueryValue > CONST_ValueKinds[] = {
+            { get_type<int8_t>(), EQueryValue::Int8 },
+            { get_type<int16_t>(), EQueryValue::Int16 },
+            { get_type<int32_t>(), EQueryValue::Int32 },
+            { get_type<int64_t>(), EQueryValue::Int64 },
+            { get_type<uint8_t>(), EQueryValue::UInt8 },
+            { get_type<uint16_t>(), EQueryValue::UInt16 },
+            { get_type<uint32_t>(), EQueryValue::UInt32 },
+            { get_type<uint64_t>(), EQueryValue::UInt64 },
+            { get_type<float>(), EQueryValue::Float },
+            { get_type<double>(), EQueryValue::Double },
+            { get_type<bool>(), EQueryValue::Bool },
+            { get_type<std::string>(), EQueryValue::String }
+        };
+
+        for (const auto& curKind : CONST_ValueKinds)
+        {
+            if (curKind.first == leafType)
+            {
+                OutKind = curKind.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // registered enum names keep their quotes ("GoodGuy")
+    static std::string_view StripQuotes(std::string_view InValue)
+    {
+        if (InValue.size() >= 2 && InValue.front() == '"' && InValue.back() == '"')
+        {
+            return InValue.substr(1, InValue.size() - 2);
+        }
+        return InValue;
+    }
+
+    // value type and the literal type it is compared in
+    template<typename T>
+    using query_compare_t = std::conditional_t< std::is_floating_point_v<T>, double,
+        std::conditional_t< std::is_same_v<T, uint64_t>, uint64_t, int64_t > >;
+
+    template<typename CmpT>
+    static CmpT GetLiteral(const QueryNode& InNode)
+    {
+        if constexpr (std::is_same_v<CmpT, double>)
+        {
+            return InNode.FloatLiteral;
+        }
+        else if constexpr (std::is_same_v<CmpT, uint64_t>)
+        {
+            return InNode.UIntLiteral;
+        }
+        else
+        {
+            return InNode.IntLiteral;
+        }
+    }
+
+    template<typename T>
+    static bool CompareOp(EQueryOp InOp, const T& InA, const T& InB)
+    {
+        switch (InOp)
+        {
+        case EQueryOp::Equal: return InA == InB;
+        case EQueryOp::NotEqual: return InA != InB;
+        case EQueryOp::Less: return InA < InB;
+        case EQueryOp::LessEqual: return InA <= InB;
+        case EQueryOp::Greater: return InA > InB;
+        case EQueryOp::GreaterEqual: return InA >= InB;
+        default: return false;
+        }
+    }
+
+    template<typename CmpT, typename T, typename Func>
+    static inline void CompareLoop(const T* InValues, size_t InCount, CmpT InLiteral, uint8_t* OutMask, Func InCompare)
+    {
+        for (size_t Iter = 0; Iter < InCount; Iter++)
+        {
+            OutMask[Iter] = (uint8_t)InCompare((CmpT)InValues[Iter], InLiteral);
+        }
+    }
+
+    template<typename T>
+    static void CompareChunk(const QueryNode& InNode, const uint8_t* InObjects, size_t InCount, size_t InStride, uint8_t* OutMask, void* InScratch)
+    {
+        using CmpT = query_compare_t<T>;
+        const CmpT literal = GetLiteral<CmpT>(InNode);
+
+        if (!InNode.Path.IsOffsetOnly())
+        {
+            for (size_t Iter = 0; Iter < InCount; Iter++)
+            {
+                auto value = (const T*)InNode.Path.Resolve((void*)(InObjects + Iter * InStride));
+                OutMask[Iter] = value && CompareOp(InNode.Op, (CmpT)*value, literal);
+            }
+            return;
+        }
+
+        // packed column then a branch free compare the compiler can vectorize
+        auto values = (T*)InScratch;
+        GatherStrided(InObjects + InNode.Path.GetOffset(), InCount, InStride, values);
+
+        switch (InNode.Op)
+        {
+        case EQueryOp::Equal: CompareLoop(values, InCount, literal, OutMask, std::equal_to<CmpT>()); break;
+        case EQueryOp::NotEqual: CompareLoop(values, InCount, literal, OutMask, std::not_equal_to<CmpT>()); break;
+        case EQueryOp::Less: CompareLoop(values, InCount, literal, OutMask, std::less<CmpT>()); break;
+        case EQueryOp::LessEqual: CompareLoop(values, InCount, literal, OutMask, std::less_equal<CmpT>()); break;
+        case EQueryOp::Greater: CompareLoop(values, InCount, literal, OutMask, std::greater<CmpT>()); break;
+        case EQueryOp::GreaterEqual: CompareLoop(values, InCount, literal, OutMask, std::greater_equal<CmpT>()); break;
+        default: std::memset(OutMask, 0, InCount); break;
+        }
+    }
+
+    static void CompareStringChunk(const QueryNode& InNode, const uint8_t* InObjects, size_t InCount, size_t InStride, uint8_t* OutMask)
+    {
+        for (size_t Iter = 0; Iter < InCount; Iter++)
+        {
+            auto value = (const std::string*)InNode.Path.Resolve((void*)(InObjects + Iter * InStride));
+            OutMask[Iter] = value && CompareOp(InNode.Op, std::string_view(*value), std::string_view(InNode.StringLiteral));
+        }
+    }
+
+    template<typename T>
+    static bool CompareOne(const QueryNode& InNode, const void* InObject)
+    {
+        auto value = (const T*)InNode.Path.Resolve((void*)InObject);
+        if (!value)
+        {
+            return false;
+        }
+
+        if constexpr (std::is_same_v<T, std::string>)
+        {
+            return CompareOp(InNode.Op, std::string_view(*value), std::string_view(InNode.StringLiteral));
+        }
+        else
+        {
+            using CmpT = query_compare_t<T>;
+            return CompareOp(InNode.Op, (CmpT)*value, GetLiteral<CmpT>(InNode));
+        }
+    }
+
+    // calls InFunc with a null pointer of the value type
+    template<typename Func>
+    static auto DispatchValueKind(EQueryValue InKind, Func&& InFunc)
+    {
+        switch (InKind)
+        {
+        case EQueryValue::Int8: return InFunc((int8_t*)nullptr);
+        case EQueryValue::Int16: return InFunc((int16_t*)nullptr);
+        case EQueryValue::Int32: return InFunc((int32_t*)nullptr);
+        case EQueryValue::Int64: return InFunc((int64_t*)nullptr);
+        case EQueryValue::UInt8: return InFunc((uint8_t*)nullptr);
+        case EQueryValue::UInt16: return InFunc((uint16_t*)nullptr);
+        case EQueryValue::UInt32: return InFunc((uint32_t*)nullptr);
+        case EQueryValue::UInt64: return InFunc((uint64_t*)nullptr);
+        case EQueryValue::Float: return InFunc((float*)nullptr);
+        case EQueryValue::Double: return InFunc((double*)nullptr);
+        case EQueryValue::Bool: return InFunc((bool*)nullptr);
+        default: return InFunc((std::string*)nullptr);
+        }
+    }
+
+    ////////////////////////////////////////////
+    //
+    // PARSER
+    // 
+    ////////////////////////////////////////////
+
+    struct QueryParser
+    {
+        ReflectedQuery& Query;
+        std::string_view Source;
+        size_t Pos = 0;
+
+        void SkipSpaces()
+        {
+            while (Pos < Source.size() && std::isspace((unsigned char)Source[Pos]))
+            {
+                Pos++;
+            }
+        }
+
+        bool Match(std::string_view InToken)
+        {
+            SkipSpaces();
+            if (Source.substr(Pos, InToken.size()) == InToken)
+            {
+                Pos += InToken.size();
+                return true;
+            }
+            return false;
+        }
+
+        int32_t Fail(const std::string& InReason)
+        {
+            if (Query._error.empty())
+            {
+                Query._error = InReason + " at " + std::to_string(Pos);
+            }
+            return -1;
+        }
+
+        int32_t AddNode(EQueryOp InOp, int32_t InLeft, int32_t InRight = -1)
+        {
+            QueryNode newNode;
+            newNode.Op = InOp;
+            newNode.Left = InLeft;
+            newNode.Right = InRight;
+            Query._nodes.push_back(std::move(newNode));
+            return (int32_t)Query._nodes.size() - 1;
+        }
+
+        int32_t ParseOr()
+        {
+            auto leftNode = ParseAnd();
+            while (leftNode >= 0 && Match("||"))
+            {
+                auto rightNode = ParseAnd();
+                if (rightNode < 0)
+                {
+                    return -1;
+                }
+                leftNode = AddNode(EQueryOp::Or, leftNode, rightNode);
+            }
+            return leftNode;
+        }
+
+        int32_t ParseAnd()
+        {
+            auto leftNode = ParseUnary();
+            while (leftNode >= 0 && Match("&&"))
+            {
+                auto rightNode = ParseUnary();
+                if (rightNode < 0)
+                {
+                    return -1;
+                }
+                leftNode = AddNode(EQueryOp::And, leftNode, rightNode);
+            }
+            return leftNode;
+        }
+
+        int32_t ParseUnary()
+        {
+            if (Match("!"))
+            {
+                auto childNode = ParseUnary();
+                return childNode < 0 ? -1 : AddNode(EQueryOp::Not, childNode);
+            }
+            if (Match("("))
+            {
+                auto innerNode = ParseOr();
+                if (innerNode < 0)
+                {
+                    return -1;
+                }
+                return Match(")") ? innerNode : Fail("expected )");
+            }
+            return ParseComparison();
+        }
+
+        std::string_view ReadWhile(bool (*InAllowed)(char))
+        {
+            SkipSpaces();
+            auto startPos = Pos;
+            while (Pos < Source.size() && InAllowed(Source[Pos]))
+            {
+                Pos++;
+            }
+            return Source.substr(startPos, Pos - startPos);
+        }
+
+        int32_t ParseComparison()
+        {
+            auto pathText = ReadWhile([](char InChar) { return std::isalnum((unsigned char)InChar) || InChar == '_' || InChar == '.' || InChar == '[' || InChar == ']'; });
+            if (pathText.empty())
+            {
+                return Fail("expected property");
+            }
+
+            QueryNode newNode;
+            newNode.PathString = std::string(pathText);
+            if (!newNode.Path.Compile(Query._struct, pathText))
+            {
+                return Fail("unknown property " + newNode.PathString);
+            }
+            if (!GetQueryValueKind(newNode.Path.GetLeaf(), newNode.ValueKind))
+            {
+                return Fail("unsupported property type " + newNode.PathString);
+            }
+
+            if (Match("==")) newNode.Op = EQueryOp::Equal;
+            else if (Match("!=")) newNode.Op = EQueryOp::NotEqual;
+            else if (Match("<=")) newNode.Op = EQueryOp::LessEqual;
+            else if (Match(">=")) newNode.Op = EQueryOp::GreaterEqual;
+            else if (Match("<")) newNode.Op = EQueryOp::Less;
+            else if (Match(">")) newNode.Op = EQueryOp::Greater;
+            else return Fail("expected comparison");
+
+            if (!ParseLiteral(newNode))
+            {
+                return -1;
+            }
+
+            Query._nodes.push_back(std::move(newNode));
+            return (int32_t)Query._nodes.size() - 1;
+        }
+
+        bool ParseLiteral(QueryNode& InOutNode)
+        {
+            SkipSpaces();
+
+            std::string_view literalText;
+            if (Pos < Source.size() && Source[Pos] == '"')
+            {
+                auto endQuote = Source.find('"', Pos + 1);
+                if (endQuote == std::string_view::npos)
+                {
+                    return Fail("unterminated string") >= 0;
+                }
+                literalText = Source.substr(Pos + 1, endQuote - Pos - 1);
+                Pos = endQuote + 1;
+            }
+            else
+            {
+                literalText = ReadWhile([](char InChar) { return std::isalnum((unsigned char)InChar) || InChar == '_' || InChar == ':' || InChar == '.' || InChar == '-' || InChar == '+'; });
+            }
+
+            if (InOutNode.ValueKind == EQueryValue::String)
+            {
+                InOutNode.StringLiteral = std::string(literalText);
+                return true;
+            }
+            if (literalText.empty())
+            {
+                return Fail("expected value") >= 0;
+            }
+
+            if (InOutNode.ValueKind == EQueryValue::Bool)
+            {
+                if (literalText == "true" || literalText == "1") InOutNode.IntLiteral = 1;
+                else if (literalText == "false" || literalText == "0") InOutNode.IntLiteral = 0;
+                else return Fail("expected bool") >= 0;
+                return true;
+            }
+
+            // enum value by name, EGuyType::GoodGuy or GoodGuy
+            auto leafTypeData = InOutNode.Path.GetLeafType().GetTypeData();
+            if (leafTypeData->is_enum && leafTypeData->enumCollection)
+            {
+                auto enumName = literalText.substr(literalText.rfind(':') == std::string_view::npos ? 0 : literalText.rfind(':') + 1);
+                for (const auto& curValue : leafTypeData->enumCollection->EnumValues)
+                {
+                    if (StripQuotes(std::get<0>(curValue)) == enumName)
+                    {
+                        // 64 bit unsigned enums compare against the unsigned literal, the cast gives the value back
+                        InOutNode.IntLiteral = std::get<1>(curValue);
+                        InOutNode.UIntLiteral = (uint64_t)std::get<1>(curValue);
+                        return true;
+                    }
+                }
+            }
+
+            std::string numberText(literalText);
+            char* numberEnd = nullptr;
+            if (InOutNode.ValueKind == EQueryValue::Float || InOutNode.ValueKind == EQueryValue::Double)
+            {
+                InOutNode.FloatLiteral = std::strtod(numberText.c_str(), &numberEnd);
+            }
+            else if (InOutNode.ValueKind == EQueryValue::UInt64)
+            {
+                if (numberText[0] == '-')
+                {
+                    return Fail("negative value for unsigned property") >= 0;
+                }
+                InOutNode.UIntLiteral = std::strtoull(numberText.c_str(), &numberEnd, 10);
+            }
+            else
+            {
+                InOutNode.IntLiteral = std::strtoll(numberText.c_str(), &numberEnd, 10);
+            }
+
+            if (numberEnd != numberText.c_str() + numberText.size())
+            {
+                return Fail("bad value " + numberText) >= 0;
+            }
+            return true;
+        }
+    };
+
+    bool ReflectedQuery::Compile(const ReflectedStruct* InStruct, std::string_view InQuery)
+    {
+        _struct = InStruct;
+        _nodes.clear();
+        _error.clear();
+        _root = -1;
+
+        if (!InStruct)
+        {
+            _error = "no struct";
+            return false;
+        }
+
+        QueryParser parser{ *this, InQuery };
+        _root = parser.ParseOr();
+        parser.SkipSpaces();
+
+        if (_root >= 0 && parser.Pos != InQuery.size())
+        {
+            parser.Fail("unexpected text");
+            _root = -1;
+        }
+
+        if (_root < 0)
+        {
+            SPP_LOG(LOG_REFLECTION, LOG_INFO, "QUERY: %s", _error.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    ////////////////////////////////////////////
+    //
+    // EXECUTION
+    // 
+    ////////////////////////////////////////////
+
+    void ReflectedQuery::EvaluateChunk(int32_t InNode, const uint8_t* InObjects, size_t InCount, size_t InStride,
+        std::vector< std::vector<uint8_t> >& InOutMasks, std::vector<uint64_t>& InOutScratch) const
+    {
+        const auto& curNode = _nodes[InNode];
+        auto outMask = InOutMasks[InNode].data();
+
+        switch (curNode.Op)
+        {
+        case EQueryOp::And:
+        {
+            EvaluateChunk(curNode.Left, InObjects, InCount, InStride, InOutMasks, InOutScratch);
+            auto leftMask = InOutMasks[curNode.Left].data();
+            if (std::find(leftMask, leftMask + InCount, 1) == leftMask + InCount)
+            {
+                std::memset(outMask, 0, InCount);
+                return;
+            }
+            EvaluateChunk(curNode.Right, InObjects, InCount, InStride, InOutMasks, InOutScratch);
+            auto rightMask = InOutMasks[curNode.Right].data();
+            for (size_t Iter = 0; Iter < InCount; Iter++)
+            {
+                outMask[Iter] = leftMask[Iter] & rightMask[Iter];
+            }
+            return;
+        }
+        case EQueryOp::Or:
+        {
+            EvaluateChunk(curNode.Left, InObjects, InCount, InStride, InOutMasks, InOutScratch);
+            auto leftMask = InOutMasks[curNode.Left].data();
+            if (std::find(leftMask, leftMask + InCount, 0) == leftMask + InCount)
+            {
+                std::memset(outMask, 1, InCount);
+                return;
+            }
+            EvaluateChunk(curNode.Right, InObjects, InCount, InStride, InOutMasks, InOutScratch);
+            auto rightMask = InOutMasks[curNode.Right].data();
+            for (size_t Iter = 0; Iter < InCount; Iter++)
+            {
+                outMask[Iter] = leftMask[Iter] | rightMask[Iter];
+            }
+            return;
+        }
+        case EQueryOp::Not:
+        {
+            EvaluateChunk(curNode.Left, InObjects, InCount, InStride, InOutMasks, InOutScratch);
+            auto childMask = InOutMasks[curNode.Left].data();
+            for (size_t Iter = 0; Iter < InCount; Iter++)
+            {
+                outMask[Iter] = childMask[Iter] ^ 1;
+            }
+            return;
+        }
+        default:
+            break;
+        }
+
+        DispatchValueKind(curNode.ValueKind, [&](auto* InTypeTag)
+        {
+            using value_type = std::remove_pointer_t<decltype(InTypeTag)>;
+            if constexpr (std::is_same_v<value_type, std::string>)
+            {
+                CompareStringChunk(curNode, InObjects, InCount, InStride, outMask);
+            }
+            else
+            {
+                CompareChunk<value_type>(curNode, InObjects, InCount, InStride, outMask, InOutScratch.data());
+            }
+        });
+    }
+
+    bool ReflectedQuery::EvaluateNode(int32_t InNode, const void* InObject) const
+    {
+        const auto& curNode = _nodes[InNode];
+
+        switch (curNode.Op)
+        {
+        case EQueryOp::And: return EvaluateNode(curNode.Left, InObject) && EvaluateNode(curNode.Right, InObject);
+        case EQueryOp::Or: return EvaluateNode(curNode.Left, InObject) || EvaluateNode(curNode.Right, InObject);
+        case EQueryOp::Not: return !EvaluateNode(curNode.Left, InObject);
+        default: break;
+        }
+
+        return DispatchValueKind(curNode.ValueKind, [&](auto* InTypeTag)
+        {
+            return CompareOne< std::remove_pointer_t<decltype(InTypeTag)> >(curNode, InObject);
+        });
+    }
+
+    bool ReflectedQuery::Evaluate(const void* InObject) const
+    {
+        return IsValid() && EvaluateNode(_root, InObject);
+    }
+
+    std::vector<uint32_t> ReflectedQuery::Execute(const void* InObjects, size_t InCount, size_t InStride) const
+    {
+        std::vector<uint32_t> oMatches;
+        if (!IsValid() || InCount == 0)
+        {
+            return oMatches;
+        }
+
+        InStride = InStride ? InStride : _struct->GetCPPType()->get_sizeof;
+
+        std::vector< std::vector<uint8_t> > nodeMasks(_nodes.size(), std::vector<uint8_t>(QueryChunkSize));
+        std::vector<uint64_t> scratch(QueryChunkSize);
+
+        for (size_t chunkStart = 0; chunkStart < InCount; chunkStart += QueryChunkSize)
+        {
+            const size_t chunkCount = std::min(QueryChunkSize, InCount - chunkStart);
+            EvaluateChunk(_root, (const uint8_t*)InObjects + chunkStart * InStride, chunkCount, InStride, nodeMasks, scratch);
+
+            const auto& rootMask = nodeMasks[_root];
+            for (size_t Iter = 0; Iter < chunkCount; Iter++)
+            {
+                if (rootMask[Iter])
+                {
+                    oMatches.push_back((uint32_t)(chunkStart + Iter));
+                }
+            }
+        }
+
+        return oMatches;
+    }
+
+    const QueryNode* ReflectedQuery::FindIndexedComparison(int32_t InNode, const std::vector<const QueryIndex*>& InIndices, const QueryIndex*& OutIndex) const
+    {
+        const auto& curNode = _nodes[InNode];
+
+        if (curNode.Op == EQueryOp::And)
+        {
+            auto foundNode = FindIndexedComparison(curNode.Left, InIndices, OutIndex);
+            return foundNode ? foundNode : FindIndexedComparison(curNode.Right, InIndices, OutIndex);
+        }
+        if (curNode.Op == EQueryOp::Or || curNode.Op == EQueryOp::Not || curNode.Op == EQueryOp::NotEqual)
+        {
+            return nullptr;
+        }
+
+        for (auto curIndex : InIndices)
+        {
+            if (curIndex && curIndex->GetPathString() == curNode.PathString &&
+                (curNode.Op == EQueryOp::Equal || curIndex->GetIndexType() == EQueryIndex::Sorted))
+            {
+                OutIndex = curIndex;
+                return &curNode;
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<uint32_t> ReflectedQuery::Execute(const void* InObjects, size_t InCount, size_t InStride,
+        const std::vector<const QueryIndex*>& InIndices) const
+    {
+        const QueryIndex* foundIndex = nullptr;
+        const QueryNode* indexedNode = IsValid() ? FindIndexedComparison(_root, InIndices, foundIndex) : nullptr;
+
+        std::vector<uint32_t> candidates;
+        if (!indexedNode || !foundIndex->Lookup(*indexedNode, candidates))
+        {
+            return Execute(InObjects, InCount, InStride);
+        }
+
+        InStride = InStride ? InStride : _struct->GetCPPType()->get_sizeof;
+
+        std::vector<uint32_t> oMatches;
+        for (auto curCandidate : candidates)
+        {
+            if (curCandidate < InCount && EvaluateNode(_root, (const uint8_t*)InObjects + curCandidate * InStride))
+            {
+                oMatches.push_back(curCandidate);
+            }
+        }
+        return oMatches;
+    }
+
+    ////////////////////////////////////////////
+    //
+    // INDEX
+    // 
+    ////////////////////////////////////////////
+
+    template<typename T>
+    static uint64_t GetHashKey(const T& InValue)
+    {
+        if constexpr (std::is_same_v<T, std::string>)
+        {
+            return HashBytes(InValue.data(), InValue.size());
+        }
+        else if constexpr (std::is_same_v<T, std::string_view>)
+        {
+            return HashBytes(InValue.data(), InValue.size());
+        }
+        else
+        {
+            // widen like the compare does, so a literal hashes the same as a stored value
+            using CmpT = query_compare_t<T>;
+            CmpT widenedValue = (CmpT)InValue;
+            if constexpr (std::is_same_v<CmpT, double>)
+            {
+                // -0 == 0
+                widenedValue = (widenedValue == 0) ? 0.0 : widenedValue;
+            }
+            return HashValue(widenedValue);
+        }
+    }
+
+    bool QueryIndex::Build(const ReflectedStruct* InStruct, std::string_view InPath, EQueryIndex InIndexType,
+        const void* InObjects, size_t InCount, size_t InStride)
+    {
+        _pathString = std::string(InPath);
+        _indexType = InIndexType;
+        _sortedKeys.clear();
+        _hashedKeys.clear();
+
+        if (!InStruct || !_path.Compile(InStruct, InPath) || !GetQueryValueKind(_path.GetLeaf(), _valueKind))
+        {
+            return false;
+        }
+        if (_valueKind == EQueryValue::String && InIndexType == EQueryIndex::Sorted)
+        {
+            return false;
+        }
+
+        InStride = InStride ? InStride : InStruct->GetCPPType()->get_sizeof;
+
+        DispatchValueKind(_valueKind, [&](auto* InTypeTag)
+        {
+            using value_type = std::remove_pointer_t<decltype(InTypeTag)>;
+
+            for (size_t Iter = 0; Iter < InCount; Iter++)
+            {
+                auto value = (const value_type*)_path.Resolve((uint8_t*)InObjects + Iter * InStride);
+                if (!value)
+                {
+                    continue;
+                }
+
+                if (_indexType == EQueryIndex::Hashed)
+                {
+                    _hashedKeys.insert({ GetHashKey(*value), (uint32_t)Iter });
+                }
+                else if constexpr (!std::is_same_v<value_type, std::string>)
+                {
+                    // NaN has no place in the order and never matches a comparison anyway
+                    if constexpr (std::is_floating_point_v<value_type>)
+                    {
+                        if (std::isnan(*value))
+                        {
+                            continue;
+                        }
+                    }
+                    _sortedKeys.push_back({ (double)*value, (uint32_t)Iter });
+                }
+            }
+        });
+
+        std::sort(_sortedKeys.begin(), _sortedKeys.end());
+        return true;
+    }
+
+    bool QueryIndex::Lookup(const QueryNode& InComparison, std::vector<uint32_t>& OutCandidates) const
+    {
+        OutCandidates.clear();
+
+        if (InComparison.PathString != _pathString || InComparison.ValueKind != _valueKind)
+        {
+            return false;
+        }
+
+        if (_indexType == EQueryIndex::Hashed)
+        {
+            if (InComparison.Op != EQueryOp::Equal)
+            {
+                return false;
+            }
+
+            uint64_t hashKey = 0;
+            if (_valueKind == EQueryValue::String)
+            {
+                hashKey = GetHashKey(std::string_view(InComparison.StringLiteral));
+            }
+            else if (_valueKind == EQueryValue::Float || _valueKind == EQueryValue::Double)
+            {
+                hashKey = GetHashKey(InComparison.FloatLiteral);
+            }
+            else if (_valueKind == EQueryValue::UInt64)
+            {
+                hashKey = GetHashKey(InComparison.UIntLiteral);
+            }
+            else
+            {
+                hashKey = GetHashKey(InComparison.IntLiteral);
+            }
+
+            auto foundRange = _hashedKeys.equal_range(hashKey);
+            for (auto Iter = foundRange.first; Iter != foundRange.second; ++Iter)
+            {
+                OutCandidates.push_back(Iter->second);
+            }
+        }
+        else
+        {
+            double literal = 0;
+            if (_valueKind == EQueryValue::Float || _valueKind == EQueryValue::Double) literal = InComparison.FloatLiteral;
+            else if (_valueKind == EQueryValue::UInt64) literal = (double)InComparison.UIntLiteral;
+            else literal = (double)InComparison.IntLiteral;
+
+            // inclusive bounds, the double conversion may round, exact compare happens on the candidates
+            double lowKey = -std::numeric_limits<double>::infinity();
+            double highKey = std::numeric_limits<double>::infinity();
+            switch (InComparison.Op)
+            {
+            case EQueryOp::Equal: lowKey = literal; highKey = literal; break;
+            case EQueryOp::Less:
+            case EQueryOp::LessEqual: highKey = literal; break;
+            case EQueryOp::Greater:
+            case EQueryOp::GreaterEqual: lowKey = literal; break;
+            default: return false;
+            }
+
+            auto rangeStart = std::lower_bound(_sortedKeys.begin(), _sortedKeys.end(), lowKey,
+                [](const std::pair<double, uint32_t>& InKey, double InValue) { return InKey.first < InValue; });
+            auto rangeEnd = std::upper_bound(rangeStart, _sortedKeys.end(), highKey,
+                [](double InValue, const std::pair<double, uint32_t>& InKey) { return InValue < InKey.first; });
+
+            for (auto Iter = rangeStart; Iter != rangeEnd; ++Iter)
+            {
+                OutCandidates.push_back(Iter->second);
+            }
+        }
+
+        std::sort(OutCandidates.begin(), OutCandidates.end());
+        return true;
+    }
+}
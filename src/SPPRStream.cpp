@@ -0,0 +1,455 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPRStream.h"
+#include <thread>
+#include <deque>
+
+#if _WIN32
+    #include <io.h>
+    #include <sys/types.h>
+    #include <sys/stat.h>
+#else
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/stat.h>
+    #include <cerrno>
+#endif
+
+namespace SPP
+{
+    ////////////////////////////////////////////
+    //
+    // SOURCES
+    //
+    ////////////////////////////////////////////
+
+    FileArchiveSource::FileArchiveSource(FILE* InFile, bool bInOwned) : _file(InFile), _bOwned(bInOwned)
+    {
+        SE_ASSERT(_file);
+
+        // seekable means a regular file that knows its size, pipes don't
+        const auto startPos = std::ftell(_file);
+        if (startPos >= 0 && std::fseek(_file, 0, SEEK_END) == 0)
+        {
+            const auto endPos = std::ftell(_file);
+            if (endPos >= startPos)
+            {
+                _sizeHint = (uint64_t)(endPos - startPos);
+            }
+            std::fseek(_file, startPos, SEEK_SET);
+        }
+    }
+
+    FileArchiveSource::~FileArchiveSource()
+    {
+        if (_bOwned)
+        {
+            std::fclose(_file);
+        }
+    }
+
+    std::unique_ptr<FileArchiveSource> FileArchiveSource::Open(const char* InPath)
+    {
+        auto openedFile = std::fopen(InPath, "rb");
+        if (!openedFile)
+        {
+            return nullptr;
+        }
+        return std::make_unique<FileArchiveSource>(openedFile, true);
+    }
+
+    size_t FileArchiveSource::ReadSome(void* OutData, size_t InMaxSize)
+    {
+        if (_bCancelled)
+        {
+            return 0;
+        }
+        const size_t readSize = std::fread(OutData, 1, InMaxSize, _file);
+        if (!readSize && std::ferror(_file))
+        {
+            _bFailed = true;
+        }
+        return readSize;
+    }
+
+    DescriptorArchiveSource::DescriptorArchiveSource(int InDescriptor) : _descriptor(InDescriptor)
+    {
+#if _WIN32
+        struct _stat64 fileStat;
+        if (_fstat64(_descriptor, &fileStat) == 0 && (fileStat.st_mode & _S_IFREG))
+        {
+            const auto curPos = _lseeki64(_descriptor, 0, SEEK_CUR);
+#else
+        struct stat fileStat;
+        if (fstat(_descriptor, &fileStat) == 0 && S_ISREG(fileStat.st_mode))
+        {
+            const auto curPos = lseek(_descriptor, 0, SEEK_CUR);
+#endif
+            if (curPos >= 0 && curPos <= fileStat.st_size)
+            {
+                _sizeHint = (uint64_t)(fileStat.st_size - curPos);
+            }
+        }
+
+#if !_WIN32
+        // non blocking write end, a second Cancel never waits
+        if (pipe(_cancelPipe) == 0)
+        {
+            fcntl(_cancelPipe[1], F_SETFL, fcntl(_cancelPipe[1], F_GETFL) | O_NONBLOCK);
+        }
+        else
+        {
+            _cancelPipe[0] = _cancelPipe[1] = -1;
+        }
+#endif
+    }
+
+    DescriptorArchiveSource::~DescriptorArchiveSource()
+    {
+#if !_WIN32
+        for (auto curEnd : _cancelPipe)
+        {
+            if (curEnd >= 0)
+            {
+                close(curEnd);
+            }
+        }
+#endif
+    }
+
+    void DescriptorArchiveSource::Cancel()
+    {
+        _bCancelled = true;
+#if !_WIN32
+        if (_cancelPipe[1] >= 0)
+        {
+            const uint8_t wakeByte = 1;
+            [[maybe_unused]] auto writeSize = write(_cancelPipe[1], &wakeByte, 1);
+        }
+#endif
+    }
+
+    size_t DescriptorArchiveSource::ReadSome(void* OutData, size_t InMaxSize)
+    {
+        for (;;)
+        {
+            if (_bCancelled)
+            {
+                return 0;
+            }
+
+#if _WIN32
+            const auto readSize = _read(_descriptor, OutData, (unsigned int)std::min< size_t >(InMaxSize, INT32_MAX));
+#else
+            // wait for data or a cancel, without a cancel pipe only the flag is checked between reads
+            if (_cancelPipe[0] >= 0)
+            {
+                pollfd waitFds[2] = { { _descriptor, POLLIN, 0 }, { _cancelPipe[0], POLLIN, 0 } };
+                if (poll(waitFds, 2, -1) < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    _bFailed = true;
+                    return 0;
+                }
+                if (waitFds[1].revents)
+                {
+                    return 0;
+                }
+            }
+
+            const auto readSize = read(_descriptor, OutData, InMaxSize);
+            if (readSize < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (readSize < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                if (_cancelPipe[0] < 0)
+                {
+                    pollfd waitFd = { _descriptor, POLLIN, 0 };
+                    poll(&waitFd, 1, 100);
+                }
+                continue;
+            }
+#endif
+            if (readSize < 0)
+            {
+                _bFailed = true;
+                return 0;
+            }
+            return (size_t)readSize;
+        }
+    }
+
+    RingArchiveSource::RingArchiveSource(size_t InCapacity) : _ring(new uint8_t[InCapacity]), _capacity(InCapacity)
+    {
+        SE_ASSERT(InCapacity);
+    }
+
+    void RingArchiveSource::Write(const void* InData, size_t InSize)
+    {
+        auto inBytes = (const uint8_t*)InData;
+        while (InSize)
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _changed.wait(lock, [this]() { return _size < _capacity || _bClosed; });
+            if (_bClosed)
+            {
+                return;
+            }
+
+            // up to the free space and the wrap
+            const size_t writePos = (_readPos + _size) % _capacity;
+            const size_t copySize = std::min({ InSize, _capacity - _size, _capacity - writePos });
+            std::memcpy(_ring.get() + writePos, inBytes, copySize);
+            _size += copySize;
+            inBytes += copySize;
+            InSize -= copySize;
+
+            lock.unlock();
+            _changed.notify_all();
+        }
+    }
+
+    void RingArchiveSource::Close()
+    {
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _bClosed = true;
+        }
+        _changed.notify_all();
+    }
+
+    size_t RingArchiveSource::ReadSome(void* OutData, size_t InMaxSize)
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _changed.wait(lock, [this]() { return _size || _bClosed; });
+
+        const size_t copySize = std::min({ InMaxSize, _size, _capacity - _readPos });
+        std::memcpy(OutData, _ring.get() + _readPos, copySize);
+        _readPos = (_readPos + copySize) % _capacity;
+        _size -= copySize;
+
+        lock.unlock();
+        _changed.notify_all();
+        return copySize;
+    }
+
+    ////////////////////////////////////////////
+    //
+    // STREAM READER
+    //
+    ////////////////////////////////////////////
+
+    // Data starts ArchiveFetchMax bytes in, the unread end of the previous chunk is copied into that headroom
+    // so a value split across two chunks reads as one run.
+    struct StreamChunk
+    {
+        std::unique_ptr<uint8_t[]> Buffer;
+        size_t Size = 0;
+
+        uint8_t* Data() const { return Buffer.get() + ArchiveFetchMax; }
+    };
+
+    struct StreamArchiveReader::Impl
+    {
+        IArchiveSource* source = nullptr;
+        StreamReaderSettings settings;
+
+        std::mutex lock;
+        std::condition_variable filledCV;
+        std::condition_variable freeCV;
+        std::deque< StreamChunk > filledChunks;
+        std::vector< StreamChunk > freeChunks;
+        bool bSourceDone = false;
+        bool bSourceFailed = false;
+        bool bStop = false;
+
+        // the chunk the window is in
+        StreamChunk current;
+        uint64_t sizeBound = 0;
+        uint64_t deliveredBytes = 0;
+        StreamReaderStats stats;
+
+        std::thread readThread;
+
+        void ReadLoop()
+        {
+            for (;;)
+            {
+                StreamChunk curChunk;
+                {
+                    std::unique_lock<std::mutex> scopeLock(lock);
+                    freeCV.wait(scopeLock, [this]() { return bStop || !freeChunks.empty(); });
+                    if (bStop)
+                    {
+                        return;
+                    }
+                    curChunk = std::move(freeChunks.back());
+                    freeChunks.pop_back();
+                }
+
+                // a whole chunk unless the source ends, fewer handoffs
+                curChunk.Size = 0;
+                while (curChunk.Size < settings.ChunkSize)
+                {
+                    const size_t readSize = source->ReadSome(curChunk.Data() + curChunk.Size, settings.ChunkSize - curChunk.Size);
+                    if (!readSize)
+                    {
+                        break;
+                    }
+                    curChunk.Size += readSize;
+                }
+
+                const bool bEnded = curChunk.Size < settings.ChunkSize;
+                const bool bFailed = bEnded && source->HasFailed();
+                {
+                    std::unique_lock<std::mutex> scopeLock(lock);
+                    if (curChunk.Size)
+                    {
+                        stats.BytesRead += curChunk.Size;
+                        stats.ChunksRead++;
+                        filledChunks.push_back(std::move(curChunk));
+                    }
+                    else
+                    {
+                        freeChunks.push_back(std::move(curChunk));
+                    }
+                    bSourceDone = bEnded;
+                    bSourceFailed = bFailed;
+                }
+                filledCV.notify_one();
+
+                if (bEnded)
+                {
+                    return;
+                }
+            }
+        }
+
+        // next chunk in read order, empty at the end of the source or after it failed
+        StreamChunk PopFilled()
+        {
+            std::unique_lock<std::mutex> scopeLock(lock);
+            if (filledChunks.empty() && !bSourceDone)
+            {
+                stats.DecoderWaits++;
+                filledCV.wait(scopeLock, [this]() { return !filledChunks.empty() || bSourceDone; });
+            }
+
+            StreamChunk oChunk;
+            if (!filledChunks.empty())
+            {
+                oChunk = std::move(filledChunks.front());
+                filledChunks.pop_front();
+            }
+            return oChunk;
+        }
+
+        void Recycle(StreamChunk&& InChunk)
+        {
+            if (!InChunk.Buffer)
+            {
+                return;
+            }
+            {
+                std::unique_lock<std::mutex> scopeLock(lock);
+                freeChunks.push_back(std::move(InChunk));
+            }
+            freeCV.notify_one();
+        }
+    };
+
+    StreamArchiveReader::StreamArchiveReader(IArchiveSource& InSource, const StreamReaderSettings& InSettings) : _impl(new Impl())
+    {
+        _impl->source = &InSource;
+        _impl->settings = InSettings;
+        _impl->settings.ChunkSize = std::max(InSettings.ChunkSize, ArchiveFetchMax);
+        _impl->settings.ChunkCount = std::max< size_t >(InSettings.ChunkCount, 1);
+
+        auto sizeHint = InSource.GetSizeHint();
+        _impl->sizeBound = sizeHint ? *sizeHint : InSettings.MaxArchiveSize;
+        _pendingBytes = _impl->sizeBound;
+
+        // the read ahead ones and the one being decoded
+        const size_t chunkTotal = _impl->settings.ChunkCount + 1;
+        for (size_t Iter = 0; Iter < chunkTotal; Iter++)
+        {
+            _impl->freeChunks.push_back({ std::unique_ptr<uint8_t[]>(new uint8_t[ArchiveFetchMax + _impl->settings.ChunkSize]), 0 });
+        }
+        _impl->stats.BufferBytes = chunkTotal * (ArchiveFetchMax + _impl->settings.ChunkSize);
+
+        _impl->readThread = std::thread([impl = _impl.get()]() { impl->ReadLoop(); });
+    }
+
+    StreamArchiveReader::~StreamArchiveReader()
+    {
+        bool bReading = false;
+        {
+            std::unique_lock<std::mutex> lock(_impl->lock);
+            _impl->bStop = true;
+            bReading = !_impl->bSourceDone;
+        }
+        // the read thread may be blocked in ReadSome rather than waiting for a free chunk
+        if (bReading)
+        {
+            _impl->source->Cancel();
+        }
+        _impl->freeCV.notify_all();
+        _impl->readThread.join();
+    }
+
+    bool StreamArchiveReader::Fetch(size_t InWanted)
+    {
+        SE_ASSERT(InWanted <= ArchiveFetchMax);
+
+        bool bAdded = false;
+        while ((size_t)(_end - _cur) < InWanted)
+        {
+            auto nextChunk = _impl->PopFilled();
+            if (!nextChunk.Buffer)
+            {
+                std::unique_lock<std::mutex> lock(_impl->lock);
+                if (_impl->bSourceFailed)
+                {
+                    lock.unlock();
+                    Fail();
+                    return false;
+                }
+                break;
+            }
+
+            // the unread tail (shorter than InWanted) goes into the headroom in front of the new data
+            const size_t leftover = _end - _cur;
+            auto newStart = nextChunk.Data() - leftover;
+            std::memmove(newStart, _cur, leftover);
+
+            _impl->Recycle(std::move(_impl->current));
+            _impl->current = std::move(nextChunk);
+            _cur = newStart;
+            _end = _impl->current.Data() + _impl->current.Size;
+
+            _impl->deliveredBytes += _impl->current.Size;
+            _pendingBytes = _impl->sizeBound > _impl->deliveredBytes ? _impl->sizeBound - _impl->deliveredBytes : 0;
+            bAdded = true;
+        }
+
+        if (!bAdded && (size_t)(_end - _cur) < InWanted)
+        {
+            _pendingBytes = 0;
+        }
+        return bAdded;
+    }
+
+    StreamReaderStats StreamArchiveReader::GetStats() const
+    {
+        std::unique_lock<std::mutex> lock(_impl->lock);
+        return _impl->stats;
+    }
+}
@@ -0,0 +1,233 @@
+// Copyright (c) David Sleeper (Sleeping Robot LLC)
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+
+#include "SPPRTraversal.h"
+
+namespace SPP
+{
+    // clock reads are not free, only check the time every few steps
+    static constexpr size_t TraversalClockInterval = 32;
+
+    ReflectedTraversal::ReflectedTraversal(ReflectedStruct* InStruct, void* InObject, IVisitor* InVisitor)
+    {
+        Reset(InStruct, InObject, InVisitor);
+    }
+
+    void ReflectedTraversal::Reset(ReflectedStruct* InStruct, void* InObject, IVisitor* InVisitor)
+    {
+        _struct = InStruct;
+        _object = InObject;
+        _visitor = InVisitor;
+        _stack.clear();
+        _started = false;
+        _nodesVisited = 0;
+    }
+
+    // returns false when the value was handled in place (leaf or refused), the caller closes it then
+    bool ReflectedTraversal::PushValue(ReflectedProperty* InProperty, void* InOwner)
+    {
+        auto typeData = InProperty->GetCPPType().GetTypeData();
+
+        Frame newFrame;
+        newFrame.Property = InProperty;
+        newFrame.Owner = InOwner;
+
+        if (typeData->structureRef && !InProperty->IsAccessorBased())
+        {
+            if (!_visitor->EnterStructure(*typeData->structureRef))
+            {
+                return false;
+            }
+            newFrame.Type = EFrame::Struct;
+            newFrame.Struct = newFrame.CurStruct = typeData->structureRef.get();
+            _stack.push_back(newFrame);
+            return true;
+        }
+
+        if (typeData->arrayManipulator && InProperty->GetInner())
+        {
+            _visitor->BeginArray(*InProperty);
+            newFrame.Type = EFrame::Array;
+            _stack.push_back(newFrame);
+            return true;
+        }
+
+        InProperty->Visit(InOwner, _visitor);
+        return false;
+    }
+
+    // the top frame was just popped, close it in its parent
+    void ReflectedTraversal::FinishChild(ReflectedProperty* InChildProperty)
+    {
+        if (_stack.empty())
+        {
+            return;
+        }
+
+        auto& parentFrame = _stack.back();
+        if (parentFrame.Type == EFrame::Struct)
+        {
+            _visitor->ExitProprety(*InChildProperty);
+        }
+        else
+        {
+            _visitor->EndArrayItem(parentFrame.ElementIdx);
+            parentFrame.ElementIdx++;
+        }
+    }
+
+    void ReflectedTraversal::AbortTop()
+    {
+        auto& topFrame = _stack.back();
+        auto topProperty = topFrame.Property;
+
+        if (topFrame.Type == EFrame::Struct)
+        {
+            _visitor->ExitStructure(*topFrame.Struct);
+        }
+        else
+        {
+            _visitor->EndArray(*topFrame.Property);
+        }
+
+        _stack.pop_back();
+        FinishChild(topProperty);
+    }
+
+    // re-derive every frame's owner from the root, elements may have moved or gone away since the last slice
+    void ReflectedTraversal::Refresh()
+    {
+        for (size_t Iter = 1; Iter < _stack.size(); Iter++)
+        {
+            auto& parentFrame = _stack[Iter - 1];
+
+            if (parentFrame.Type == EFrame::Struct)
+            {
+                _stack[Iter].Owner = parentFrame.GetValue();
+                continue;
+            }
+
+            auto arrayAddr = parentFrame.GetValue();
+            auto arrayManipulator = parentFrame.Property->GetCPPType().GetTypeData()->arrayManipulator.get();
+            if (parentFrame.ElementIdx >= arrayManipulator->Size(arrayAddr))
+            {
+                // the element being visited was removed
+                while (_stack.size() > Iter)
+                {
+                    AbortTop();
+                }
+                return;
+            }
+
+            _stack[Iter].Owner = arrayManipulator->Element(arrayAddr, (int32_t)parentFrame.ElementIdx);
+        }
+    }
+
+    void ReflectedTraversal::StepStruct(Frame& InFrame)
+    {
+        while (InFrame.CurStruct && InFrame.PropertyIdx >= InFrame.CurStruct->GetPropertyCount())
+        {
+            InFrame.CurStruct = InFrame.CurStruct->GetParent();
+            InFrame.PropertyIdx = 0;
+        }
+
+        if (!InFrame.CurStruct)
+        {
+            _visitor->ExitStructure(*InFrame.Struct);
+            auto frameProperty = InFrame.Property;
+            _stack.pop_back();
+            FinishChild(frameProperty);
+            return;
+        }
+
+        auto curProp = InFrame.CurStruct->GetProperty(InFrame.PropertyIdx++);
+        auto structAddr = InFrame.GetValue();
+        _nodesVisited++;
+
+        // InFrame is invalid once something is pushed
+        if (_visitor->EnterProprety(*curProp) && !PushValue(curProp, structAddr))
+        {
+            _visitor->ExitProprety(*curProp);
+        }
+    }
+
+    void ReflectedTraversal::StepArray(Frame& InFrame)
+    {
+        auto arrayAddr = InFrame.GetValue();
+        auto arrayManipulator = InFrame.Property->GetCPPType().GetTypeData()->arrayManipulator.get();
+
+        // size is read every step, the array may have changed since the last slice
+        if (InFrame.ElementIdx >= arrayManipulator->Size(arrayAddr))
+        {
+            _visitor->EndArray(*InFrame.Property);
+            auto frameProperty = InFrame.Property;
+            _stack.pop_back();
+            FinishChild(frameProperty);
+            return;
+        }
+
+        const size_t elementIdx = InFrame.ElementIdx;
+        _nodesVisited++;
+
+        _visitor->BeginArrayItem(elementIdx);
+        if (!PushValue(InFrame.Property->GetInner(), arrayManipulator->Element(arrayAddr, (int32_t)elementIdx)))
+        {
+            _visitor->EndArrayItem(elementIdx);
+            InFrame.ElementIdx++;
+        }
+    }
+
+    bool ReflectedTraversal::Step(const TraversalBudget& InBudget)
+    {
+        if (!_visitor || !_struct)
+        {
+            return true;
+        }
+
+        if (!_started)
+        {
+            _started = true;
+            if (_visitor->EnterStructure(*_struct))
+            {
+                Frame rootFrame;
+                rootFrame.Owner = _object;
+                rootFrame.Struct = rootFrame.CurStruct = _struct;
+                _stack.push_back(rootFrame);
+            }
+        }
+        else
+        {
+            Refresh();
+        }
+
+        const auto startTime = std::chrono::steady_clock::now();
+        const size_t startNodes = _nodesVisited;
+        size_t stepCount = 0;
+
+        while (!_stack.empty())
+        {
+            if (InBudget.MaxNodes && _nodesVisited - startNodes >= InBudget.MaxNodes)
+            {
+                return false;
+            }
+            if (InBudget.MaxMilliseconds > 0 && (++stepCount % TraversalClockInterval) == 0 &&
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() >= InBudget.MaxMilliseconds)
+            {
+                return false;
+            }
+
+            auto& topFrame = _stack.back();
+            if (topFrame.Type == EFrame::Struct)
+            {
+                StepStruct(topFrame);
+            }
+            else
+            {
+                StepArray(topFrame);
+            }
+        }
+
+        return true;
+    }
+}
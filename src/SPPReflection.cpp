@@ -4,6 +4,8 @@
 
 #include "SPPReflection.h"
 #include <mutex>
+#include <algorithm>
+#include <bit>
 
 namespace SPP
 {
@@ -57,6 +59,12 @@ namespace SPP
 
     type_data* TypeCollection::Push(std::unique_ptr<type_data>&& InData)
     {
+#if SPP_REFLECTION_INSTRUMENTATION
+        // the key is only known once the type is stored, so no ReflectionScope, same single load when off
+        const bool bInstrumented = GetReflectionInstrumentMode() != 0;
+        const uint64_t startNs = bInstrumented ? GetInstrumentTimeNs() : 0;
+#endif
+
         for (const auto& curType : _impl->type_store)
         {
             if (*InData == *curType)
@@ -66,7 +74,15 @@ namespace SPP
         }
 
         _impl->type_store.push_back(std::move(InData));
-        return _impl->type_store.back().get();
+        auto newType = _impl->type_store.back().get();
+
+#if SPP_REFLECTION_INSTRUMENTATION
+        if (bInstrumented)
+        {
+            RecordReflectionEvent(EReflectionCounter::TypeRegistration, newType, nullptr, newType->GetName().c_str(), startNs, GetInstrumentTimeNs());
+        }
+#endif
+        return newType;
     }
 
     type_data* TypeCollection::GetType(const char* InName)
@@ -103,9 +119,35 @@ namespace SPP
 
     CPPType get_type_by_name(const char* InString)
     {
+#if SPP_REFLECTION_INSTRUMENTATION
+        if (GetReflectionInstrumentMode())
+        {
+            const uint64_t startNs = GetInstrumentTimeNs();
+            auto foundType = GetTypeCollection().GetType(InString);
+            // misses all land on the null key
+            RecordReflectionEvent(EReflectionCounter::NameLookup, foundType, "get_type_by_name", foundType ? InString : "<not found>", startNs, GetInstrumentTimeNs());
+            return CPPType(foundType);
+        }
+#endif
         return CPPType(GetTypeCollection().GetType(InString));
     }
 
+    uint32_t GetVisitKind(CPPType InType)
+    {
+        SE_ASSERT(InType.GetTypeData());
+
+        static std::mutex visitKindLock;
+        static uint32_t nextVisitKind = 1;
+
+        std::unique_lock<std::mutex> lock(visitKindLock);
+        auto typeData = InType.GetTypeData();
+        if (!typeData->visit_kind)
+        {
+            typeData->visit_kind = nextVisitKind++;
+        }
+        return typeData->visit_kind;
+    }
+
     bool CPPType::DerivedFrom(const CPPType& InValue) const
     {
         if (_typeData->structureRef)
@@ -115,8 +157,43 @@ namespace SPP
         return false;
     }
 
+    ReflectedProperty* ReflectedStruct::FindProperty(std::string_view InName) const
+    {
+        ReflectionScope lookupScope(EReflectionCounter::NameLookup, this, _type->GetName().c_str(), "FindProperty");
+        auto curStruct = this;
+
+        while (curStruct)
+        {
+            for (const auto& curProp : curStruct->_properties)
+            {
+                if (curProp->GetName() == InName)
+                {
+                    return curProp.get();
+                }
+            }
+            curStruct = curStruct->_parent;
+        }
+
+        return nullptr;
+    }
+
+    void ReflectedStruct::IterateProperties(const std::function< void(ReflectedProperty*) >& InFunc) const
+    {
+        auto curStruct = this;
+
+        while (curStruct)
+        {
+            for (const auto& curProp : curStruct->_properties)
+            {
+                InFunc(curProp.get());
+            }
+            curStruct = curStruct->_parent;
+        }
+    }
+
     void ReflectedStruct::Visit(void* InStruct, IVisitor* InVisitor)
     {
+        ReflectionScope visitScope(EReflectionCounter::Visit, this, nullptr, _type->GetName().c_str());
         auto curStruct = this;
 
         if (InVisitor->EnterStructure(*this))
@@ -125,8 +202,6 @@ namespace SPP
             {
                 for (const auto& curProp : curStruct->_properties)
                 {
-                    SPP_LOG(LOG_REFLECTION, LOG_INFO, "NAME: %s OFFSET: %zd", curProp->GetName().c_str(), curProp->GetPropOffset());
-
                     if (InVisitor->EnterProprety(*curProp))
                     {
                         curProp->Visit(InStruct, InVisitor);
@@ -140,4 +215,361 @@ namespace SPP
             InVisitor->ExitStructure(*this);
         }
     }
+
+    void ReflectedStruct::BuildPlan(MetadataVector< PlanStep >& OutPlan, bool (ReflectedProperty::* InIsBlock)() const)
+    {
+        OutPlan.clear();
+
+        std::vector< PlanStep > blockSteps;
+        auto curStruct = this;
+
+        while (curStruct)
+        {
+            for (const auto& curProp : curStruct->_properties)
+            {
+                if (curProp->GetKind() == EPropertyKind::Bitfield)
+                {
+                    // once per word, from its leader
+                    auto bitProp = static_cast<BitfieldProperty*>(curProp.get());
+                    if (!bitProp->IsWordLeader())
+                    {
+                        continue;
+                    }
+
+                    const size_t wordSize = bitProp->GetWordSize();
+                    const uint64_t fullMask = wordSize == 8 ? ~0ull : (1ull << (wordSize * 8)) - 1;
+                    if (bitProp->GetWordMask() == fullMask)
+                    {
+                        blockSteps.push_back({ bitProp->GetPropOffset(), wordSize, nullptr });
+                    }
+                    else
+                    {
+                        OutPlan.push_back({ bitProp->GetPropOffset(), wordSize, nullptr, bitProp->GetWordMask() });
+                    }
+                }
+                else if (((*curProp).*InIsBlock)())
+                {
+                    blockSteps.push_back({ curProp->GetPropOffset(), curProp->GetCPPType()->get_sizeof, nullptr });
+                }
+                else
+                {
+                    OutPlan.push_back({ curProp->GetPropOffset(), 0, curProp.get() });
+                }
+            }
+            curStruct = curStruct->_parent;
+        }
+
+        std::sort(blockSteps.begin(), blockSteps.end(), [](const PlanStep& InA, const PlanStep& InB)
+            {
+                return InA.Offset < InB.Offset;
+            });
+
+        // only merge when directly touching, a gap could be padding or an unreflected member we know nothing about
+        for (const auto& curBlock : blockSteps)
+        {
+            if (!OutPlan.empty() &&
+                OutPlan.back().Property == nullptr &&
+                OutPlan.back().Mask == 0 &&
+                OutPlan.back().Offset + OutPlan.back().Size == curBlock.Offset)
+            {
+                OutPlan.back().Size += curBlock.Size;
+            }
+            else
+            {
+                OutPlan.push_back(curBlock);
+            }
+        }
+    }
+
+    void ReflectedStruct::BuildPlans()
+    {
+        // bitfields sharing a word: the first one found leads and carries the mask of all of them
+        std::vector< BitfieldProperty* > wordLeaders;
+        IterateProperties([&wordLeaders](ReflectedProperty* InProperty)
+        {
+            if (InProperty->GetKind() != EPropertyKind::Bitfield)
+            {
+                return;
+            }
+
+            auto bitProp = static_cast<BitfieldProperty*>(InProperty);
+            auto foundLeader = std::find_if(wordLeaders.begin(), wordLeaders.end(), [bitProp](BitfieldProperty* InLeader)
+            {
+                return InLeader->GetPropOffset() == bitProp->GetPropOffset() && InLeader->GetWordSize() == bitProp->GetWordSize();
+            });
+
+            if (foundLeader == wordLeaders.end())
+            {
+                bitProp->_wordLeader = bitProp;
+                bitProp->_wordMask = bitProp->GetMask();
+                wordLeaders.push_back(bitProp);
+            }
+            else
+            {
+                bitProp->_wordLeader = *foundLeader;
+                bitProp->_wordMask = 0;
+                (*foundLeader)->_wordMask |= bitProp->GetMask();
+            }
+        });
+
+        BuildPlan(_copyPlan, &ReflectedProperty::IsBlockCopyable);
+        BuildPlan(_comparePlan, &ReflectedProperty::IsBlockComparable);
+
+        auto isWholeBlock = [this](const MetadataVector< PlanStep >& InPlan)
+        {
+            return InPlan.size() == 1 && !InPlan[0].Property && !InPlan[0].Mask && InPlan[0].Offset == 0 && InPlan[0].Size == _type->get_sizeof;
+        };
+        _bWholeCopy = _type->is_trivially_copyable && isWholeBlock(_copyPlan);
+        _bWholeCompare = _type->is_bitwise_comparable && isWholeBlock(_comparePlan);
+
+        _flatLayout.clear();
+        BuildFlatLayout();
+
+        for (auto& curFlagList : _flagProperties)
+        {
+            curFlagList.clear();
+        }
+        IterateProperties([this](ReflectedProperty* InProperty)
+        {
+            for (uint32_t Iter = 0; Iter < PropertyFlagCount; Iter++)
+            {
+                if (InProperty->GetFlags() & (1u << Iter))
+                {
+                    _flagProperties[Iter].push_back(InProperty);
+                }
+            }
+        });
+    }
+
+    void ReflectedStruct::BuildFlatLayout()
+    {
+        std::function< void(const ReflectedStruct*, size_t) > flattenStruct = [&](const ReflectedStruct* InStruct, size_t InStructOffset)
+        {
+            InStruct->IterateProperties([&](ReflectedProperty* InProperty)
+            {
+                const auto propKind = InProperty->GetKind();
+                auto nestedStruct = InProperty->GetCPPType().GetTypeData()->structureRef.get();
+
+                if (propKind == EPropertyKind::Struct && nestedStruct && !InProperty->IsAccessorBased())
+                {
+                    flattenStruct(nestedStruct, InStructOffset + InProperty->GetPropOffset());
+                    return;
+                }
+
+                FlatStep newStep;
+                newStep.Property = InProperty;
+                newStep.Kind = propKind;
+                newStep.Accessor = InProperty->IsAccessorBased();
+                newStep.Offset = newStep.Accessor ? InStructOffset : InStructOffset + InProperty->GetPropOffset();
+                _flatLayout.push_back(newStep);
+            });
+        };
+
+        flattenStruct(this, 0);
+    }
+
+    const MetadataVector< ReflectedProperty* >& ReflectedStruct::GetPropertiesWithFlag(PropertyFlags::EPropertyFlag InFlag) const
+    {
+        SE_ASSERT(InFlag != 0 && (InFlag & (InFlag - 1)) == 0);
+        return _flagProperties[std::countr_zero((uint32_t)InFlag)];
+    }
+
+    void ReflectedStruct::IteratePropertiesWithFlags(uint32_t InFlags, const std::function< void(ReflectedProperty*) >& InFunc) const
+    {
+        if (!InFlags)
+        {
+            IterateProperties(InFunc);
+            return;
+        }
+
+        const MetadataVector< ReflectedProperty* >* rarestList = nullptr;
+        for (uint32_t Iter = 0; Iter < PropertyFlagCount; Iter++)
+        {
+            if ((InFlags & (1u << Iter)) && (!rarestList || _flagProperties[Iter].size() < rarestList->size()))
+            {
+                rarestList = &_flagProperties[Iter];
+            }
+        }
+
+        for (auto curProp : *rarestList)
+        {
+            if (curProp->HasFlags(InFlags))
+            {
+                InFunc(curProp);
+            }
+        }
+    }
+
+    void ReflectedStruct::VisitWithFlags(void* InStruct, IVisitor* InVisitor, uint32_t InFlags)
+    {
+        if (InVisitor->EnterStructure(*this))
+        {
+            IteratePropertiesWithFlags(InFlags, [&](ReflectedProperty* curProp)
+            {
+                if (InVisitor->EnterProprety(*curProp))
+                {
+                    curProp->Visit(InStruct, InVisitor);
+                    InVisitor->ExitProprety(*curProp);
+                }
+            });
+
+            InVisitor->ExitStructure(*this);
+        }
+    }
+
+    static inline uint64_t ReadPlanWord(const void* InWord, size_t InSize)
+    {
+        uint64_t oWord = 0;
+        std::memcpy(&oWord, InWord, InSize);
+        return oWord;
+    }
+
+    void ReflectedStruct::Clone(void* InSrcStruct, void* InDstStruct) const
+    {
+        if (InSrcStruct == InDstStruct)
+        {
+            return;
+        }
+
+        if (_bWholeCopy)
+        {
+            std::memcpy(InDstStruct, InSrcStruct, _type->get_sizeof);
+            return;
+        }
+
+        for (const auto& curStep : _copyPlan)
+        {
+            if (curStep.Property)
+            {
+                curStep.Property->Clone(InSrcStruct, InDstStruct);
+            }
+            else if (curStep.Mask)
+            {
+                auto dstWord = (uint8_t*)InDstStruct + curStep.Offset;
+                const uint64_t newWord = (ReadPlanWord(dstWord, curStep.Size) & ~curStep.Mask) |
+                    (ReadPlanWord((uint8_t*)InSrcStruct + curStep.Offset, curStep.Size) & curStep.Mask);
+                std::memcpy(dstWord, &newWord, curStep.Size);
+            }
+            else
+            {
+                std::memcpy((uint8_t*)InDstStruct + curStep.Offset, (uint8_t*)InSrcStruct + curStep.Offset, curStep.Size);
+            }
+        }
+    }
+
+    uint64_t ReflectedStruct::Hash(void* InStruct, uint64_t InSeed) const
+    {
+        if (_bWholeCompare)
+        {
+            return HashBytes(InStruct, _type->get_sizeof, InSeed);
+        }
+
+        for (const auto& curStep : _comparePlan)
+        {
+            if (curStep.Property)
+            {
+                InSeed = curStep.Property->Hash(InStruct, InSeed);
+            }
+            else if (curStep.Mask)
+            {
+                InSeed = HashValue(ReadPlanWord((uint8_t*)InStruct + curStep.Offset, curStep.Size) & curStep.Mask, InSeed);
+            }
+            else
+            {
+                InSeed = HashBytes((uint8_t*)InStruct + curStep.Offset, curStep.Size, InSeed);
+            }
+        }
+
+        return InSeed;
+    }
+
+    bool ReflectedStruct::Equals(void* InStructA, void* InStructB) const
+    {
+        if (InStructA == InStructB)
+        {
+            return true;
+        }
+
+        if (_bWholeCompare)
+        {
+            return BytesEqual(InStructA, InStructB, _type->get_sizeof);
+        }
+
+        for (const auto& curStep : _comparePlan)
+        {
+            if (curStep.Property)
+            {
+                if (!curStep.Property->Equals(InStructA, InStructB))
+                {
+                    return false;
+                }
+            }
+            else if (curStep.Mask)
+            {
+                if ((ReadPlanWord((uint8_t*)InStructA + curStep.Offset, curStep.Size) ^
+                    ReadPlanWord((uint8_t*)InStructB + curStep.Offset, curStep.Size)) & curStep.Mask)
+                {
+                    return false;
+                }
+            }
+            else if (!BytesEqual((uint8_t*)InStructA + curStep.Offset, (uint8_t*)InStructB + curStep.Offset, curStep.Size))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    ReflectedPatch ReflectedStruct::Diff(void* InStructA, void* InStructB) const
+    {
+        ReflectedPatch oPatch(this);
+        DiffInto(InStructA, InStructB, oPatch);
+        return oPatch;
+    }
+
+    void ReflectedStruct::DiffInto(void* InStructA, void* InStructB, ReflectedPatch& InOutPatch) const
+    {
+        auto curStruct = this;
+
+        while (curStruct)
+        {
+            for (const auto& curProp : curStruct->_properties)
+            {
+                curProp->Diff(InStructA, InStructB, InOutPatch);
+            }
+            curStruct = curStruct->_parent;
+        }
+    }
+
+    bool ReflectedStruct::Apply(void* InStruct, const ReflectedPatch& InPatch) const
+    {
+        if (InPatch.GetRootStruct() && InPatch.GetRootStruct() != this)
+        {
+            return false;
+        }
+
+        bool bAllApplied = true;
+
+        for (const auto& curEntry : InPatch.GetEntries())
+        {
+            auto curPath = InPatch.GetPath(curEntry);
+            void* curAddr = InStruct;
+
+            for (uint32_t Iter = 0; curAddr && Iter + 1 < curEntry.PathCount; Iter++)
+            {
+                const auto& curStep = curPath[Iter];
+                curAddr = curStep.KeySize ? curStep.Property->NavigateKey(curAddr, InPatch.GetKeyData(curStep), curStep.KeySize) :
+                    curStep.Property->Navigate(curAddr, curStep.Index);
+            }
+
+            if (!curAddr || 
+                !curPath[curEntry.PathCount - 1].Property->ApplyPatch(curAddr, curEntry, InPatch.GetValueData(curEntry)))
+            {
+                bAllApplied = false;
+            }
+        }
+
+        return bAllApplied;
+    }
 }
\ No newline at end of file
@@ -4,8 +4,21 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <limits>
 
 #include "SPPReflection.h"
+#include "SPPRPropertyPath.h"
+#include "SPPRSoA.h"
+#include "SPPRQuery.h"
+#include "SPPRParallel.h"
+#include "SPPRTraversal.h"
+#include "SPPRGraph.h"
+#include "SPPRCollector.h"
+#include "SPPRArchive.h"
+#include "SPPRStream.h"
 
 namespace SPP
 {
@@ -21,50 +34,48 @@ namespace SPP
 
     struct IObjectVisitor : IVisitor
     {
-        virtual void VisitValue(const ReflectedProperty& InProperty, ObjectBase *& InValue) 
+        IObjectVisitor()
         {
+            BindVisitHandler<&IObjectVisitor::VisitValue>();
         }
-    };
-
-    //template<>
-    //void VisitValue< std::string >(const ReflectedProperty& InProperty, std::string& InValue)
-    //{
 
-    //}
+        virtual void VisitValue(const ReflectedProperty&, ObjectBase *&) 
+        {
+        }
+    };
 
-    class ObjectProperty : public ReflectedProperty
+    // any ObjectBase pointer is visited as an ObjectBase*, and followed as the type it really points to
+    // PointeeT is the declared pointee, the pointer is stored as one so the upcast to ObjectBase is a real one
+    template<typename PointeeT> requires (std::is_base_of_v<ObjectBase, PointeeT>)
+    class ObjectProperty : public PointerProperty
     {
+    protected:
+        uint32_t _visitKind = 0;
 
     public:
-        ObjectProperty(const std::string& InName, CPPType InType, size_t InOffset = 0) :
-            ReflectedProperty(InName, InType, InOffset) {}
+        ObjectProperty(const std::string& InName, CPPType InType, CPPType InPointeeType, size_t InOffset = 0) :
+            PointerProperty(InName, InType, InPointeeType, InOffset), _visitKind(GetVisitKind(get_type< ObjectBase* >())) {}
         virtual ~ObjectProperty() {}
 
-        ObjectBase** AccessValue(void* structAddr)
+        virtual CPPType ResolvePointeeType(void* InPointee) const override
         {
-            return (ObjectBase**)((uint8_t*)structAddr + _propOffset);
+            return static_cast<ObjectBase*>(static_cast<PointeeT*>(InPointee))->GetCPPType();
         }
 
-        virtual void Visit(void* InStruct, IVisitor* InVisitor) 
+        virtual void Visit(void* InStruct, IVisitor* InVisitor) override
         {
-            auto & value = *AccessValue(InStruct);
-
-            IObjectVisitor* objVisitor = dynamic_cast<IObjectVisitor*>(InVisitor);
-            if (objVisitor)
-            {
-                objVisitor->VisitValue(*this, value);
-            }
+            InVisitor->VisitCustom(_visitKind, *this, AccessValueAddress(InStruct));
         }
     };
 
+    // subsumes the library's C_ClassPointer overload
     template<typename T, typename ClassSet> requires 
-    (std::is_pointer_v<T> && std::is_base_of_v<ObjectBase, std::remove_pointer_t<T> >) 
+    (C_ClassPointer<T> && std::is_base_of_v<ObjectBase, std::remove_pointer_t<T> >) 
     std::unique_ptr< ReflectedProperty > CreateProperty(const char* InName, T ClassSet::* prop)
     {
         auto calcOffset = offsetOf(prop);
-        auto curType = get_type<T>();
-        auto newProp = std::make_unique< ObjectProperty >(InName, curType, calcOffset);
-        return std::move(newProp);
+        auto newProp = std::make_unique< ObjectProperty< std::remove_pointer_t<T> > >(InName, get_type<T>(), get_type< std::remove_pointer_t<T> >(), calcOffset);
+        return newProp;
     }    
 }
 
@@ -79,6 +90,16 @@ struct SceneParent : public ObjectBase
     int32_t matrix;
 };
 
+struct GCActor : public ObjectBase
+{
+    ENABLE_REFLECTION_C(ObjectBase)
+
+public:
+    GCActor* Target = nullptr;
+    std::vector< GCActor* > Children;
+    int32_t Value = 0;
+};
+
 struct PlayerData
 {
     int GUID = -1;
@@ -91,6 +112,122 @@ struct PlayerFighters
     float health;
 };
 
+struct Particle
+{
+    float X = 0;
+    float Y = 0;
+    float Z = 0;
+    int32_t ID = 0;
+    std::string Tag;
+};
+
+// laid out in declaration order without thought, for the layout analyzer
+struct Unit
+{
+    bool bActive = false;
+    double Mass = 0;
+    uint8_t Team = 0;
+    std::string Name;
+    int32_t ID = 0;
+    uint16_t Flags = 0;
+    double Velocity = 0;
+    bool bSelected = false;
+};
+
+// one of each wrapper the reflection understands
+struct Loadout
+{
+    std::shared_ptr< PlayerData > Owner;
+    std::optional< PlayerFighters > Champion;
+    std::optional< int32_t > Slot;
+    // not owned
+    float* Scale = nullptr;
+    // owned, registered with RC_ADD_OWNED_PROP
+    PlayerFighters* Reserve = nullptr;
+    std::variant< std::monostate, int32_t, std::string, PlayerFighters > Reward;
+
+    Loadout() {}
+    Loadout(const Loadout&) = delete;
+    ~Loadout()
+    {
+        delete Reserve;
+    }
+};
+
+struct Inventory
+{
+    std::unordered_map< std::string, PlayerFighters > Roster;
+    std::map< int32_t, float > Cooldowns;
+    std::set< int32_t > Unlocked;
+};
+
+// flag heavy replicated state, bits instead of a bool per byte
+struct NetState
+{
+    uint32_t bAlive : 1 = 0;
+    uint32_t bCrouched : 1 = 0;
+    uint32_t Team : 3 = 0;
+    int32_t Lean : 4 = 0;
+    // bits 0 and 4-7 are reflected, the rest belong to someone else
+    uint32_t Mask = 0;
+    std::bitset< 100 > Seen;
+    float Health = 0;
+};
+
+// Scratch isn't reflected, one layout could be taken as raw bytes and the other has padding
+struct ScoreTally
+{
+    int32_t Total = 0;
+    int32_t Scratch = 0;
+};
+
+struct ScoreTallyPadded
+{
+    int32_t Total = 0;
+    uint8_t Scratch = 0;
+};
+
+// one byte underlying type, archived as one byte rather than as an int
+enum class EReplayMode : uint8_t
+{
+    Live,
+    Recorded,
+    Spectated = 200
+};
+
+// mostly small numbers, what the compact archive encoding is for
+struct ReplayFrame
+{
+    int32_t FrameID = 0;
+    uint32_t Score = 0;
+    int16_t Drift = 0;
+    EReplayMode Mode = EReplayMode::Live;
+    // quantized to 10 bits over 0-100 in compact archives
+    float Speed = 0;
+    std::vector< int64_t > TimeStamps;
+    std::vector< int32_t > Counts;
+    std::string Tag;
+    std::optional< int32_t > Checkpoint;
+    NetState Net;
+    Inventory Items;
+};
+
+struct WorldNode
+{
+    WorldNode* Left = nullptr;
+    WorldNode* Right = nullptr;
+    WorldNode* Back = nullptr;
+    int32_t Value = 0;
+};
+
+REFL_STATIC_START(Particle)
+    RS_ADD_PROP(X)
+    RS_ADD_PROP(Y)
+    RS_ADD_PROP(Z)
+    RS_ADD_PROP(ID)
+    RS_ADD_PROP(Tag)
+REFL_STATIC_END
+
 struct Vector2
 {
 private:
@@ -149,6 +286,92 @@ SPP_AUTOREG_START
 
     REFL_CLASS_END
 
+    REFL_CLASS_START_STATIC(Particle)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(Unit)
+        RC_ADD_PROP(bActive)
+        RC_ADD_PROP(Mass)
+        RC_ADD_PROP(Team)
+        RC_ADD_PROP(Name)
+        RC_ADD_PROP(ID)
+        RC_ADD_PROP(Flags)
+        RC_ADD_PROP(Velocity)
+        RC_ADD_PROP(bSelected)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(Loadout)
+        RC_ADD_PROP(Owner)
+        RC_ADD_PROP(Champion)
+        RC_ADD_PROP(Slot)
+        RC_ADD_PROP(Scale)
+        RC_ADD_OWNED_PROP(Reserve)
+        RC_ADD_PROP(Reward)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(Inventory)
+        RC_ADD_PROP_FLAGS(Roster, PropertyFlags::DeterministicOrder)
+        RC_ADD_PROP(Cooldowns)
+        RC_ADD_PROP(Unlocked)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(NetState)
+        RC_ADD_BITFIELD(bAlive)
+        RC_ADD_BITFIELD(bCrouched)
+        RC_ADD_BITFIELD(Team)
+        RC_ADD_BITFIELD(Lean)
+        RC_ADD_BITS(Mask, bVisible, 0, 1)
+        RC_ADD_BITS(Mask, Level, 4, 4)
+        RC_ADD_PROP(Seen)
+        RC_ADD_PROP(Health)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(ScoreTally)
+        RC_ADD_PROP(Total)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(ScoreTallyPadded)
+        RC_ADD_PROP(Total)
+    REFL_CLASS_END
+
+    REFL_ENUM_START(EReplayMode)
+        RC_ENUM_VALUE(EReplayMode::Live, "Live")
+        RC_ENUM_VALUE(EReplayMode::Recorded, "Recorded")
+        RC_ENUM_VALUE(EReplayMode::Spectated, "Spectated")
+    REFL_ENUM_END
+
+    REFL_CLASS_START(ReplayFrame)
+        RC_ADD_PROP(FrameID)
+        RC_ADD_PROP(Score)
+        RC_ADD_PROP(Drift)
+        RC_ADD_PROP(Mode)
+        RC_ADD_PROP(Speed)
+        RC_PROP_QUANTIZE(0, 100, 10)
+        RC_ADD_PROP(TimeStamps)
+        RC_ADD_PROP(Counts)
+        RC_ADD_PROP(Tag)
+        RC_ADD_PROP(Checkpoint)
+        RC_ADD_PROP(Net)
+        RC_ADD_PROP(Items)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(WorldNode)
+        RC_ADD_PROP(Left)
+        RC_ADD_PROP(Right)
+        RC_ADD_PROP(Back)
+        RC_ADD_PROP(Value)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(SceneParent)
+        RC_ADD_PROP(matrix)
+    REFL_CLASS_END
+
+    REFL_CLASS_START(GCActor)
+        RC_ADD_PROP(Target)
+        RC_ADD_PROP(Children)
+        RC_ADD_PROP(Value)
+    REFL_CLASS_END
+
     REFL_CLASS_START(PlayerData)
 
         RC_ADD_PROP(GUID)
@@ -227,12 +450,13 @@ SPP_AUTOREG_START
 
     REFL_CLASS_START(SuperGuy)
 
-        RC_ADD_PROP(health)
+        RC_ADD_PROP_FLAGS(health, Replicated | SaveGame)
+            RC_PROP_ATTRIBUTE("Max", 100)
         RC_ADD_PROP(parent)
-        RC_ADD_PROP(data)
-        RC_ADD_PROP(HitMe)
-        RC_ADD_PROP(Players)
-        RC_ADD_PROP(ourGuy)
+        RC_ADD_PROP_FLAGS(data, SaveGame)
+        RC_ADD_PROP_FLAGS(HitMe, Transient)
+        RC_ADD_PROP_FLAGS(Players, SaveGame)
+        RC_ADD_PROP_FLAGS(ourGuy, Replicated | SaveGame)
 
         RC_ADD_CONSTRUCTOR(const std::string &, int32_t)
         RC_ADD_CONSTRUCTOR(const std::string&)
@@ -244,7 +468,449 @@ SPP_AUTOREG_START
 SPP_AUTOREG_END
 
 
+// SuperGuy holds unique_ptrs so the compiler won't generate a copy constructor, this is the deep copy
+// written the way Clone does it: existing pointees are assigned into, only missing ones are allocated
+template<typename T>
+void CopyOwnedByHand(const std::unique_ptr<T>& InSrc, std::unique_ptr<T>& InDst)
+{
+    if (!InSrc)
+    {
+        InDst.reset();
+    }
+    else if (InDst)
+    {
+        *InDst = *InSrc;
+    }
+    else
+    {
+        InDst = std::make_unique<T>(*InSrc);
+    }
+}
 
+void CopySuperGuyByHand(SuperGuy& InSrc, SuperGuy& InDst)
+{
+    (GuyTest&)InDst = (GuyTest&)InSrc;
+    InDst.health = InSrc.health;
+    InDst.parent = InSrc.parent;
+    InDst.data = InSrc.data;
+    InDst.ourGuy = InSrc.ourGuy;
+    CopyOwnedByHand(InSrc.GetHitMe(), InDst.GetHitMe());
+    InDst.GetPlayers().resize(InSrc.GetPlayers().size());
+    for (size_t Iter = 0; Iter < InSrc.GetPlayers().size(); Iter++)
+    {
+        CopyOwnedByHand(InSrc.GetPlayers()[Iter], InDst.GetPlayers()[Iter]);
+    }
+}
+
+void BenchClone(SuperGuy& InGuy)
+{
+    constexpr int32_t BenchCount = 100000;
+    auto classData = InGuy.GetCPPType().GetTypeData()->structureRef.get();
+
+    SuperGuy dstGuy;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (int32_t Iter = 0; Iter < BenchCount; Iter++)
+    {
+        CopySuperGuyByHand(InGuy, dstGuy);
+    }
+    auto handTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    startTime = std::chrono::high_resolution_clock::now();
+    for (int32_t Iter = 0; Iter < BenchCount; Iter++)
+    {
+        classData->Clone(&InGuy, &dstGuy);
+    }
+    auto cloneTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    SPP_LOG(LOG_APP, LOG_INFO, "CLONE BENCH (%d): by hand %f ms, reflected %f ms, plan steps %zd", 
+        BenchCount, handTime, cloneTime, classData->GetCopyPlan().size());
+    classData->LogOut(&dstGuy);
+}
+
+// order dependent checksum, so the parallel merge has to match serial visitation
+struct ChecksumVisitor : public IParallelVisitor
+{
+    uint64_t Checksum = 0;
+    size_t ValueCount = 0;
+
+    virtual bool IsThreadSafe() const override { return true; }
+
+    virtual void VisitValue(const ReflectedProperty&, int32_t& InValue) override { Add(InValue); }
+    virtual void VisitValue(const ReflectedProperty&, float& InValue) override { Add(InValue); }
+    virtual void VisitValue(const ReflectedProperty&, std::string& InValue) override
+    {
+        Checksum = HashBytes(InValue.data(), InValue.size(), Checksum);
+        ValueCount++;
+    }
+
+    template<typename T>
+    void Add(const T& InValue)
+    {
+        Checksum = HashValue(InValue, Checksum);
+        ValueCount++;
+    }
+
+    virtual void Merge(IParallelVisitor& InOther) override
+    {
+        auto& other = (ChecksumVisitor&)InOther;
+        Checksum = HashValue(other.Checksum, Checksum);
+        ValueCount += other.ValueCount;
+    }
+};
+
+// ObjectBase pointers reach VisitObject through the handler table
+struct ObjectCounter : public IVisitor
+{
+    int32_t ObjectCount = 0;
+    int32_t NullCount = 0;
+
+    ObjectCounter()
+    {
+        BindVisitHandler<&ObjectCounter::VisitObject>();
+    }
+
+    void VisitObject(const ReflectedProperty&, ObjectBase*& InValue)
+    {
+        InValue ? ObjectCount++ : NullCount++;
+    }
+};
+
+void BenchParallelVisit()
+{
+    std::vector< SuperGuy > guys(200000);
+    for (size_t Iter = 0; Iter < guys.size(); Iter++)
+    {
+        guys[Iter].health = (int32_t)Iter;
+        guys[Iter].X = (float)Iter;
+    }
+    // one big array to get split
+    guys[7].timeStamps.resize(1000000, 3);
+
+    // no helpers, the caller runs every item
+    WorkStealingPool callerOnly(0);
+    ParallelVisitSettings callerSettings;
+    callerSettings.Pool = &callerOnly;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    auto oneWorker = ParallelVisit< ChecksumVisitor >(std::span(guys), callerSettings);
+    auto singleTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    startTime = std::chrono::high_resolution_clock::now();
+    auto allWorkers = ParallelVisit< ChecksumVisitor >(std::span(guys));
+    auto parallelTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    SPP_LOG(LOG_APP, LOG_INFO, "PARALLEL VISIT: values %zd, 1 worker %f ms, %d workers %f ms, checksums match %d",
+        allWorkers->ValueCount, singleTime, WorkStealingPool::Get().GetWorkerCount(), parallelTime, 
+        oneWorker->Checksum == allWorkers->Checksum);
+    SE_ASSERT(oneWorker->Checksum == allWorkers->Checksum);
+
+    // two visits at once on the shared pool, each waits only for its own items and gets the same result
+    std::unique_ptr< ChecksumVisitor > concurrentResults[2];
+    std::thread otherVisit([&]() { concurrentResults[1] = ParallelVisit< ChecksumVisitor >(std::span(guys)); });
+    concurrentResults[0] = ParallelVisit< ChecksumVisitor >(std::span(guys));
+    otherVisit.join();
+    SE_ASSERT(concurrentResults[0]->Checksum == oneWorker->Checksum && concurrentResults[1]->Checksum == oneWorker->Checksum);
+}
+
+uint64_t HashParticleByHand(const Particle& InParticle, uint64_t InSeed = 0)
+{
+    InSeed = HashValue(InParticle.X, InSeed);
+    InSeed = HashValue(InParticle.Y, InSeed);
+    InSeed = HashValue(InParticle.Z, InSeed);
+    InSeed = HashValue(InParticle.ID, InSeed);
+    return HashBytes(InParticle.Tag.data(), InParticle.Tag.size(), HashValue((uint64_t)InParticle.Tag.size(), InSeed));
+}
+
+void BenchStaticReflection()
+{
+    std::vector< Particle > particles(1000000);
+    for (size_t Iter = 0; Iter < particles.size(); Iter++)
+    {
+        particles[Iter].X = (float)Iter;
+        particles[Iter].ID = (int32_t)Iter;
+        particles[Iter].Tag = "spark";
+    }
+
+    auto timeHashes = [&](auto&& InHasher, uint64_t& OutHash)
+    {
+        OutHash = 0;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (auto& curParticle : particles)
+        {
+            OutHash = InHasher(curParticle, OutHash);
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    };
+
+    auto classData = get_type<Particle>().GetTypeData()->structureRef.get();
+
+    uint64_t handHash = 0, staticHash = 0, runtimeHash = 0;
+    auto handTime = timeHashes([](const Particle& InParticle, uint64_t InSeed) { return HashParticleByHand(InParticle, InSeed); }, handHash);
+    auto staticTime = timeHashes([](const Particle& InParticle, uint64_t InSeed) { return static_hash(InParticle, InSeed); }, staticHash);
+    auto runtimeTime = timeHashes([&](Particle& InParticle, uint64_t InSeed) { return classData->Hash(&InParticle, InSeed); }, runtimeHash);
+
+    SPP_LOG(LOG_APP, LOG_INFO, "STATIC BENCH (%zd): by hand %f ms, static table %f ms (same hash %d), runtime %f ms, props %zd/%zd",
+        particles.size(), handTime, staticTime, handHash == staticHash, runtimeTime, 
+        static_property_count<Particle>(), classData->GetPropertyCount());
+}
+
+// same sum, one through the virtual IVisitor and one through Visit<VisitorT>
+struct VirtualSumVisitor : public IVisitor
+{
+    double Sum = 0;
+    virtual void VisitValue(const ReflectedProperty&, float& InValue) override { Sum += InValue; }
+    virtual void VisitValue(const ReflectedProperty&, int32_t& InValue) override { Sum += InValue; }
+};
+
+struct StaticSumVisitor
+{
+    double Sum = 0;
+    void VisitValue(const ReflectedProperty&, float& InValue) { Sum += InValue; }
+    void VisitValue(const ReflectedProperty&, int32_t& InValue) { Sum += InValue; }
+};
+
+void BenchStaticVisit()
+{
+    std::vector< Particle > particles(1000000);
+    for (size_t Iter = 0; Iter < particles.size(); Iter++)
+    {
+        particles[Iter].X = (float)Iter;
+        particles[Iter].Y = 1.0f;
+        particles[Iter].ID = (int32_t)Iter;
+    }
+    auto classData = get_type<Particle>().GetTypeData()->structureRef.get();
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    double handSum = 0;
+    for (auto& curParticle : particles)
+    {
+        handSum += curParticle.X;
+        handSum += curParticle.Y;
+        handSum += curParticle.Z;
+        handSum += curParticle.ID;
+    }
+    auto handTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    startTime = std::chrono::high_resolution_clock::now();
+    VirtualSumVisitor virtualSum;
+    for (auto& curParticle : particles)
+    {
+        classData->Visit(&curParticle, &virtualSum);
+    }
+    auto virtualTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    startTime = std::chrono::high_resolution_clock::now();
+    StaticSumVisitor staticSum;
+    for (auto& curParticle : particles)
+    {
+        classData->Visit(&curParticle, staticSum);
+    }
+    auto staticTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    SPP_LOG(LOG_APP, LOG_INFO, "VISIT BENCH (%zd): by hand %f ms, virtual IVisitor %f ms, static Visit<T> %f ms, sums match %d",
+        particles.size(), handTime, virtualTime, staticTime, handSum == virtualSum.Sum && handSum == staticSum.Sum);
+
+    // nested structs, arrays and unique_ptrs through the static path
+    SuperGuy guy("static", 42);
+    guy.X = 0;
+    guy.timeStamps = { 1, 2, 3 };
+    guy.GetPlayers().push_back(std::make_unique< PlayerFighters >(PlayerFighters{ "p1", 0.5f }));
+    StaticSumVisitor guySum;
+    guy.GetCPPType().GetTypeData()->structureRef->Visit(&guy, guySum);
+    SPP_LOG(LOG_APP, LOG_INFO, "VISIT STATIC: SuperGuy sum %f", guySum.Sum);
+}
+
+// autosave style, a slice per frame with the array shrinking in between
+void TimeSlicedVisit()
+{
+    SuperGuy guy;
+    guy.timeStamps.resize(10000, 1);
+    auto classData = guy.GetCPPType().GetTypeData()->structureRef.get();
+
+    ChecksumVisitor checksum;
+    ReflectedTraversal traversal(classData, &guy, &checksum);
+
+    TraversalBudget frameBudget;
+    frameBudget.MaxNodes = 1000;
+    frameBudget.MaxMilliseconds = 1.0;
+
+    int32_t sliceCount = 0;
+    while (!traversal.Step(frameBudget))
+    {
+        sliceCount++;
+        if (sliceCount == 2)
+        {
+            guy.timeStamps.resize(2500);
+        }
+    }
+
+    SPP_LOG(LOG_APP, LOG_INFO, "TIME SLICED: slices %d nodes %zd values %zd", 
+        sliceCount + 1, traversal.GetNodesVisited(), checksum.ValueCount);
+}
+
+void WalkWorldGraph(SuperGuy& InGuy)
+{
+    // the parent is found through ObjectProperty, the fighters are owned through unique_ptr
+    SceneParent scene;
+    InGuy.parent = &scene;
+
+    ReflectedGraphWalker guyWalker;
+    guyWalker.AddRoot(&InGuy, InGuy.GetCPPType()->structureRef.get());
+
+    std::string reachedNames;
+    guyWalker.Walk([&reachedNames](std::span< const GraphNode > InBatch)
+    {
+        for (const auto& curNode : InBatch)
+        {
+            reachedNames += std::string(curNode.Struct->GetCPPType()->GetName().c_str()) + "(" + std::to_string(curNode.Depth) + ") ";
+        }
+    });
+    SPP_LOG(LOG_APP, LOG_INFO, "GRAPH: guy reaches %s", reachedNames.c_str());
+    SE_ASSERT(guyWalker.GetVisitedCount() == 2 + InGuy.GetPlayers().size());
+    SE_ASSERT(reachedNames.find("SceneParent(1)") != std::string::npos);
+    InGuy.parent = nullptr;
+
+    // a million node binary tree, every 1000th node also points back at its grandparent
+    constexpr uint32_t NodeCount = 1000000;
+    std::vector< WorldNode > world(NodeCount);
+    for (uint32_t Iter = 0; Iter < NodeCount; Iter++)
+    {
+        world[Iter].Value = (int32_t)Iter;
+        world[Iter].Left = 2 * Iter + 1 < NodeCount ? &world[2 * Iter + 1] : nullptr;
+        world[Iter].Right = 2 * Iter + 2 < NodeCount ? &world[2 * Iter + 2] : nullptr;
+        if (Iter >= 3 && Iter % 1000 == 999)
+        {
+            world[Iter].Back = &world[((Iter - 1) / 2 - 1) / 2];
+        }
+    }
+
+    GraphWalkSettings walkSettings;
+    walkSettings.bRecordEdges = true;
+    walkSettings.ReserveNodes = NodeCount;
+    ReflectedGraphWalker worldWalker(walkSettings);
+    worldWalker.AddRoot(&world[0]);
+
+    size_t batchCount = 0;
+    int64_t valueSum = 0;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    worldWalker.Walk([&](std::span< const GraphNode > InBatch)
+    {
+        batchCount++;
+        for (const auto& curNode : InBatch)
+        {
+            valueSum += ((WorldNode*)curNode.Object)->Value;
+        }
+    });
+    auto walkTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    startTime = std::chrono::high_resolution_clock::now();
+    auto foundCycles = worldWalker.FindCycles();
+    auto cycleTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    size_t largestCycle = 0;
+    for (const auto& curCycle : foundCycles)
+    {
+        largestCycle = std::max(largestCycle, curCycle.size());
+    }
+
+    SPP_LOG(LOG_APP, LOG_INFO, "GRAPH: %zd nodes (sum %lld) in %zd batches, %zd revisits, walk %f ms, %zd cycles (largest %zd) %f ms",
+        worldWalker.GetVisitedCount(), (long long)valueSum, batchCount, worldWalker.GetRevisitCount(), walkTime,
+        foundCycles.size(), largestCycle, cycleTime);
+    SE_ASSERT(worldWalker.GetVisitedCount() == NodeCount);
+    SE_ASSERT(valueSum == (int64_t)NodeCount * (NodeCount - 1) / 2);
+    // every back edge lands on a node already seen
+    SE_ASSERT(worldWalker.GetRevisitCount() == NodeCount / 1000);
+    SE_ASSERT(!foundCycles.empty() && largestCycle >= 3);
+}
+
+void CollectActors()
+{
+    ReflectedCollector collector;
+
+    // 100k actors in groups of 100 under a scene root, each targeting the one before it in its group
+    constexpr int32_t ActorCount = 100000;
+    constexpr int32_t GroupSize = 100;
+    std::vector< GCActor* > groupLeaders;
+    GCActor* lastActor = nullptr;
+    for (int32_t Iter = 0; Iter < ActorCount; Iter++)
+    {
+        auto newActor = collector.New<GCActor>();
+        newActor->Value = Iter;
+        if (Iter % GroupSize == 0)
+        {
+            groupLeaders.push_back(newActor);
+        }
+        else
+        {
+            newActor->Target = lastActor;
+            groupLeaders.back()->Children.push_back(newActor);
+        }
+        lastActor = newActor;
+    }
+
+    // the scene lives on the stack, only the leaders it holds keep actors alive
+    GCActor scene;
+    scene.Children = groupLeaders;
+    collector.AddRoot(&scene);
+
+    collector.Collect();
+    auto fullStats = collector.GetStats();
+
+    // drop every other group, with a cycle through the targets to its leader
+    for (size_t Iter = 0; Iter < scene.Children.size(); Iter += 2)
+    {
+        scene.Children[Iter]->Target = scene.Children[Iter]->Children.back();
+        scene.Children[Iter] = nullptr;
+    }
+
+    collector.Mark();
+    auto markStats = collector.GetStats();
+    size_t sweepSteps = 0;
+    while (!collector.SweepStep(8192))
+    {
+        sweepSteps++;
+    }
+    auto sweptStats = collector.GetStats();
+
+    // freed slots get reused
+    collector.New<GCActor>();
+
+    SPP_LOG(LOG_APP, LOG_INFO, "COLLECTOR: full mark %zd objects %f ms, partial mark %zd objects %f ms, freed %zd in %zd steps, live %zd in %zd blocks (%zd after reuse)",
+        fullStats.LastMarked, fullStats.LastMarkMilliseconds, markStats.LastMarked, markStats.LastMarkMilliseconds,
+        sweptStats.LastFreed, sweepSteps + 1, sweptStats.LiveObjects, sweptStats.BlockCount, collector.GetStats().BlockCount);
+    SE_ASSERT(fullStats.LastMarked == ActorCount);
+    SE_ASSERT(markStats.LastMarked == ActorCount / 2);
+    SE_ASSERT(sweptStats.LastFreed == ActorCount / 2 && sweptStats.LiveObjects == ActorCount / 2);
+    SE_ASSERT(collector.GetStats().BlockCount == sweptStats.BlockCount);
+
+    // pointers into the middle of an object find it too
+    SE_ASSERT(collector.IsManaged(&scene.Children[1]->Value) && !collector.IsManaged(&scene.Value));
+
+    // incremental, a group only reachable through a store made during the mark survives through the barrier and
+    // an actor allocated during it is born marked
+    auto movedLeader = scene.Children[1];
+    scene.Children[1] = nullptr;
+    collector.BeginMark();
+    scene.Children[3]->Target = movedLeader;
+    collector.WriteBarrier(movedLeader);
+    size_t markSteps = 0;
+    while (!collector.MarkStep(0.25))
+    {
+        if (markSteps++ == 0)
+        {
+            auto bornActor = collector.New<GCActor>();
+            movedLeader->Children.push_back(bornActor);
+            collector.WriteBarrier(bornActor);
+        }
+    }
+    while (!collector.SweepStep()) {}
+    auto incrementalStats = collector.GetStats();
+    SPP_LOG(LOG_APP, LOG_INFO, "COLLECTOR: incremental mark %zd objects in %zd steps, longest %f ms total %f ms, freed %zd",
+        incrementalStats.LastMarked, incrementalStats.LastMarkSteps, incrementalStats.LastMarkStepMilliseconds,
+        incrementalStats.LastMarkMilliseconds, incrementalStats.LastFreed);
+    SE_ASSERT(incrementalStats.LiveObjects == ActorCount / 2 + (markSteps ? 1 : 0));
+    SE_ASSERT(movedLeader->Children.size() == GroupSize - 1 + (markSteps ? 1 : 0));
+}
 
 int main()
 {
@@ -261,7 +927,7 @@ int main()
         }
     });
 
-    using guyParent = SuperGuy::parent_class;
+    static_assert(std::is_same_v< SuperGuy::parent_class, GuyTest >);
 
     // lets create the top level class and populate some data
     SuperGuy guy;
@@ -301,12 +967,17 @@ int main()
             132);
 
         auto newClass2 = classData->Invoke_Constructor<SuperGuy*>();
+        SE_ASSERT(newClass && newClass2);
 
         classData->LogOut(ptrToGuyNoTypeData);
 
         IObjectVisitor simple;
         classData->Visit(ptrToGuyNoTypeData, &simple);
 
+        ObjectCounter objectCounter;
+        classData->Visit(ptrToGuyNoTypeData, &objectCounter);
+        SPP_LOG(LOG_APP, LOG_INFO, "OBJECTS: set %d null %d", objectCounter.ObjectCount, objectCounter.NullCount);
+
         float jumpOut = 0.0f;
 
         SPP_LOG(LOG_REFLECTION, LOG_INFO, "Call invoke: previous jumpOut %f", jumpOut);
@@ -324,4 +995,542 @@ int main()
 
         SPP_LOG(LOG_REFLECTION, LOG_INFO, " - post invoke: jumpOut %f", jumpOut);
     }
-}
\ No newline at end of file
+
+    BenchClone(guy);
+    BenchParallelVisit();
+    TimeSlicedVisit();
+    WalkWorldGraph(guy);
+    CollectActors();
+    BenchStaticReflection();
+    BenchStaticVisit();
+
+    {
+        auto classData = guy.GetCPPType().GetTypeData()->structureRef.get();
+
+        std::string replicatedNames;
+        classData->IteratePropertiesWithFlags(PropertyFlags::Replicated | PropertyFlags::SaveGame, [&](ReflectedProperty* InProperty)
+        {
+            replicatedNames += std::string(InProperty->GetName().c_str()) + " ";
+        });
+        auto healthMax = classData->FindProperty("health")->GetAttribute<int32_t>("Max");
+        SPP_LOG(LOG_APP, LOG_INFO, "FLAGS: replicated+savegame %s savegame count %zd health max %d",
+            replicatedNames.c_str(), classData->GetPropertiesWithFlag(PropertyFlags::SaveGame).size(), healthMax ? *healthMax : -1);
+    }
+
+    {
+        ResetReflectionStats();
+        SetReflectionInstrumentMode(InstrumentMode::Trace);
+
+        auto classData = guy.GetCPPType().GetTypeData()->structureRef.get();
+        std::string stringREf("Test");
+        for (int32_t Iter = 0; Iter < 100; Iter++)
+        {
+            classData->Invoke<float>(&guy, std::string("DoJump"), 1.0f, stringREf);
+
+            ObjectCounter objectCounter;
+            classData->Visit(&guy, &objectCounter);
+        }
+
+        // an exited thread's records are still counted
+        std::thread([&]()
+        {
+            SuperGuy threadGuy;
+            std::string threadString("Thread");
+            for (int32_t Iter = 0; Iter < 50; Iter++)
+            {
+                classData->Invoke<float>(&threadGuy, std::string("DoJump"), 1.0f, threadString);
+            }
+        }).join();
+        uint64_t jumpCount = 0;
+        for (const auto& curStat : GetReflectionStats(EReflectionCounter::Invoke))
+        {
+            if (curStat.Name.find("DoJump") != std::string::npos)
+            {
+                jumpCount += curStat.Count;
+            }
+        }
+        SE_ASSERT(jumpCount == 150);
+        get_type_by_name("SuperGuy");
+        get_type_by_name("NotAType");
+        // no overload takes an int
+        classData->Invoke<float>(&guy, std::string("DoJump"), 1);
+
+        SetReflectionInstrumentMode(InstrumentMode::Off);
+
+        LogReflectionStats(10);
+        ExportReflectionTrace("reflection_trace.json");
+    }
+
+    {
+        auto classData = guy.GetCPPType().GetTypeData()->structureRef.get();
+
+        auto guyUsage = classData->MeasureMemory(&guy);
+        SPP_LOG(LOG_APP, LOG_INFO, "MEMORY: guy inline %zd heap %zd in %zd allocations, wasted %zd padding %zd",
+            guyUsage.InlineBytes, guyUsage.HeapBytes, guyUsage.Allocations, guyUsage.WastedCapacityBytes, guyUsage.PaddingBytes);
+
+        // over reserved arrays show up as wasted capacity
+        std::vector< SuperGuy > crowd(16);
+        for (auto& curGuy : crowd)
+        {
+            curGuy.GuyName = "a name long enough to leave the small string buffer";
+            curGuy.timeStamps.reserve(64);
+            curGuy.timeStamps.push_back(1);
+            curGuy.GetPlayers().push_back(std::make_unique<PlayerFighters>());
+        }
+        LogMemoryReport(MeasureTypeMemory(classData, std::span(crowd)));
+    }
+
+    {
+        auto unitStruct = get_type<Unit>()->structureRef.get();
+
+        // pretend profile: movement and state every frame, the name rarely, the rest never
+        LayoutAccessCounts unitAccess;
+        unitAccess[unitStruct->FindProperty("Mass")] = 1000;
+        unitAccess[unitStruct->FindProperty("Velocity")] = 1000;
+        unitAccess[unitStruct->FindProperty("bActive")] = 800;
+        unitAccess[unitStruct->FindProperty("Flags")] = 500;
+        unitAccess[unitStruct->FindProperty("Name")] = 2;
+
+        LayoutSettings layoutSettings;
+        layoutSettings.AccessCounts = &unitAccess;
+        LogLayoutReport(AnalyzeLayout(unitStruct, layoutSettings));
+        LogLayoutReport(AnalyzeLayout(guy.GetCPPType()->structureRef.get()));
+
+        ExportLayoutReport("reflection_layout.json", AnalyzeAllLayouts());
+    }
+
+    LogMetadataReport();
+
+    {
+        auto classData = guy.GetCPPType().GetTypeData()->structureRef.get();
+
+        PropertyPath tagPath(classData, "data.TAG");
+        PropertyPath playerNamePath(classData, "Players[1].name");
+        PropertyPath locationXPath(classData, "location.X");
+        PropertyPath healthPath(classData, "health");
+
+        std::string playerName;
+        float locationX = 0;
+        playerNamePath.Get(&guy, playerName);
+        locationXPath.Get(&guy, locationX);
+        tagPath.Set(&guy, std::string("PATHTAG"));
+        SPP_LOG(LOG_APP, LOG_INFO, "PATH: player %s location.X %f tag %s", playerName.c_str(), locationX, guy.data.TAG.c_str());
+
+        std::vector< SuperGuy > guys(4);
+        std::vector< int32_t > healths = { 10, 20, 30, 40 };
+        healthPath.SetArray(guys.data(), guys.size(), sizeof(SuperGuy), healths.data());
+        SPP_LOG(LOG_APP, LOG_INFO, "PATH: array health %d %d", guys[0].health, guys[3].health);
+
+        // an index that doesn't fit an int32 is rejected, not wrapped
+        PropertyPath overflowPath(classData, "Players[99999999999].name");
+        SE_ASSERT(!overflowPath.IsValid());
+    }
+
+    {
+        auto classData = guy.GetCPPType().GetTypeData()->structureRef.get();
+
+        std::vector< SuperGuy > guys(100000);
+        std::vector< int32_t > healths(guys.size());
+        for (size_t Iter = 0; Iter < guys.size(); Iter++)
+        {
+            guys[Iter].health = (int32_t)Iter;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        classData->Gather("health", guys.data(), guys.size(), healths.data());
+        auto gatherTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        for (auto& curHealth : healths)
+        {
+            curHealth += 1;
+        }
+        classData->Scatter("health", guys.data(), guys.size(), healths.data());
+
+        for (size_t Iter = 0; Iter < guys.size(); Iter += 3)
+        {
+            guys[Iter].ourGuy = EGuyType::GoodGuy;
+        }
+
+        ReflectedQuery lowHealthGood(classData, "health < 10 && ourGuy == GoodGuy");
+        auto queryMatches = lowHealthGood.Execute(std::span(guys));
+
+        QueryIndex healthIndex;
+        healthIndex.Build(classData, "health", EQueryIndex::Sorted, guys.data(), guys.size());
+        auto indexedMatches = lowHealthGood.Execute(guys.data(), guys.size(), sizeof(SuperGuy), { &healthIndex });
+
+        SPP_LOG(LOG_APP, LOG_INFO, "QUERY: matches %zd indexed matches %zd", queryMatches.size(), indexedMatches.size());
+
+        std::vector< float > locationX(guys.size());
+        classData->FindProperty("X")->Gather(std::span(guys), locationX.data());
+
+        SPP_LOG(LOG_APP, LOG_INFO, "COLUMN: gather %zd health %f ms, last health %d", guys.size(), gatherTime, guys.back().health);
+    }
+
+    {
+        // unsigned enum values past the signed range (Spectated is 200 in a uint8_t), NaN keys in a sorted index
+        auto frameData = get_type<ReplayFrame>()->structureRef.get();
+        std::vector< ReplayFrame > frames(9);
+        for (size_t Iter = 0; Iter < frames.size(); Iter++)
+        {
+            frames[Iter].Mode = (Iter % 3) ? EReplayMode::Live : EReplayMode::Spectated;
+            frames[Iter].Speed = (Iter % 4) ? (float)Iter * 5.0f : std::numeric_limits<float>::quiet_NaN();
+        }
+
+        ReflectedQuery spectatedQuery(frameData, "Mode == Spectated");
+        QueryIndex modeHashed, modeSorted;
+        modeHashed.Build(frameData, "Mode", EQueryIndex::Hashed, frames.data(), frames.size());
+        modeSorted.Build(frameData, "Mode", EQueryIndex::Sorted, frames.data(), frames.size());
+        const size_t spectatedCount = spectatedQuery.Execute(std::span(frames)).size();
+        const size_t hashedCount = spectatedQuery.Execute(frames.data(), frames.size(), sizeof(ReplayFrame), { &modeHashed }).size();
+        const size_t sortedCount = spectatedQuery.Execute(frames.data(), frames.size(), sizeof(ReplayFrame), { &modeSorted }).size();
+
+        ReflectedQuery fastQuery(frameData, "Speed >= 15");
+        QueryIndex speedSorted;
+        speedSorted.Build(frameData, "Speed", EQueryIndex::Sorted, frames.data(), frames.size());
+        const size_t fastCount = fastQuery.Execute(std::span(frames)).size();
+        const size_t fastIndexedCount = fastQuery.Execute(frames.data(), frames.size(), sizeof(ReplayFrame), { &speedSorted }).size();
+
+        SPP_LOG(LOG_APP, LOG_INFO, "QUERY: spectated %zd hashed %zd sorted %zd, fast %zd indexed %zd",
+            spectatedCount, hashedCount, sortedCount, fastCount, fastIndexedCount);
+        SE_ASSERT(spectatedCount == 3 && hashedCount == 3 && sortedCount == 3);
+        SE_ASSERT(fastCount == 4 && fastIndexedCount == 4);
+    }
+
+    {
+        ReflectedSoA< PlayerFighters > fighters;
+        fighters.push_back({ "JOJO", 12.23f });
+        fighters.push_back({ "James", 0.123f });
+        fighters.push_back({ "Jim", 50.0f });
+        fighters.swap_remove(0);
+
+        auto healthColumn = fighters.Column<float>("health");
+        SE_ASSERT(healthColumn.size() == 2 && ((uintptr_t)healthColumn.data() % alignof(float)) == 0);
+        for (auto& curHealth : healthColumn)
+        {
+            curHealth *= 2.0f;
+        }
+
+        auto backToAoS = fighters.ToVector();
+        SPP_LOG(LOG_APP, LOG_INFO, "SOA: columns %zd size %zd first %s %f", 
+            fighters.GetColumns().size(), backToAoS.size(), backToAoS[0].name.c_str(), backToAoS[0].health);
+    }
+
+    {
+        auto classData = guy.GetCPPType().GetTypeData()->structureRef.get();
+
+        SuperGuy guyCopy;
+        classData->Clone(&guy, &guyCopy);
+        SPP_LOG(LOG_APP, LOG_INFO, "HASH: %016llx copy %016llx equals %d",
+            (unsigned long long)classData->Hash(&guy),
+            (unsigned long long)classData->Hash(&guyCopy),
+            classData->Equals(&guy, &guyCopy));
+
+        guyCopy.GetPlayers()[1]->health = 1.0f;
+        SPP_LOG(LOG_APP, LOG_INFO, "HASH: %016llx changed copy %016llx equals %d",
+            (unsigned long long)classData->Hash(&guy),
+            (unsigned long long)classData->Hash(&guyCopy),
+            classData->Equals(&guy, &guyCopy));
+
+        // redo/undo pair
+        guyCopy.data.TAG = "NEWTAG";
+        guyCopy.timeStamps.push_back(6);
+        guyCopy.GetHitMe().reset();
+        // not compared, but cloned, so the patch still has to carry it
+        SceneParent otherParent;
+        guyCopy.parent = &otherParent;
+        auto redoPatch = classData->Diff(&guy, &guyCopy);
+        auto undoPatch = classData->Diff(&guyCopy, &guy);
+        redoPatch.LogOut();
+
+        classData->Apply(&guyCopy, undoPatch);
+        SPP_LOG(LOG_APP, LOG_INFO, "UNDO equals %d", classData->Equals(&guy, &guyCopy));
+        SE_ASSERT(guyCopy.parent == guy.parent);
+        classData->Apply(&guyCopy, redoPatch);
+        SE_ASSERT(guyCopy.parent == &otherParent);
+        classData->Apply(&guyCopy, undoPatch);
+        SPP_LOG(LOG_APP, LOG_INFO, "REDO/UNDO equals %d parent restored %d", classData->Equals(&guy, &guyCopy), guyCopy.parent == guy.parent);
+        SE_ASSERT(guyCopy.parent == guy.parent);
+    }
+
+    {
+        auto loadoutData = get_type<Loadout>()->structureRef.get();
+
+        float sharedScale = 2.0f;
+        Loadout loadout;
+        loadout.Owner = std::make_shared<PlayerData>();
+        loadout.Owner->TAG = "owner";
+        loadout.Champion = PlayerFighters{ "Champ", 75.0f };
+        loadout.Slot = 3;
+        loadout.Scale = &sharedScale;
+        loadout.Reserve = new PlayerFighters{ "Reserve", 20.0f };
+        loadout.Reward = std::string("gold");
+
+        // the owner is shared, the reserve copied, the scale still points at the same float
+        Loadout loadoutCopy;
+        loadoutData->Clone(&loadout, &loadoutCopy);
+        SPP_LOG(LOG_APP, LOG_INFO, "WRAP: shared owner %d own reserve %d (%s) same scale %d reward %s equals %d",
+            loadout.Owner == loadoutCopy.Owner, 
+            loadout.Reserve != loadoutCopy.Reserve, loadoutCopy.Reserve->name.c_str(),
+            loadout.Scale == loadoutCopy.Scale,
+            std::get<std::string>(loadoutCopy.Reward).c_str(),
+            loadoutData->Equals(&loadout, &loadoutCopy));
+        SE_ASSERT(loadout.Owner == loadoutCopy.Owner && loadout.Reserve != loadoutCopy.Reserve && loadout.Scale == loadoutCopy.Scale);
+        SE_ASSERT(loadoutCopy.Reserve->name == "Reserve" && std::get<std::string>(loadoutCopy.Reward) == "gold");
+        SE_ASSERT(loadoutData->Equals(&loadout, &loadoutCopy));
+
+        // another alternative and an emptied optional, patched onto a fresh clone
+        loadoutCopy.Reward = PlayerFighters{ "Prize", 1.0f };
+        loadoutCopy.Champion.reset();
+        auto loadoutPatch = loadoutData->Diff(&loadout, &loadoutCopy);
+        loadoutPatch.LogOut();
+
+        Loadout loadoutPatched;
+        loadoutData->Clone(&loadout, &loadoutPatched);
+        const bool bApplied = loadoutData->Apply(&loadoutPatched, loadoutPatch);
+        SPP_LOG(LOG_APP, LOG_INFO, "WRAP: patch applied %d equals %d reward %s, inline access unique %d shared %d optional %d",
+            bApplied, loadoutData->Equals(&loadoutPatched, &loadoutCopy),
+            std::get<PlayerFighters>(loadoutPatched.Reward).name.c_str(),
+            get_type< std::unique_ptr< PlayerFighters > >()->wrapManipulator->bDirectPointer,
+            get_type< std::shared_ptr< PlayerData > >()->wrapManipulator->bDirectPointer,
+            get_type< std::optional< PlayerFighters > >()->wrapManipulator->bDirectOptional);
+        SE_ASSERT(bApplied && loadoutData->Equals(&loadoutPatched, &loadoutCopy));
+        SE_ASSERT(!loadoutPatched.Champion && std::get<PlayerFighters>(loadoutPatched.Reward).name == "Prize");
+    }
+
+    {
+        auto inventoryData = get_type<Inventory>()->structureRef.get();
+
+        Inventory inventory;
+        inventory.Roster["Ace"] = PlayerFighters{ "Ace", 100.0f };
+        inventory.Roster["Brute"] = PlayerFighters{ "Brute", 250.0f };
+        inventory.Roster["Cleric"] = PlayerFighters{ "Cleric", 80.0f };
+        inventory.Cooldowns = { { 1, 0.5f }, { 7, 2.0f } };
+        inventory.Unlocked = { 3, 5, 8 };
+
+        // same contents inserted the other way around hash the same
+        Inventory reordered;
+        reordered.Roster.reserve(16);
+        reordered.Roster["Cleric"] = PlayerFighters{ "Cleric", 80.0f };
+        reordered.Roster["Brute"] = PlayerFighters{ "Brute", 250.0f };
+        reordered.Roster["Ace"] = PlayerFighters{ "Ace", 100.0f };
+        reordered.Cooldowns = { { 7, 2.0f }, { 1, 0.5f } };
+        reordered.Unlocked = { 8, 5, 3 };
+        SPP_LOG(LOG_APP, LOG_INFO, "MAP: reordered hash match %d equals %d",
+            inventoryData->Hash(&inventory) == inventoryData->Hash(&reordered),
+            inventoryData->Equals(&inventory, &reordered));
+        SE_ASSERT(inventoryData->Hash(&inventory) == inventoryData->Hash(&reordered));
+        SE_ASSERT(inventoryData->Equals(&inventory, &reordered));
+
+        Inventory inventoryCopy;
+        inventoryData->Clone(&inventory, &inventoryCopy);
+
+        inventoryCopy.Roster.erase("Brute");
+        inventoryCopy.Roster["Ace"].health = 60.0f;
+        inventoryCopy.Roster["Dancer"] = PlayerFighters{ "Dancer", 90.0f };
+        inventoryCopy.Cooldowns[7] = 1.5f;
+        inventoryCopy.Cooldowns[12] = 4.0f;
+        inventoryCopy.Unlocked.erase(5);
+        inventoryCopy.Unlocked.insert(13);
+
+        auto inventoryPatch = inventoryData->Diff(&inventory, &inventoryCopy);
+        inventoryPatch.LogOut();
+
+        Inventory inventoryPatched;
+        inventoryData->Clone(&inventory, &inventoryPatched);
+        const bool bApplied = inventoryData->Apply(&inventoryPatched, inventoryPatch);
+        SPP_LOG(LOG_APP, LOG_INFO, "MAP: patch applied %d equals %d roster %zd ace %f",
+            bApplied, inventoryData->Equals(&inventoryPatched, &inventoryCopy),
+            inventoryPatched.Roster.size(), inventoryPatched.Roster["Ace"].health);
+        SE_ASSERT(bApplied && inventoryData->Equals(&inventoryPatched, &inventoryCopy));
+        SE_ASSERT(inventoryPatched.Roster.size() == 3 && !inventoryPatched.Roster.count("Brute"));
+    }
+
+    {
+        // unreflected members are left alone by Equals, Hash and Clone whatever the layout
+        auto checkTally = [](auto InTally)
+        {
+            using TallyType = decltype(InTally);
+            auto tallyData = get_type<TallyType>()->structureRef.get();
+
+            TallyType tallyA, tallyB;
+            tallyA.Total = tallyB.Total = 12;
+            tallyA.Scratch = 1;
+            tallyB.Scratch = 2;
+            const bool bEqual = tallyData->Equals(&tallyA, &tallyB) && tallyData->Hash(&tallyA) == tallyData->Hash(&tallyB);
+
+            TallyType tallyCopy;
+            tallyCopy.Scratch = 3;
+            tallyData->Clone(&tallyA, &tallyCopy);
+            SPP_LOG(LOG_APP, LOG_INFO, "TALLY: %s equal %d copy total %d scratch %d", tallyData->GetCPPType()->GetName().c_str(),
+                bEqual, (int)tallyCopy.Total, (int)tallyCopy.Scratch);
+            SE_ASSERT(bEqual && tallyCopy.Total == 12 && tallyCopy.Scratch == 3);
+        };
+        checkTally(ScoreTally{});
+        checkTally(ScoreTallyPadded{});
+    }
+
+    {
+        auto netData = get_type<NetState>()->structureRef.get();
+
+        NetState netState;
+        netState.bAlive = 1;
+        netState.Team = 5;
+        netState.Lean = -3;
+        netState.Mask = 0x31;
+        netState.Seen.set(3).set(70);
+        netState.Health = 50.0f;
+
+        auto leanProp = static_cast<BitfieldProperty*>(netData->FindProperty("Lean"));
+        auto levelProp = static_cast<BitfieldProperty*>(netData->FindProperty("Level"));
+        SPP_LOG(LOG_APP, LOG_INFO, "BITS: sizeof %zd lean %lld (bits %d-%d) level %lld",
+            sizeof(NetState), (long long)leanProp->GetBits(&netState), leanProp->GetShift(), leanProp->GetShift() + leanProp->GetWidth() - 1,
+            (long long)levelProp->GetBits(&netState));
+        SE_ASSERT((int64_t)leanProp->GetBits(&netState) == -3 && levelProp->GetBits(&netState) == 3);
+
+        // bits outside the reflected ranges don't compare
+        NetState netCopy;
+        netData->Clone(&netState, &netCopy);
+        netCopy.Mask |= 0x80000000;
+        SPP_LOG(LOG_APP, LOG_INFO, "BITS: clone equals %d mask %08x hash match %d",
+            netData->Equals(&netState, &netCopy), netCopy.Mask, netData->Hash(&netState) == netData->Hash(&netCopy));
+        SE_ASSERT(netData->Equals(&netState, &netCopy) && netData->Hash(&netState) == netData->Hash(&netCopy));
+
+        // four bitfields in one word, one patch entry
+        netCopy.bAlive = 0;
+        netCopy.bCrouched = 1;
+        netCopy.Team = 2;
+        netCopy.Lean = 7;
+        netCopy.Seen.reset(70);
+        auto netPatch = netData->Diff(&netState, &netCopy);
+        netPatch.LogOut();
+
+        NetState netPatched;
+        netData->Clone(&netState, &netPatched);
+        const bool bApplied = netData->Apply(&netPatched, netPatch);
+        SPP_LOG(LOG_APP, LOG_INFO, "BITS: patch applied %d equals %d crouched %d team %d lean %d seen %d",
+            bApplied, netData->Equals(&netPatched, &netCopy), (int)netPatched.bCrouched, (int)netPatched.Team, (int)netPatched.Lean,
+            (int)netPatched.Seen.count());
+        SE_ASSERT(bApplied && netData->Equals(&netPatched, &netCopy));
+        SE_ASSERT(!netPatched.bAlive && netPatched.bCrouched && netPatched.Team == 2 && netPatched.Lean == 7 && netPatched.Seen.count() == 1);
+    }
+
+    {
+        auto frameData = get_type<ReplayFrame>()->structureRef.get();
+
+        ReplayFrame replayFrame;
+        replayFrame.FrameID = 4021;
+        replayFrame.Score = 350;
+        replayFrame.Drift = -12;
+        replayFrame.Mode = EReplayMode::Spectated;
+        replayFrame.Speed = 37.25f;
+        replayFrame.Tag = "replay";
+        replayFrame.Checkpoint = 7;
+        replayFrame.Net.bAlive = 1;
+        replayFrame.Net.Team = 3;
+        replayFrame.Net.Seen.set(42);
+        replayFrame.Items.Cooldowns = { { 1, 0.5f }, { 9, 3.0f } };
+        replayFrame.Items.Roster["Ace"] = PlayerFighters{ "Ace", 100.0f };
+        int64_t curTime = 1700000000000;
+        for (int32_t Iter = 0; Iter < 1000; Iter++)
+        {
+            curTime += 16 + (Iter % 3);
+            replayFrame.TimeStamps.push_back(curTime);
+            replayFrame.Counts.push_back(Iter % 40);
+        }
+
+        BinaryArchiveWriter plainWriter(EArchiveEncoding::Plain);
+        plainWriter.Save(replayFrame);
+        BinaryArchiveWriter compactWriter(EArchiveEncoding::Compact);
+        compactWriter.Save(replayFrame);
+
+        ReplayFrame plainLoaded, compactLoaded;
+        BinaryArchiveReader plainReader(plainWriter.GetData());
+        BinaryArchiveReader compactReader(compactWriter.GetData());
+        const bool bPlainLoaded = plainReader.Load(plainLoaded);
+        const bool bCompactLoaded = compactReader.Load(compactLoaded);
+
+        // the quantized speed is the only thing allowed to move, by at most half a step of its 10 bit range
+        constexpr float SpeedTolerance = 0.5f * 100.0f / 1023.0f + 1e-4f;
+        const float loadedSpeed = compactLoaded.Speed;
+        SE_ASSERT(std::fabs(loadedSpeed - replayFrame.Speed) <= SpeedTolerance);
+        compactLoaded.Speed = replayFrame.Speed;
+        SPP_LOG(LOG_APP, LOG_INFO, "ARCHIVE: plain %zd bytes loaded %d equals %d, compact %zd bytes loaded %d equals %d speed %f",
+            plainWriter.GetData().size(), bPlainLoaded, frameData->Equals(&replayFrame, &plainLoaded),
+            compactWriter.GetData().size(), bCompactLoaded, frameData->Equals(&replayFrame, &compactLoaded), loadedSpeed);
+        SE_ASSERT(bPlainLoaded && frameData->Equals(&replayFrame, &plainLoaded));
+        SE_ASSERT(bCompactLoaded && frameData->Equals(&replayFrame, &compactLoaded));
+        SE_ASSERT(plainLoaded.Mode == EReplayMode::Spectated && compactLoaded.Mode == EReplayMode::Spectated);
+        SE_ASSERT(compactWriter.GetData().size() < plainWriter.GetData().size());
+
+        // an undeclared enum value (Mode follows the 5 byte header, FrameID, Score and Drift) fails the load
+        auto badModeData = plainWriter.GetData();
+        badModeData[5 + sizeof(int32_t) + sizeof(uint32_t) + sizeof(int16_t)] = 7;
+        BinaryArchiveReader badModeReader(badModeData);
+        ReplayFrame badModeLoaded;
+        SE_ASSERT(!badModeReader.Load(badModeLoaded) && badModeReader.HasFailed());
+
+        // cut short, the load fails rather than reading past the end
+        BinaryArchiveReader truncatedReader(compactWriter.GetData().data(), compactWriter.GetData().size() / 2);
+        ReplayFrame truncatedLoaded;
+        const bool bTruncatedLoaded = truncatedReader.Load(truncatedLoaded);
+        SPP_LOG(LOG_APP, LOG_INFO, "ARCHIVE: truncated load %d failed %d", bTruncatedLoaded, truncatedReader.HasFailed());
+        SE_ASSERT(!bTruncatedLoaded && truncatedReader.HasFailed());
+
+        // from a file in small chunks, values get split across chunk edges
+        if (auto archiveFile = std::tmpfile())
+        {
+            std::fwrite(compactWriter.GetData().data(), 1, compactWriter.GetData().size(), archiveFile);
+            std::rewind(archiveFile);
+
+            FileArchiveSource fileSource(archiveFile, true);
+            StreamReaderSettings smallChunks;
+            smallChunks.ChunkSize = 256;
+            smallChunks.ChunkCount = 2;
+            StreamArchiveReader fileReader(fileSource, smallChunks);
+            ReplayFrame streamLoaded;
+            const bool bStreamLoaded = fileReader.Load(streamLoaded);
+            // same quantized value as the in memory compact load
+            SE_ASSERT(streamLoaded.Speed == loadedSpeed);
+            streamLoaded.Speed = replayFrame.Speed;
+            const auto fileStats = fileReader.GetStats();
+            SPP_LOG(LOG_APP, LOG_INFO, "STREAM: file loaded %d equals %d read %llu bytes in %zd chunks, buffers %zd bytes",
+                bStreamLoaded, frameData->Equals(&replayFrame, &streamLoaded), (unsigned long long)fileStats.BytesRead,
+                fileStats.ChunksRead, fileStats.BufferBytes);
+            SE_ASSERT(bStreamLoaded && frameData->Equals(&replayFrame, &streamLoaded));
+            SE_ASSERT(fileStats.BytesRead == compactWriter.GetData().size());
+        }
+
+        // from another thread through a ring, no size known up front
+        {
+            RingArchiveSource ringSource(1024);
+            std::thread producerThread([&ringSource, &plainWriter]()
+                {
+                    auto& plainData = plainWriter.GetData();
+                    for (size_t Iter = 0; Iter < plainData.size(); Iter += 100)
+                    {
+                        ringSource.Write(plainData.data() + Iter, std::min< size_t >(100, plainData.size() - Iter));
+                    }
+                    ringSource.Close();
+                });
+
+            ReplayFrame ringLoaded;
+            bool bRingLoaded = false;
+            {
+                StreamArchiveReader ringReader(ringSource);
+                bRingLoaded = ringReader.Load(ringLoaded);
+            }
+            producerThread.join();
+            SPP_LOG(LOG_APP, LOG_INFO, "STREAM: ring loaded %d equals %d", bRingLoaded, frameData->Equals(&replayFrame, &ringLoaded));
+            SE_ASSERT(bRingLoaded && frameData->Equals(&replayFrame, &ringLoaded));
+        }
+
+        // nothing ever written, destroying the reader cancels the blocked read rather than waiting on it
+        {
+            RingArchiveSource idleSource(64);
+            {
+                StreamArchiveReader idleReader(idleSource);
+            }
+            SPP_LOG(LOG_APP, LOG_INFO, "STREAM: idle reader cancelled");
+        }
+    }
+}